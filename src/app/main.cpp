@@ -6,6 +6,7 @@
 #include <QApplication>
 #include <QDebug>
 #include <QStandardItemModel>
+#include <QSet>
 #include <QCoreApplication>
 #include "mainwindow.h"
 #include "applicationNameInfo.hpp"
@@ -13,13 +14,35 @@
 #include "pathDiscovery/ResourcePaths.hpp"
 #include "pathDiscovery/PathElement.hpp"
 #include "resourceScanning/resourceScanner.hpp"
+#include "resourceInventory/inventorySnapshot.hpp"
+#include "resourceInventory/installIndex.hpp"
+
+#include <memory>
+
+// Startup budget per location before its scan continues in the background
+static constexpr int kLocationDeadlineMs = 1500;
 
 /**
  * @brief Discover and scan all resource locations
  * @param model The model to populate with discovered resources
+ * @param shared Receives the shared Machine/User inventory; must be kept
+ *               alive so sibling installations can attach to it
  * @return true on success, false on failure
+ *
+ * Installation locations are loaded from their prebuilt index (see
+ * InstallIndex) or scanned locally when it is missing or stale. Machine and User
+ * locations are shared with the sibling installation (LTS <-> Nightly):
+ * if a sibling already published a fresh snapshot of them it is reused,
+ * otherwise they are scanned and published for the next sibling. Freshness
+ * is checked with InventorySnapshot::directoryStamp(), which lists only the
+ * resource folders, so it stays cheap ahead of the deadline scan.
+ *
+ * A location that takes longer than kLocationDeadlineMs to scan (e.g. a
+ * Documents folder redirected to a network share) is shown as pending
+ * and merged into the model when its background scan finishes.
  */
-bool resourceManager(QStandardItemModel* model) {
+bool resourceManager(QStandardItemModel* model,
+                     std::unique_ptr<resourceInventory::SharedInventory>& shared) {
     try {
         qDebug() << "Discovering resource locations...";
         
@@ -35,9 +58,63 @@ bool resourceManager(QStandardItemModel* model) {
         
         qDebug() << "Found" << allLocations.size() << "resource locations";
         
-        // Scan and populate model
-        resourceInventory::ResourceScanner scanner;
-        scanner.scanToModel(model, allLocations);
+        QList<platformInfo::ResourceLocation> installLocations;
+        QList<platformInfo::ResourceLocation> sharedLocations;
+        for (const auto& loc : allLocations) {
+            if (loc.tier() == resourceMetadata::ResourceTier::Installation) {
+                installLocations.append(loc);
+            } else {
+                sharedLocations.append(loc);
+            }
+        }
+        
+        // Owned by the model: it outlives startup to finish slow locations
+        auto* scanner = new resourceInventory::ResourceScanner(model);
+        scanner->setDefaultLocationDeadline(kLocationDeadlineMs);
+        
+        // Installation tier: prebuilt index when current, otherwise scan
+        QList<platformInfo::ResourceLocation> unindexed;
+        for (const auto& loc : installLocations) {
+            QList<resourceInventory::ResourceItem> indexed;
+            if (resourceInventory::InstallIndex::load(loc, indexed)) {
+                scanner->addItemsToModel(model, indexed);
+            } else {
+                unindexed.append(loc);
+            }
+        }
+        scanner->scanToModel(model, unindexed);
+        
+        shared = std::make_unique<resourceInventory::SharedInventory>(sharedLocations);
+        QList<resourceInventory::ResourceItem> sharedItems;
+        QStringList pending;
+        if (!shared->load(sharedItems)) {
+            sharedItems.clear();
+            pending = scanner->scanLocationsWithDeadline(sharedLocations,
+                [&sharedItems](const resourceInventory::ResourceItem& item) {
+                    sharedItems.append(item);
+                });
+            if (pending.isEmpty()) {
+                shared->publish(sharedItems);
+            } else {
+                // Publish only a complete snapshot, once the slow shared locations
+                // are in; pending installation locations do not hold it back
+                auto published = std::make_shared<QList<resourceInventory::ResourceItem>>(sharedItems);
+                auto remaining = std::make_shared<QSet<QString>>(pending.cbegin(), pending.cend());
+                resourceInventory::SharedInventory* target = shared.get();
+                QObject::connect(scanner, &resourceInventory::ResourceScanner::locationScanFinished, scanner,
+                    [published, remaining, target](const QString& path, const QList<resourceInventory::ResourceItem>& items) {
+                        if (!remaining->remove(path)) {
+                            return;
+                        }
+                        *published += items;
+                        if (remaining->isEmpty()) {
+                            target->publish(*published);
+                        }
+                    });
+            }
+        }
+        scanner->addItemsToModel(model, sharedItems);
+        scanner->addPendingToModel(model, pending);
         
         qDebug() << "Model populated with" << model->rowCount() << "items";
         
@@ -62,7 +139,8 @@ int main(int argc, char *argv[]) {
     
     qDebug() << "Building resource inventory...";
     QStandardItemModel* inventory = new QStandardItemModel();
-    if (!resourceManager(inventory)) {
+    std::unique_ptr<resourceInventory::SharedInventory> sharedInventory;
+    if (!resourceManager(inventory, sharedInventory)) {
         qCritical() << "Failed to build resource inventory - exiting";
         return 1;
     }
@@ -9,8 +9,12 @@
 #include <scadtemplates/template_manager.hpp>
 #include <platformInfo/resourceLocationManager.hpp>
 #include <platformInfo/ResourceLocation.hpp>
+#include <resourceScanning/parsedTemplateCache.hpp>
 #include <resourceScanning/resourceScanner.hpp>
 #include <resourceInventory/resourceItem.hpp>
+#include <resourceInventory/templatePack.hpp>
+#include <pathDiscovery/ResourcePaths.hpp>
+#include <pathDiscovery/PathElement.hpp>
 
 #include <QMenuBar>
 #include <QMenu>
@@ -33,6 +37,7 @@
 #include <QCoreApplication>
 #include <QFontDatabase>
 #include <QStandardPaths>
+#include <QDir>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -41,6 +46,52 @@
 #include <QStandardItemModel>
 #include <QTreeView>
 #include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QHash>
+#include <QDebug>
+
+namespace {
+
+// Contents of a non-JSON template, shown as plain text
+QString readTextFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+// Time a refresh waits for each location before finishing it in the
+// background, as at startup
+constexpr int kRefreshDeadlineMs = 1500;
+
+// Location key of the rows of templates loaded with "Load Templates..."
+const QString kLoadedLocationKey = QStringLiteral("loaded-file");
+
+bool isLoadedTemplate(const resourceInventory::ResourceItem& item) {
+    static const resourceInventory::StringPool::Id loadedKey =
+        resourceInventory::StringPool::instance().intern(kLoadedLocationKey);
+    return item.locationKeyId() == loadedKey;
+}
+
+// Inventory row of a loaded template; the manager holds its body
+resourceInventory::ResourceItem loadedTemplateItem(const ResourceTemplate& tmpl) {
+    resourceInventory::ResourceItem item;
+    item.setPath(tmpl.path() + QLatin1Char('#') + tmpl.prefix());
+    item.setType(resourceInventory::ResourceType::Templates);
+    item.setTier(resourceInventory::ResourceTier::User);
+    item.setName(tmpl.prefix());
+    item.setDisplayName(tmpl.name().isEmpty() ? tmpl.prefix() : tmpl.name());
+    item.setDescription(tmpl.description());
+    item.setCategory(tmpl.category());
+    item.setSourcePath(tmpl.path());
+    item.setSourceLocationKey(kLoadedLocationKey);
+    item.setAccess(resourceInventory::ResourceAccess::ReadOnly);
+    item.setExists(true);
+    return item;
+}
+
+} // namespace
 
 MainWindow::MainWindow(QStandardItemModel* inventory, QWidget *parent)
     : QMainWindow(parent)
@@ -48,10 +99,21 @@ MainWindow::MainWindow(QStandardItemModel* inventory, QWidget *parent)
     , m_resourceManager(std::make_unique<platformInfo::ResourceLocationManager>())
     , m_settings(std::make_unique<QSettings>(QStringLiteral("OpenSCAD"), QStringLiteral("ScadTemplates")))
     , m_inventory(inventory)
+    , m_scanner(new resourceInventory::ResourceScanner(this))
+    , m_rescanTimer(new QTimer(this))
 {
     // Set application path for resource manager
     m_resourceManager->setApplicationPath(QCoreApplication::applicationDirPath());
     
+    // Coalesce bursts of file watcher notifications into one rescan
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(500);
+    connect(m_rescanTimer, &QTimer::timeout, this, [this]() { refreshInventory(false); });
+    connect(m_scanner, &resourceInventory::ResourceScanner::resourcesChanged,
+            m_rescanTimer, qOverload<>(&QTimer::start));
+    m_scanner->setDefaultLocationDeadline(kRefreshDeadlineMs);
+    m_scanner->setWatchEnabled(true);
+    
     setupUi();
     setupMenus();
     
@@ -270,8 +332,10 @@ void MainWindow::setupMenus() {
             tr("Open Templates File"), QString(),
             tr("JSON Files (*.json);;All Files (*)"));
         if (!fileName.isEmpty()) {
-            if (m_templateManager->loadFromFile(fileName)) {
-                refreshInventory();
+            if (syncLoadedTemplates(fileName).success) {
+                if (!m_loadedTemplateFiles.contains(fileName)) {
+                    m_loadedTemplateFiles.append(fileName);
+                }
                 statusBar()->showMessage(tr("Loaded templates from %1").arg(fileName));
             } else {
                 QMessageBox::warning(this, tr("Error"), 
@@ -295,6 +359,11 @@ void MainWindow::setupMenus() {
         }
     });
     
+    templatesMenu->addSeparator();
+    QAction* refreshAction = templatesMenu->addAction(tr("&Refresh Inventory"));
+    refreshAction->setShortcut(QKeySequence::Refresh);
+    connect(refreshAction, &QAction::triggered, this, [this]() { refreshInventory(); });
+    
     // Help menu
     QMenu* helpMenu = menuBar()->addMenu(tr("&Help"));
     
@@ -469,31 +538,159 @@ void MainWindow::onInventorySelectionChanged() {
     onInventoryItemSelected(resItem);
 }
 
-void MainWindow::refreshInventory() {
-    // Clear and rescan the model
-    m_inventory->clear();
-    
-    // TODO: Implement actual discovery when ResourceLocationManager is complete
+void MainWindow::refreshInventory(bool fullRescan) {
+    pathDiscovery::ResourcePaths pathDiscovery;
     QList<platformInfo::ResourceLocation> allLocations;
+    for (const auto& pathElem : pathDiscovery.qualifiedSearchPaths()) {
+        allLocations.append(platformInfo::ResourceLocation(pathElem.path(), pathElem.tier()));
+    }
+    
+    // Watcher-triggered refreshes list only folders that changed since the
+    // last refresh; explicit ones relist everything (catches in-place edits)
+    const auto mode = fullRescan ? resourceInventory::DirectoryStampTree::UpdateMode::Full
+                                 : resourceInventory::DirectoryStampTree::UpdateMode::Incremental;
+    // Each location is applied as soon as it is rescanned; one that misses
+    // the deadline keeps its rows until its rescan finishes in the background
+    const QStringList pending = m_scanner->rescanLocationsWithDeadline(allLocations, mode,
+        [this](const platformInfo::ResourceLocation& location,
+               const QList<resourceInventory::ResourceItem>& rescanned) {
+            applyLocationRescan(location, rescanned);
+        });
+    
+    for (const QString& filePath : std::as_const(m_loadedTemplateFiles)) {
+        const scadtemplates::ReloadResult result = syncLoadedTemplates(filePath);
+        if (!result.success) {
+            qWarning() << "MainWindow: Cannot reload" << filePath << "-" << result.errorMessage;
+        }
+    }
+    
+    if (pending.isEmpty()) {
+        statusBar()->showMessage(tr("Inventory refreshed: %1 templates").arg(m_inventory->rowCount()), 3000);
+    } else {
+        statusBar()->showMessage(tr("Inventory refreshed: %1 templates, %2 locations still refreshing")
+                                     .arg(m_inventory->rowCount()).arg(pending.size()), 3000);
+    }
+}
+
+void MainWindow::applyLocationRescan(const platformInfo::ResourceLocation& location,
+                                     const QList<resourceInventory::ResourceItem>& rescanned) {
+    using resourceInventory::ResourceItem;
+    using resourceInventory::ResourceScanner;
+    const QString root = QDir::cleanPath(location.path());
+    
+    // Placeholder of the location if it was still scanning at startup
+    for (int row = m_inventory->rowCount() - 1; row >= 0; --row) {
+        const QStandardItem* item = m_inventory->item(row);
+        if (item->data(ResourceScanner::PendingRole).toBool()
+            && item->data(ResourceScanner::PathRole).toString() == root) {
+            m_inventory->removeRow(row);
+        }
+    }
     
-    resourceInventory::ResourceScanner scanner;
-    scanner.scanToModel(m_inventory, allLocations);
+    // Update only the rows of this location that changed, keeping
+    // selection and scroll state
+    const QString prefix = root + QLatin1Char('/');
+    const auto locationKey = resourceInventory::StringPool::instance().intern(location.getDisplayName());
+    QList<ResourceItem> current = ResourceScanner::itemsInModel(m_inventory);
+    current.removeIf([&prefix, locationKey](const ResourceItem& item) {
+        return item.locationKeyId() != locationKey || !item.path().startsWith(prefix);
+    });
+    QList<ResourceItem> items = rescanned;
+    resourceInventory::ScanDiff::sortForDiff(current);
+    resourceInventory::ScanDiff::sortForDiff(items);
+    const auto changes = resourceInventory::ScanDiff::diff(current, items);
+    m_scanner->applyChangesToModel(m_inventory, current, items, changes);
+}
+
+scadtemplates::ReloadResult MainWindow::syncLoadedTemplates(const QString& filePath) {
+    using resourceInventory::ResourceItem;
+    using resourceInventory::ScanDiff;
     
-    statusBar()->showMessage(tr("Inventory refreshed: %1 templates").arg(m_inventory->rowCount()), 3000);
+    // Only entries whose bytes changed are decoded
+    const scadtemplates::ReloadResult result = m_templateManager->reloadFromFile(filePath);
+    
+    // Rows of loaded templates by prefix, the manager's key (a prefix may
+    // have moved here from another loaded file)
+    QHash<QString, ResourceItem> shown;
+    const QList<ResourceItem> rows = resourceInventory::ResourceScanner::itemsInModel(m_inventory);
+    for (const ResourceItem& item : rows) {
+        if (isLoadedTemplate(item)) {
+            shown.insert(item.name(), item);
+        }
+    }
+    
+    // Changes for the touched prefixes only; other rows, and the
+    // selection, are left alone
+    QList<ResourceItem> before;
+    QList<ResourceItem> after;
+    QList<ScanDiff::Change> changes;
+    for (const QString& prefix : result.removed) {
+        const auto it = shown.constFind(prefix);
+        if (it != shown.constEnd()) {
+            before.append(*it);
+            changes.append({ScanDiff::Change::Removed, int(before.size() - 1), -1});
+        }
+    }
+    const QStringList touched = result.added + result.changed;
+    for (const QString& prefix : touched) {
+        const std::optional<ResourceTemplate> tmpl = m_templateManager->findByPrefix(prefix);
+        if (!tmpl) {
+            continue;
+        }
+        after.append(loadedTemplateItem(*tmpl));
+        const auto it = shown.constFind(prefix);
+        if (it != shown.constEnd()) {
+            before.append(*it);
+            changes.append({ScanDiff::Change::Modified, int(before.size() - 1), int(after.size() - 1)});
+        } else {
+            changes.append({ScanDiff::Change::Added, -1, int(after.size() - 1)});
+        }
+    }
+    m_scanner->applyChangesToModel(m_inventory, before, after, changes);
+    
+    // The selected template changed on disk: show its new contents
+    if (!m_editMode && isLoadedTemplate(m_selectedItem) && touched.contains(m_selectedItem.name())) {
+        if (const auto tmpl = m_templateManager->findByPrefix(m_selectedItem.name())) {
+            m_selectedItem = loadedTemplateItem(*tmpl);
+            populateEditorFromSelection(m_selectedItem);
+        }
+    }
+    return result;
 }
 
 void MainWindow::populateEditorFromSelection(const resourceInventory::ResourceItem& item) {
     m_prefixEdit->setText(item.name());
 
-    // Prefer structured parse via TemplateParser/JSON to extract body/description/source
-    QFile file(item.path());
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        const QByteArray data = file.readAll();
-        file.close();
+    // Template loaded from a file: held by the template manager
+    if (isLoadedTemplate(item)) {
+        const std::optional<ResourceTemplate> tmpl = m_templateManager->findByPrefix(item.name());
+        m_bodyEdit->setPlainText(tmpl ? tmpl->body() : QString());
+        m_descriptionEdit->setText(tmpl ? tmpl->description() : item.description());
+        m_sourceEdit->setText(tmpl && !tmpl->source().isEmpty() ? tmpl->source() : item.sourcePath());
+        updateTemplateButtons();
+        return;
+    }
+
+    // Entry of a compiled template pack: read in place from the mapped pack
+    QString packPath;
+    QString packPrefix;
+    if (resourceInventory::TemplatePack::splitEntryPath(item.path(), packPath, packPrefix)) {
+        resourceInventory::TemplatePack pack;
+        const int index = pack.open(packPath) ? pack.find(packPrefix) : -1;
+        m_prefixEdit->setText(packPrefix);
+        m_bodyEdit->setPlainText(index >= 0 ? pack.body(index) : QString());
+        m_descriptionEdit->setText(index >= 0 ? pack.description(index) : item.description());
+        m_sourceEdit->setText(item.sourceLocationKey());
+        updateTemplateButtons();
+        return;
+    }
 
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-        if (parseError.error == QJsonParseError::NoError && doc.isObject()) {
+    // Prefer structured parse via TemplateParser/JSON to extract body/description/source.
+    // The document is shared with the scanner and tree through the parse cache
+    const auto parsed = resourceInventory::ParsedTemplateCache::instance().get(item.path());
+    if (parsed->read) {
+        if (parsed->ok() && parsed->document.isObject()) {
+            const QJsonDocument& doc = parsed->document;
             QJsonObject root = doc.object();
 
             // Legacy format: { "key": "...", "content": "..." }
@@ -547,14 +744,14 @@ void MainWindow::populateEditorFromSelection(const resourceInventory::ResourceIt
                     m_sourceEdit->setText(sourceTag);
                 } else {
                     // Fallback: treat as plain text
-                    m_bodyEdit->setPlainText(QString::fromUtf8(data));
+                    m_bodyEdit->setPlainText(readTextFile(item.path()));
                     m_descriptionEdit->setText(item.description());
                     m_sourceEdit->setText(item.sourceLocationKey());
                 }
             }
         } else {
             // Non-JSON: treat as plain text template
-            m_bodyEdit->setPlainText(QString::fromUtf8(data));
+            m_bodyEdit->setPlainText(readTextFile(item.path()));
             m_descriptionEdit->setText(item.description());
             m_sourceEdit->setText(item.sourceLocationKey());
         }
@@ -584,11 +781,17 @@ void MainWindow::applyFilterToTree(const QString& text) {
 void MainWindow::updateTemplateButtons() {
     bool hasSelection = !m_selectedItem.path().isEmpty();
     bool isEditing = m_editMode;
+    // Pack entries live inside the compiled pack and loaded templates in
+    // the template manager; both can only be copied
+    QString packPath;
+    QString packPrefix;
+    const bool readOnly = resourceInventory::TemplatePack::splitEntryPath(m_selectedItem.path(), packPath, packPrefix)
+                          || isLoadedTemplate(m_selectedItem);
     
     m_newBtn->setEnabled(!isEditing);
-    m_deleteBtn->setEnabled(!isEditing && hasSelection);
+    m_deleteBtn->setEnabled(!isEditing && hasSelection && !readOnly);
     m_copyBtn->setEnabled(!isEditing && hasSelection);
-    m_editBtn->setEnabled(!isEditing && hasSelection);
+    m_editBtn->setEnabled(!isEditing && hasSelection && !readOnly);
     m_saveBtn->setEnabled(isEditing);
     m_cancelBtn->setEnabled(isEditing);
     
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <QMainWindow>
+#include <QStringList>
 #include <resourceInventory/resourceItem.hpp>
 #include <memory>
 
@@ -17,20 +18,24 @@ class QPushButton;
 class QVBoxLayout;
 class QStandardItemModel;
 class QTreeView;
+class QTimer;
 
 namespace scadtemplates {
 class TemplateManager;
+struct ReloadResult;
 }
 
 using resourceInventory::ResourceTemplate;
 
 namespace platformInfo {
+class ResourceLocation;
 class ResourceLocationManager;
 }
 
 namespace resourceInventory {
 class ResourceTreeWidget;
 class ResourceItem;
+class ResourceScanner;
 }
 
 /**
@@ -73,16 +78,22 @@ private:
     void setupMenus();
     void updateWindowTitle();
     void updateTemplateButtons();
-    void refreshInventory();
+    void refreshInventory(bool fullRescan = true);  // false: changed folders only
+    void applyLocationRescan(const platformInfo::ResourceLocation& location,
+                             const QList<resourceInventory::ResourceItem>& rescanned);
     void populateEditorFromSelection(const resourceInventory::ResourceItem& item);
+    scadtemplates::ReloadResult syncLoadedTemplates(const QString& filePath);
     QString userTemplatesRoot() const;
     bool saveTemplateToUser(const ResourceTemplate& tmpl);
     void applyFilterToTree(const QString& text);
     
     std::unique_ptr<scadtemplates::TemplateManager> m_templateManager;
+    QStringList m_loadedTemplateFiles;  // Reloaded on every refresh
     std::unique_ptr<platformInfo::ResourceLocationManager> m_resourceManager;
     std::unique_ptr<QSettings> m_settings;
     QStandardItemModel* m_inventory;  // Owned by QApplication
+    resourceInventory::ResourceScanner* m_scanner;  // Keeps stamps for incremental refresh
+    QTimer* m_rescanTimer;
     
     // Template panel
     QVBoxLayout* m_inventoryLayout;
@@ -0,0 +1,233 @@
+#include "JsonBackend.hpp"
+#include "JsonReader.hpp"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+#include <nlohmann/json.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Set by CMake from the JSON_BACKEND cache variable
+#ifndef JSON_BACKEND_NAME
+#define JSON_BACKEND_NAME "qt"
+#endif
+
+namespace {
+
+// Numbers without a fraction that a double holds exactly, kept as integers
+// the way QJsonDocument::fromJson does
+bool isIntegral(double number)
+{
+  constexpr double kMaxExact = 9007199254740992.0;  // 2^53
+  return std::floor(number) == number && std::abs(number) <= kMaxExact;
+}
+
+QJsonValue numberValue(double number)
+{
+  return isIntegral(number) ? QJsonValue(qint64(number)) : QJsonValue(number);
+}
+
+// Assembles a QJsonDocument from parse events. Each container is filled
+// while open and inserted into its parent when it closes.
+class DocumentBuilder {
+public:
+  void beginObject() { m_stack.push_back(Frame{true, {}, {}, {}}); }
+  void beginArray() { m_stack.push_back(Frame{false, {}, {}, {}}); }
+  void key(QString name) { m_stack.back().key = std::move(name); }
+
+  void value(const QJsonValue& value)
+  {
+    if (m_stack.empty()) {
+      m_scalarRoot = true;
+      return;
+    }
+    Frame& frame = m_stack.back();
+    if (frame.isObject) {
+      frame.object.insert(frame.key, value);
+    } else {
+      frame.array.append(value);
+    }
+  }
+
+  void end()
+  {
+    Frame frame = std::move(m_stack.back());
+    m_stack.pop_back();
+    if (!m_stack.empty()) {
+      value(frame.isObject ? QJsonValue(frame.object) : QJsonValue(frame.array));
+    } else if (frame.isObject) {
+      m_doc = QJsonDocument(frame.object);
+    } else {
+      m_doc = QJsonDocument(frame.array);
+    }
+  }
+
+  // Hand over the document; QJsonDocument holds only objects and arrays
+  bool finish(QJsonDocument& doc, JsonErrorInfo& error)
+  {
+    if (m_scalarRoot || m_doc.isNull()) {
+      error.message = "Expected an object or array";
+      error.offset = 0;
+      return false;
+    }
+    doc = std::move(m_doc);
+    return true;
+  }
+
+private:
+  struct Frame {
+    bool isObject;
+    QJsonObject object;
+    QJsonArray array;
+    QString key;
+  };
+
+  std::vector<Frame> m_stack;
+  QJsonDocument m_doc;
+  bool m_scalarRoot = false;
+};
+
+// ----------------------------------------------------------------------------
+// Qt
+
+class QtJsonBackend final : public JsonBackend {
+public:
+  const char* name() const override { return "qt"; }
+
+  bool parse(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error) const override
+  {
+    QJsonParseError parseError;
+    doc = QJsonDocument::fromJson(content, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+      error.message = parseError.errorString().toStdString();
+      error.offset = parseError.offset;
+      return false;
+    }
+    return true;
+  }
+};
+
+// ----------------------------------------------------------------------------
+// nlohmann
+
+class QtValueSax final : public nlohmann::json_sax<nlohmann::json> {
+public:
+  explicit QtValueSax(JsonErrorInfo& error) : m_error(error) {}
+
+  DocumentBuilder builder;
+
+  bool null() override { builder.value(QJsonValue(QJsonValue::Null)); return true; }
+  bool boolean(bool val) override { builder.value(QJsonValue(val)); return true; }
+  bool number_integer(number_integer_t val) override { builder.value(QJsonValue(qint64(val))); return true; }
+  bool number_unsigned(number_unsigned_t val) override
+  {
+    builder.value(val <= number_unsigned_t(INT64_MAX) ? QJsonValue(qint64(val)) : QJsonValue(double(val)));
+    return true;
+  }
+  bool number_float(number_float_t val, const string_t&) override { builder.value(QJsonValue(val)); return true; }
+  bool string(string_t& val) override
+  {
+    builder.value(QJsonValue(QString::fromUtf8(val.data(), qsizetype(val.size()))));
+    return true;
+  }
+  bool binary(binary_t&) override { return false; }  // Not produced by the JSON input format
+  bool start_object(std::size_t) override { builder.beginObject(); return true; }
+  bool key(string_t& val) override
+  {
+    builder.key(QString::fromUtf8(val.data(), qsizetype(val.size())));
+    return true;
+  }
+  bool end_object() override { builder.end(); return true; }
+  bool start_array(std::size_t) override { builder.beginArray(); return true; }
+  bool end_array() override { builder.end(); return true; }
+
+  bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override
+  {
+    m_error.message = ex.what();
+    m_error.offset = position > 0 ? int(position - 1) : 0;
+    return false;
+  }
+
+private:
+  JsonErrorInfo& m_error;
+};
+
+class NlohmannJsonBackend final : public JsonBackend {
+public:
+  const char* name() const override { return "nlohmann"; }
+
+  bool parse(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error) const override
+  {
+    QtValueSax sax(error);
+    const char* begin = content.constData();
+    if (!nlohmann::json::sax_parse(begin, begin + content.size(), &sax)) return false;
+    return sax.builder.finish(doc, error);
+  }
+};
+
+// ----------------------------------------------------------------------------
+// JsonEventReader
+
+class EventJsonBackend final : public JsonBackend {
+public:
+  const char* name() const override { return "event"; }
+
+  bool parse(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error) const override
+  {
+    using Token = JsonEventReader::Token;
+    JsonEventReader reader(content);
+    DocumentBuilder builder;
+    for (;;) {
+      switch (reader.next()) {
+        case Token::BeginObject: builder.beginObject(); break;
+        case Token::BeginArray: builder.beginArray(); break;
+        case Token::EndObject:
+        case Token::EndArray: builder.end(); break;
+        case Token::Key: builder.key(reader.text()); break;
+        case Token::String: builder.value(QJsonValue(reader.text())); break;
+        case Token::Number: builder.value(numberValue(reader.number())); break;
+        case Token::Bool: builder.value(QJsonValue(reader.boolean())); break;
+        case Token::Null: builder.value(QJsonValue(QJsonValue::Null)); break;
+        case Token::End: return builder.finish(doc, error);
+        case Token::None:
+        case Token::Error:
+          error.message = reader.error().message;
+          error.offset = reader.error().offset;
+          return false;
+      }
+    }
+  }
+};
+
+const QtJsonBackend qtBackend{};
+const NlohmannJsonBackend nlohmannBackend{};
+const EventJsonBackend eventBackend{};
+
+} // namespace
+
+const JsonBackend& JsonBackend::active()
+{
+  static const JsonBackend* const backend = [] {
+    const JsonBackend* selected = find(JSON_BACKEND_NAME);
+    return selected ? selected : static_cast<const JsonBackend*>(&qtBackend);
+  }();
+  return *backend;
+}
+
+std::vector<const JsonBackend*> JsonBackend::all()
+{
+  return {&qtBackend, &nlohmannBackend, &eventBackend};
+}
+
+const JsonBackend* JsonBackend::find(std::string_view name)
+{
+  for (const JsonBackend* backend : all()) {
+    if (name == backend->name()) return backend;
+  }
+  return nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <string_view>
+#include <vector>
+
+struct JsonErrorInfo;
+
+// Parser behind JsonReader. Every implementation produces QJsonDocument,
+// so callers do not change with the backend; what differs is how the bytes
+// are turned into the document. Writing does not go through a backend:
+// documents are written with the streaming JsonWriter.
+//
+//   "qt"        QJsonDocument::fromJson
+//   "nlohmann"  nlohmann::json SAX parser building the Qt values directly
+//   "event"     JsonEventReader from this library
+//
+// The backend used by JsonReader is chosen at build time with the CMake
+// cache variable JSON_BACKEND (default "qt"); json-backend-bench measures
+// all of them on a template corpus to make that choice.
+class JsonBackend {
+public:
+  virtual ~JsonBackend() = default;
+
+  virtual const char* name() const = 0;
+
+  // Parse `content`; on failure sets error.message and error.offset (the
+  // caller locates line and column)
+  virtual bool parse(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error) const = 0;
+
+  // Backend selected at build time
+  static const JsonBackend& active();
+
+  // Every compiled-in backend, and lookup by name (nullptr if unknown)
+  static std::vector<const JsonBackend*> all();
+  static const JsonBackend* find(std::string_view name);
+};
@@ -1,6 +1,347 @@
 #include "JsonReader.hpp"
+#include "JsonBackend.hpp"
 
 #include <QFile>
+#include <QByteArrayView>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// Cursor over raw JSON bytes used by readMembers(). Values that are not
+// requested are skipped structurally (strings, brackets) without decoding.
+class MemberScanner {
+public:
+  MemberScanner(const char* begin, const char* end) : m_begin(begin), m_pos(begin), m_end(end) {}
+
+  int offset() const { return int(m_pos - m_begin); }
+  bool atEnd() const { return m_pos >= m_end; }
+  const char* pos() const { return m_pos; }
+
+  void skipBom()
+  {
+    if (m_end - m_pos >= 3 && m_pos[0] == '\xEF' && m_pos[1] == '\xBB' && m_pos[2] == '\xBF') {
+      m_pos += 3;
+    }
+  }
+
+  void skipWhitespace()
+  {
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+      ++m_pos;
+    }
+  }
+
+  bool consume(char c)
+  {
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == c) {
+      ++m_pos;
+      return true;
+    }
+    return false;
+  }
+
+  bool peek(char c) const { return m_pos < m_end && *m_pos == c; }
+
+  // Reads a string token; [start, stop) are its contents without quotes
+  bool readString(const char*& start, const char*& stop, bool& escaped)
+  {
+    if (!peek('"')) return false;
+    escaped = false;
+    start = ++m_pos;
+    while (m_pos < m_end) {
+      const char c = *m_pos;
+      if (c == '"') {
+        stop = m_pos++;
+        return true;
+      }
+      if (c == '\\') {
+        escaped = true;
+        ++m_pos;
+      }
+      ++m_pos;
+    }
+    return false;
+  }
+
+  bool skipValue()
+  {
+    skipWhitespace();
+    if (atEnd()) return false;
+
+    const char* start = nullptr;
+    const char* stop = nullptr;
+    bool escaped = false;
+    const char c = *m_pos;
+    if (c == '"') {
+      return readString(start, stop, escaped);
+    }
+    if (c == '{' || c == '[') {
+      // Bracket matching only; the contents are validated on a full read
+      int depth = 0;
+      while (m_pos < m_end) {
+        const char d = *m_pos;
+        if (d == '"') {
+          if (!readString(start, stop, escaped)) return false;
+          continue;
+        }
+        if (d == '{' || d == '[') {
+          ++depth;
+        } else if (d == '}' || d == ']') {
+          if (--depth == 0) {
+            ++m_pos;
+            return true;
+          }
+        }
+        ++m_pos;
+      }
+      return false;
+    }
+
+    // Number or literal
+    const char* begin = m_pos;
+    while (m_pos < m_end && (std::isalnum(static_cast<unsigned char>(*m_pos)) || *m_pos == '-' ||
+                             *m_pos == '+' || *m_pos == '.')) {
+      ++m_pos;
+    }
+    return m_pos > begin;
+  }
+
+private:
+  const char* m_begin;
+  const char* m_pos;
+  const char* m_end;
+};
+
+int hexValue(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Decode the contents of a JSON string token
+bool decodeString(const char* start, const char* stop, bool escaped, QString& out)
+{
+  if (!escaped) {
+    out = QString::fromUtf8(start, int(stop - start));
+    return true;
+  }
+
+  out.clear();
+  out.reserve(int(stop - start));
+  const char* run = start;
+  for (const char* p = start; p < stop; ++p) {
+    if (*p != '\\') continue;
+    out += QString::fromUtf8(run, int(p - run));
+    if (++p >= stop) return false;
+    switch (*p) {
+      case '"': out += QLatin1Char('"'); break;
+      case '\\': out += QLatin1Char('\\'); break;
+      case '/': out += QLatin1Char('/'); break;
+      case 'b': out += QLatin1Char('\b'); break;
+      case 'f': out += QLatin1Char('\f'); break;
+      case 'n': out += QLatin1Char('\n'); break;
+      case 'r': out += QLatin1Char('\r'); break;
+      case 't': out += QLatin1Char('\t'); break;
+      case 'u': {
+        if (stop - p < 5) return false;
+        int code = 0;
+        for (int i = 1; i <= 4; ++i) {
+          const int v = hexValue(p[i]);
+          if (v < 0) return false;
+          code = code * 16 + v;
+        }
+        // Surrogate pairs arrive as two escapes and combine in UTF-16
+        out += QChar(char16_t(code));
+        p += 4;
+        break;
+      }
+      default:
+        return false;
+    }
+    run = p + 1;
+  }
+  out += QString::fromUtf8(run, int(stop - run));
+  return true;
+}
+
+// Offset of the name token of top-level member `key`, or -1
+int findMemberOffset(const QByteArray& content, const QString& key)
+{
+  const QByteArray wanted = key.toUtf8();
+  MemberScanner scanner(content.constData(), content.constData() + content.size());
+  scanner.skipBom();
+  if (!scanner.consume('{')) return -1;
+
+  while (true) {
+    scanner.skipWhitespace();
+    const int offset = scanner.offset();
+    const char* start = nullptr;
+    const char* stop = nullptr;
+    bool escaped = false;
+    if (!scanner.readString(start, stop, escaped)) return -1;
+
+    QString decoded;
+    if (escaped) {
+      if (!decodeString(start, stop, true, decoded)) return -1;
+      if (decoded == key) return offset;
+    } else if (QByteArrayView(start, stop - start) == QByteArrayView(wanted)) {
+      return offset;
+    }
+
+    if (!scanner.consume(':') || !scanner.skipValue()) return -1;
+    if (!scanner.consume(',')) return -1;
+  }
+}
+
+// Offset of the value a JSON pointer refers to, or -1
+int findPointerOffset(const QByteArray& content, const QString& pointer)
+{
+  MemberScanner scanner(content.constData(), content.constData() + content.size());
+  scanner.skipBom();
+  scanner.skipWhitespace();
+  if (pointer.isEmpty()) return scanner.offset();
+  if (!pointer.startsWith(QLatin1Char('/'))) return -1;
+
+  const QStringList tokens = pointer.mid(1).split(QLatin1Char('/'));
+  for (QString token : tokens) {
+    token.replace(QLatin1String("~1"), QLatin1String("/")).replace(QLatin1String("~0"), QLatin1String("~"));
+
+    if (scanner.consume('{')) {
+      bool found = false;
+      while (!found) {
+        scanner.skipWhitespace();
+        const char* start = nullptr;
+        const char* stop = nullptr;
+        bool escaped = false;
+        QString key;
+        if (!scanner.readString(start, stop, escaped) || !decodeString(start, stop, escaped, key)) return -1;
+        if (!scanner.consume(':')) return -1;
+        if (key == token) {
+          found = true;
+        } else if (!scanner.skipValue() || !scanner.consume(',')) {
+          return -1;
+        }
+      }
+    } else if (scanner.consume('[')) {
+      bool isIndex = false;
+      const int index = token.toInt(&isIndex);
+      if (!isIndex || index < 0) return -1;
+      for (int i = 0; i < index; ++i) {
+        if (!scanner.skipValue() || !scanner.consume(',')) return -1;
+      }
+    } else {
+      return -1;
+    }
+    scanner.skipWhitespace();
+  }
+  return scanner.offset();
+}
+
+// Read buffers shared by bulk reads. Buffers keep their capacity between
+// files, so after warm-up a read is a single read() into memory sized to
+// the largest recent file; buffers far above that size are dropped.
+class BufferPool {
+public:
+  QByteArray acquire()
+  {
+    QMutexLocker lock(&m_mutex);
+    if (m_free.empty()) {
+      QByteArray buffer;
+      buffer.reserve(m_recentLargest);
+      return buffer;
+    }
+    QByteArray buffer = std::move(m_free.back());
+    m_free.pop_back();
+    return buffer;
+  }
+
+  void release(QByteArray buffer, qint64 bytesRead)
+  {
+    QMutexLocker lock(&m_mutex);
+    // Decaying maximum, so one huge file does not pin memory forever
+    m_recentLargest = std::max(bytesRead, m_recentLargest - m_recentLargest / 8);
+    if (buffer.capacity() > 2 * m_recentLargest || m_free.size() >= kMaxFree) return;
+    m_free.push_back(std::move(buffer));
+  }
+
+private:
+  static constexpr size_t kMaxFree = 64;
+
+  QMutex m_mutex;
+  std::vector<QByteArray> m_free;
+  qint64 m_recentLargest = 4096;
+};
+
+BufferPool& bufferPool()
+{
+  static BufferPool pool;
+  return pool;
+}
+
+// Runs work(i) for every i in [0, count) on up to maxConcurrency pool
+// threads and deliver(i) on the calling thread in index order, each as soon
+// as item i and all earlier ones are done. Workers stay at most a fixed
+// window ahead of delivery, which bounds the results held at once.
+void runOrdered(size_t count, int maxConcurrency, const std::function<void(size_t)>& work,
+                const std::function<void(size_t)>& deliver)
+{
+  if (count == 0) return;
+  const int workers = int(std::min<size_t>(
+    size_t(std::max(1, maxConcurrency > 0 ? maxConcurrency : QThread::idealThreadCount())), count));
+  const size_t window = size_t(workers) * 4;
+
+  QMutex mutex;
+  QWaitCondition itemDone;
+  QWaitCondition deliveryAdvanced;
+  std::vector<char> done(count, 0);
+  size_t delivered = 0;
+  std::atomic<size_t> next{0};
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(workers);
+  for (int w = 0; w < workers; ++w) {
+    pool.start([&]() {
+      for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        {
+          QMutexLocker lock(&mutex);
+          while (i >= delivered + window) deliveryAdvanced.wait(&mutex);
+        }
+        work(i);
+        QMutexLocker lock(&mutex);
+        done[i] = 1;
+        itemDone.wakeAll();
+      }
+    });
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    {
+      QMutexLocker lock(&mutex);
+      while (!done[i]) itemDone.wait(&mutex);
+    }
+    if (deliver) deliver(i);
+    QMutexLocker lock(&mutex);
+    delivered = i + 1;
+    deliveryAdvanced.wakeAll();
+  }
+  pool.waitForDone();
+}
+
+} // namespace
 
 std::string JsonErrorInfo::formatError() const
 {
@@ -21,52 +362,439 @@ std::string JsonErrorInfo::formatError() const
   return result;
 }
 
-void JsonReader::offsetToLineColumn(const QByteArray& content, int offset, int& line, int& column)
+// ============================================================================
+// JsonLineIndex
+// ============================================================================
+
+JsonLineIndex::JsonLineIndex(const QByteArray& content)
 {
-  line = 1;
-  column = 1;
-  for (int i = 0; i < offset && i < content.size(); ++i) {
-    if (content[i] == '\n') {
-      ++line;
-      column = 1;
-    } else {
-      ++column;
+  m_lineStarts.push_back(0);
+  const char* const begin = content.constData();
+  const char* const end = begin + content.size();
+  for (const char* p = begin; p < end;) {
+    const auto* nl = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+    if (!nl) break;
+    m_lineStarts.push_back(int(nl - begin) + 1);
+    p = nl + 1;
+  }
+}
+
+void JsonLineIndex::locate(int offset, int& line, int& column) const
+{
+  if (m_lineStarts.empty()) {
+    line = 1;
+    column = offset + 1;
+    return;
+  }
+  // Last line start <= offset
+  const auto it = std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), offset);
+  const auto index = std::distance(m_lineStarts.begin(), it) - 1;
+  line = int(index) + 1;
+  column = offset - m_lineStarts[size_t(index)] + 1;
+}
+
+// ============================================================================
+// JsonDiagnostics
+// ============================================================================
+
+JsonDiagnostics::JsonDiagnostics(const std::string& filename, const QByteArray& content,
+                                 std::vector<JsonErrorInfo>& out)
+  : m_filename(filename), m_content(content), m_out(out)
+{
+}
+
+void JsonDiagnostics::add(const std::string& message, int offset)
+{
+  JsonErrorInfo info;
+  info.filename = m_filename;
+  info.message = message;
+  if (offset >= 0 && !m_content.isEmpty()) {
+    if (!m_indexed) {
+      m_index = JsonLineIndex(m_content);
+      m_indexed = true;
     }
+    info.offset = offset;
+    m_index.locate(offset, info.line, info.column);
   }
+  m_out.push_back(std::move(info));
 }
 
-bool JsonReader::readFile(const fs::path& path, QJsonDocument& doc, JsonErrorInfo& error)
+int JsonDiagnostics::memberOffset(const QString& key) const
 {
-  return readFile(path.generic_string(), doc, error);
+  return findMemberOffset(m_content, key);
 }
 
-bool JsonReader::readFile(const std::string& path, QJsonDocument& doc, JsonErrorInfo& error)
+int JsonDiagnostics::pointerOffset(const QString& pointer) const
+{
+  return findPointerOffset(m_content, pointer);
+}
+
+// ============================================================================
+// JsonFileContent
+// ============================================================================
+
+namespace {
+// Below this size a read is cheaper than setting up a mapping
+std::atomic<qint64> s_mapThreshold{64 * 1024};
+} // namespace
+
+qint64 JsonReader::mapThreshold()
+{
+  return s_mapThreshold.load(std::memory_order_relaxed);
+}
+
+void JsonReader::setMapThreshold(qint64 bytes)
+{
+  s_mapThreshold.store(bytes, std::memory_order_relaxed);
+}
+
+JsonFileContent::~JsonFileContent()
+{
+  m_data.clear();  // Drop the raw reference before the mapping goes away
+  if (m_mapped) m_file.unmap(m_mapped);
+}
+
+std::shared_ptr<const JsonFileContent> JsonFileContent::open(const std::string& path, JsonErrorInfo& error,
+                                                             Access access)
 {
   error.clear();
   error.filename = path;
 
-  QFile file(QString::fromStdString(path));
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+  std::shared_ptr<JsonFileContent> content(new JsonFileContent);
+  content->m_file.setFileName(QString::fromStdString(path));
+  // Binary mode: JSON treats CR as whitespace, so no text translation is needed
+  if (!content->m_file.open(QIODevice::ReadOnly)) {
     error.message = "Cannot open file for reading";
-    return false;
+    return nullptr;
+  }
+
+  const qint64 size = content->m_file.size();
+  if (access == Access::MapLarge && size > 0 && size >= JsonReader::mapThreshold()
+      && size <= qint64(INT_MAX)) {
+    content->m_mapped = content->m_file.map(0, size);
+  }
+  if (content->m_mapped) {
+    content->m_data = QByteArray::fromRawData(reinterpret_cast<const char*>(content->m_mapped), int(size));
+  } else {
+    content->m_data = content->m_file.readAll();
+    content->m_file.close();
+  }
+  return content;
+}
+
+// ============================================================================
+// JsonEventReader
+// ============================================================================
+
+JsonEventReader::JsonEventReader(const QByteArray& content)
+  : m_content(content)
+  , m_begin(m_content.constData())
+  , m_pos(m_begin)
+  , m_end(m_begin + m_content.size())
+  , m_tokenStart(m_begin)
+{
+  if (m_end - m_pos >= 3 && m_pos[0] == '\xEF' && m_pos[1] == '\xBB' && m_pos[2] == '\xBF') {
+    m_pos += 3;
+  }
+}
+
+void JsonEventReader::skipWhitespace()
+{
+  while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+    ++m_pos;
+  }
+}
+
+JsonEventReader::Token JsonEventReader::fail(const char* message)
+{
+  m_error.message = message;
+  m_error.offset = int(m_pos - m_begin);
+  JsonLineIndex(m_content).locate(m_error.offset, m_error.line, m_error.column);
+  return m_token = Token::Error;
+}
+
+JsonEventReader::Token JsonEventReader::next()
+{
+  if (m_token == Token::End || m_token == Token::Error) return m_token;
+
+  skipWhitespace();
+  m_tokenStart = m_pos;
+  switch (m_expect) {
+    case Expect::Value:
+      return readValue();
+    case Expect::FirstKey:
+      if (m_pos < m_end && *m_pos == '}') break;
+      return readKey();
+    case Expect::FirstValue:
+      if (m_pos < m_end && *m_pos == ']') break;
+      return readValue();
+    case Expect::Separator:
+      if (m_stack.empty()) {
+        if (m_pos != m_end) return fail("Unexpected data after the document");
+        return m_token = Token::End;
+      }
+      if (m_pos < m_end && *m_pos == ',') {
+        ++m_pos;
+        skipWhitespace();
+        m_tokenStart = m_pos;
+        return m_stack.back() == '{' ? readKey() : readValue();
+      }
+      break;
+  }
+
+  // Only the end of the open container may follow
+  const char close = m_stack.back() == '{' ? '}' : ']';
+  if (m_pos >= m_end || *m_pos != close) {
+    if (m_expect == Expect::Separator) {
+      return fail(close == '}' ? "Expected ',' or '}'" : "Expected ',' or ']'");
+    }
+    return fail(close == '}' ? "Expected a member name or '}'" : "Expected a value or ']'");
+  }
+  ++m_pos;
+  m_stack.pop_back();
+  m_expect = Expect::Separator;
+  return m_token = close == '}' ? Token::EndObject : Token::EndArray;
+}
+
+JsonEventReader::Token JsonEventReader::readKey()
+{
+  if (m_pos >= m_end || *m_pos != '"') return fail("Expected a member name");
+  if (readString(Token::Key) == Token::Error) return m_token;
+  skipWhitespace();
+  if (m_pos >= m_end || *m_pos != ':') return fail("Expected ':'");
+  ++m_pos;
+  m_expect = Expect::Value;
+  return m_token = Token::Key;
+}
+
+JsonEventReader::Token JsonEventReader::readValue()
+{
+  if (m_pos >= m_end) return fail("Unexpected end of data");
+
+  const char c = *m_pos;
+  if (c == '{' || c == '[') {
+    ++m_pos;
+    m_stack.push_back(c);
+    m_expect = c == '{' ? Expect::FirstKey : Expect::FirstValue;
+    return m_token = c == '{' ? Token::BeginObject : Token::BeginArray;
   }
 
-  QByteArray content = file.readAll();
-  file.close();
+  m_expect = Expect::Separator;
+  if (c == '"') return readString(Token::String);
+
+  const auto literal = [&](QByteArrayView word, Token token) {
+    if (m_end - m_pos < word.size() || QByteArrayView(m_pos, word.size()) != word) {
+      return fail("Invalid literal");
+    }
+    m_pos += word.size();
+    return m_token = token;
+  };
+  if (c == 't') return literal("true", Token::Bool);
+  if (c == 'f') return literal("false", Token::Bool);
+  if (c == 'n') return literal("null", Token::Null);
+
+  if (c == '-' || (c >= '0' && c <= '9')) return readNumber();
+  return fail("Unexpected character");
+}
+
+JsonEventReader::Token JsonEventReader::readString(Token token)
+{
+  // Escapes are checked here, so text() always decodes
+  m_escaped = false;
+  m_stringStart = ++m_pos;
+  while (m_pos < m_end) {
+    const unsigned char c = static_cast<unsigned char>(*m_pos);
+    if (c == '"') {
+      m_stringStop = m_pos++;
+      return m_token = token;
+    }
+    if (c < 0x20) return fail("Control character in string");
+    if (c == '\\') {
+      m_escaped = true;
+      if (++m_pos >= m_end) break;
+      switch (*m_pos) {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+          break;
+        case 'u':
+          for (int i = 0; i < 4; ++i) {
+            if (++m_pos >= m_end || hexValue(*m_pos) < 0) return fail("Invalid \\u escape");
+          }
+          break;
+        default:
+          return fail("Invalid escape sequence");
+      }
+    }
+    ++m_pos;
+  }
+  return fail("Unterminated string");
+}
 
-  QJsonParseError parseError;
-  doc = QJsonDocument::fromJson(content, &parseError);
+JsonEventReader::Token JsonEventReader::readNumber()
+{
+  // -? (0 | [1-9][0-9]*) (.[0-9]+)? ([eE][+-]?[0-9]+)?
+  const auto digits = [this] {
+    const char* start = m_pos;
+    while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') ++m_pos;
+    return m_pos > start;
+  };
+  if (*m_pos == '-') ++m_pos;
+  if (m_pos < m_end && *m_pos == '0') {
+    ++m_pos;
+  } else if (!digits()) {
+    return fail("Invalid number");
+  }
+  if (m_pos < m_end && *m_pos == '.') {
+    ++m_pos;
+    if (!digits()) return fail("Invalid number");
+  }
+  if (m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+    ++m_pos;
+    if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) ++m_pos;
+    if (!digits()) return fail("Invalid number");
+  }
+  return m_token = Token::Number;
+}
 
-  if (parseError.error != QJsonParseError::NoError) {
-    error.message = parseError.errorString().toStdString();
-    error.offset = parseError.offset;
-    offsetToLineColumn(content, parseError.offset, error.line, error.column);
+QString JsonEventReader::text() const
+{
+  QString out;
+  if (m_token == Token::Key || m_token == Token::String) {
+    decodeString(m_stringStart, m_stringStop, m_escaped, out);
+  }
+  return out;
+}
+
+bool JsonEventReader::textEquals(QByteArrayView utf8) const
+{
+  if (m_token != Token::Key && m_token != Token::String) return false;
+  if (!m_escaped) return QByteArrayView(m_stringStart, m_stringStop - m_stringStart) == utf8;
+  return text() == QString::fromUtf8(utf8);
+}
+
+double JsonEventReader::number() const
+{
+  if (m_token != Token::Number) return 0.0;
+  return QByteArray(m_tokenStart, int(m_pos - m_tokenStart)).toDouble();
+}
+
+bool JsonEventReader::skipValue()
+{
+  switch (next()) {
+    case Token::BeginObject:
+    case Token::BeginArray:
+      return skipRest();
+    case Token::String:
+    case Token::Number:
+    case Token::Bool:
+    case Token::Null:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool JsonEventReader::skipRest()
+{
+  // Tokens are still checked; strings are not decoded
+  const int target = depth() - 1;
+  while (depth() > target) {
+    const Token token = next();
+    if (token == Token::Error || token == Token::End) return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// JsonReader
+// ============================================================================
+
+void JsonReader::offsetToLineColumn(const QByteArray& content, int offset, int& line, int& column)
+{
+  // Single lookup: count newlines up to offset without building an index
+  const char* const begin = content.constData();
+  const char* const end = begin + std::clamp(offset, 0, int(content.size()));
+  const char* lineStart = begin;
+  line = 1;
+  for (const char* p = begin; p < end;) {
+    const auto* nl = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+    if (!nl) break;
+    ++line;
+    lineStart = p = nl + 1;
+  }
+  column = int(end - lineStart) + 1;
+}
+
+bool JsonReader::readFile(const fs::path& path, QJsonDocument& doc, JsonErrorInfo& error)
+{
+  return readFile(path.generic_string(), doc, error);
+}
+
+bool JsonReader::readFile(const std::string& path, QJsonDocument& doc, JsonErrorInfo& error)
+{
+  const auto file = JsonFileContent::open(path, error);
+  if (!file) return false;
+  return parseContent(file->data(), doc, error);
+}
+
+bool JsonReader::parseContent(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error)
+{
+  if (!JsonBackend::active().parse(content, doc, error)) {
+    offsetToLineColumn(content, error.offset, error.line, error.column);
     return false;
   }
 
   return true;
 }
 
+void JsonReader::readPooled(const std::string& path, JsonReadResult& result)
+{
+  result.error.clear();
+  result.error.filename = path;
+
+  QFile file(QString::fromStdString(path));
+  if (!file.open(QIODevice::ReadOnly)) {
+    result.error.message = "Cannot open file for reading";
+    return;
+  }
+  const qint64 size = file.size();
+  if (size >= mapThreshold() || size > qint64(INT_MAX)) {
+    file.close();
+    readFile(path, result.doc, result.error);
+    return;
+  }
+
+  // QJsonDocument copies what it keeps, so the buffer is free after parsing
+  QByteArray buffer = bufferPool().acquire();
+  buffer.resize(int(size));
+  const qint64 bytesRead = size > 0 ? file.read(buffer.data(), size) : 0;
+  if (bytesRead < 0) {
+    result.error.message = "Cannot read file";
+  } else {
+    buffer.resize(int(bytesRead));
+    parseContent(buffer, result.doc, result.error);
+  }
+  bufferPool().release(std::move(buffer), std::max<qint64>(bytesRead, 0));
+}
+
+std::vector<JsonReadResult> JsonReader::readMany(const std::vector<std::string>& paths, int maxConcurrency)
+{
+  std::vector<JsonReadResult> results(paths.size());
+  runOrdered(paths.size(), maxConcurrency, [&](size_t i) { readPooled(paths[i], results[i]); }, {});
+  return results;
+}
+
+void JsonReader::readMany(const std::vector<std::string>& paths, const JsonReadCallback& onResult,
+                          int maxConcurrency)
+{
+  std::vector<JsonReadResult> results(paths.size());
+  runOrdered(paths.size(), maxConcurrency,
+             [&](size_t i) { readPooled(paths[i], results[i]); },
+             [&](size_t i) {
+               onResult(i, results[i]);
+               results[i] = JsonReadResult();  // Release the document
+             });
+}
+
 bool JsonReader::readObject(const fs::path& path, QJsonObject& obj, JsonErrorInfo& error)
 {
   return readObject(path.generic_string(), obj, error);
@@ -94,3 +822,149 @@ bool JsonReader::readArray(const std::string& path, QJsonArray& arr, JsonErrorIn
   arr = doc.array();
   return true;
 }
+
+bool JsonReader::readMembers(const QByteArray& content, const QStringList& keys,
+                             QJsonObject& members, JsonErrorInfo& error)
+{
+  error.clear();
+
+  // Raw UTF-8 of the keys: unescaped member names compare without decoding
+  std::vector<QByteArray> wanted;
+  wanted.reserve(keys.size());
+  for (const QString& key : keys) wanted.push_back(key.toUtf8());
+  std::vector<bool> found(wanted.size(), false);
+  size_t remaining = wanted.size();
+
+  MemberScanner scanner(content.constData(), content.constData() + content.size());
+  auto fail = [&](const char* message) {
+    error.message = message;
+    error.offset = scanner.offset();
+    offsetToLineColumn(content, error.offset, error.line, error.column);
+    return false;
+  };
+
+  scanner.skipBom();
+  if (!scanner.consume('{')) return fail("JSON root must be an object");
+  if (scanner.consume('}')) return true;
+
+  while (true) {
+    scanner.skipWhitespace();
+    const char* keyStart = nullptr;
+    const char* keyStop = nullptr;
+    bool keyEscaped = false;
+    if (!scanner.readString(keyStart, keyStop, keyEscaped)) return fail("Expected member name");
+    if (!scanner.consume(':')) return fail("Expected ':' after member name");
+
+    // Which requested key (if any) this member is
+    int match = -1;
+    QString decodedKey;
+    if (keyEscaped && !decodeString(keyStart, keyStop, true, decodedKey)) {
+      return fail("Invalid escape in member name");
+    }
+    const QByteArrayView rawKey(keyStart, keyStop - keyStart);
+    for (size_t i = 0; i < wanted.size() && match < 0; ++i) {
+      if (found[i]) continue;
+      if (keyEscaped ? decodedKey == keys[int(i)] : rawKey == wanted[i]) match = int(i);
+    }
+
+    scanner.skipWhitespace();
+    if (match < 0) {
+      if (!scanner.skipValue()) return fail("Invalid value");
+    } else if (scanner.peek('"')) {
+      const char* start = nullptr;
+      const char* stop = nullptr;
+      bool escaped = false;
+      QString value;
+      if (!scanner.readString(start, stop, escaped) || !decodeString(start, stop, escaped, value)) {
+        return fail("Invalid string value");
+      }
+      members.insert(keys[match], value);
+    } else {
+      // Non-string values are rare for the keys asked for; parse just the slice
+      const char* start = scanner.pos();
+      if (!scanner.skipValue()) return fail("Invalid value");
+      QByteArray wrapped;
+      wrapped.reserve(int(scanner.pos() - start) + 2);
+      wrapped.append('[').append(start, int(scanner.pos() - start)).append(']');
+      QJsonParseError parseError;
+      const QJsonDocument doc = QJsonDocument::fromJson(wrapped, &parseError);
+      if (parseError.error != QJsonParseError::NoError || !doc.isArray()) return fail("Invalid value");
+      members.insert(keys[match], doc.array().at(0));
+    }
+
+    if (match >= 0) {
+      found[size_t(match)] = true;
+      if (--remaining == 0) return true;  // Rest of the document is not needed
+    }
+
+    if (scanner.consume(',')) continue;
+    if (scanner.consume('}')) return true;
+    return fail("Expected ',' or '}' after member");
+  }
+}
+
+bool JsonReader::readMembers(const fs::path& path, const QStringList& keys,
+                             QJsonObject& members, JsonErrorInfo& error)
+{
+  return readMembers(path.generic_string(), keys, members, error);
+}
+
+bool JsonReader::readMembers(const std::string& path, const QStringList& keys,
+                             QJsonObject& members, JsonErrorInfo& error)
+{
+  const auto file = JsonFileContent::open(path, error);
+  if (!file) return false;
+
+  const bool ok = readMembers(file->data(), keys, members, error);
+  error.filename = path;
+  return ok;
+}
+
+JsonValidationResult JsonReader::validate(const std::string& path, const JsonChecker& checker)
+{
+  return validateContent(path, [&checker](JsonDiagnostics& diagnostics) {
+    QJsonDocument doc;
+    JsonErrorInfo parseError;
+    if (!JsonBackend::active().parse(diagnostics.content(), doc, parseError)) {
+      diagnostics.add(parseError.message, parseError.offset);
+      return;
+    }
+    if (checker) checker(doc, diagnostics);
+  });
+}
+
+std::vector<JsonValidationResult> JsonReader::validateMany(const std::vector<std::string>& paths,
+                                                           const JsonChecker& checker,
+                                                           int maxConcurrency)
+{
+  std::vector<JsonValidationResult> results(paths.size());
+  runOrdered(paths.size(), maxConcurrency, [&](size_t i) { results[i] = validate(paths[i], checker); }, {});
+  return results;
+}
+
+JsonValidationResult JsonReader::validateContent(const std::string& path, const JsonContentChecker& checker)
+{
+  JsonValidationResult result;
+  result.filename = path;
+
+  JsonErrorInfo error;
+  const auto file = JsonFileContent::open(path, error);
+  if (!file) {
+    result.diagnostics.push_back(std::move(error));
+    return result;
+  }
+
+  JsonDiagnostics diagnostics(path, file->data(), result.diagnostics);
+  checker(diagnostics);
+  return result;
+}
+
+std::vector<JsonValidationResult> JsonReader::validateContentMany(const std::vector<std::string>& paths,
+                                                                  const JsonContentChecker& checker,
+                                                                  int maxConcurrency)
+{
+  std::vector<JsonValidationResult> results(paths.size());
+  runOrdered(paths.size(), maxConcurrency,
+             [&](size_t i) { results[i] = validateContent(paths[i], checker); }, {});
+  return results;
+}
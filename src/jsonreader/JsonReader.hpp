@@ -1,13 +1,18 @@
 #pragma once
 
+#include <QByteArrayView>
 #include <QString>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonParseError>
+#include <QStringList>
 #include <QFile>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -34,8 +39,192 @@ struct JsonErrorInfo {
   [[nodiscard]] std::string formatError() const;
 };
 
+// Byte offsets of the line starts of a buffer, found with memchr in one
+// pass. Any number of diagnostics are then located with a binary search
+// each instead of rescanning the buffer per error.
+class JsonLineIndex {
+public:
+  JsonLineIndex() = default;
+  explicit JsonLineIndex(const QByteArray& content);
+
+  // 1-based line and byte column of `offset`
+  void locate(int offset, int& line, int& column) const;
+  int lineCount() const { return int(m_lineStarts.size()); }
+
+private:
+  std::vector<int> m_lineStarts;
+};
+
+// Collects the diagnostics of one document. The line index is built on the
+// first diagnostic that carries an offset, so clean files never pay for it.
+class JsonDiagnostics {
+public:
+  JsonDiagnostics(const std::string& filename, const QByteArray& content,
+                  std::vector<JsonErrorInfo>& out);
+
+  // Record a diagnostic; offset -1 means no location
+  void add(const std::string& message, int offset = -1);
+
+  // Offset of top-level member `key` (its name token), or -1. Lets schema
+  // checks point at the offending member without a parser with positions.
+  int memberOffset(const QString& key) const;
+
+  // Offset of the value a JSON pointer (RFC 6901, e.g. "/body/2") refers
+  // to, or -1. Used to locate errors reported against a pointer.
+  int pointerOffset(const QString& pointer) const;
+
+  const std::string& filename() const { return m_filename; }
+  const QByteArray& content() const { return m_content; }
+
+private:
+  std::string m_filename;
+  const QByteArray& m_content;
+  std::vector<JsonErrorInfo>& m_out;
+  JsonLineIndex m_index;
+  bool m_indexed = false;
+};
+
+// All diagnostics of one file: JSON syntax and any checker findings
+struct JsonValidationResult {
+  std::string filename;
+  std::vector<JsonErrorInfo> diagnostics;
+
+  [[nodiscard]] bool ok() const { return diagnostics.empty(); }
+};
+
+// Schema/content check run on a syntactically valid document
+using JsonChecker = std::function<void(const QJsonDocument& doc, JsonDiagnostics& diagnostics)>;
+
+// Check that parses diagnostics.content() itself, e.g. into another DOM;
+// it also reports syntax errors
+using JsonContentChecker = std::function<void(JsonDiagnostics& diagnostics)>;
+
+// One file of a bulk read
+struct JsonReadResult {
+  QJsonDocument doc;
+  JsonErrorInfo error;
+
+  [[nodiscard]] bool ok() const { return !error.hasError(); }
+};
+
+// Receives bulk read results in input order, on the calling thread
+using JsonReadCallback = std::function<void(size_t index, JsonReadResult& result)>;
+
+// Contents of a file to be parsed, read in one go by default. data()
+// stays valid as long as the object lives.
+//
+// A mapped file that is truncated while mapped faults (SIGBUS) on the next
+// access to the lost pages, so mapping is opt-in for files nobody edits in
+// place, such as installation-tier resources: with Access::MapLarge, files
+// of at least JsonReader::mapThreshold() bytes are mapped and data()
+// refers to the mapping without a copy. User files are always read.
+// Nothing keeps a file's content alive past parsing; lazy fields are
+// loaded again through the template caches.
+class JsonFileContent {
+public:
+  enum class Access { Read, MapLarge };
+
+  ~JsonFileContent();
+  JsonFileContent(const JsonFileContent&) = delete;
+  JsonFileContent& operator=(const JsonFileContent&) = delete;
+
+  static std::shared_ptr<const JsonFileContent> open(const std::string& path, JsonErrorInfo& error,
+                                                     Access access = Access::Read);
+
+  const QByteArray& data() const { return m_data; }
+  bool isMapped() const { return m_mapped != nullptr; }
+
+private:
+  JsonFileContent() = default;
+
+  QFile m_file;
+  uchar* m_mapped = nullptr;
+  QByteArray m_data;  // fromRawData() over the mapping, or the file contents
+};
+
+// Pull parser over raw JSON bytes: one token per next() call, without a
+// document. For large files processed entry by entry (snippet collections
+// with tens of thousands of members), so memory use is bounded by the
+// file's bytes plus what the caller keeps. The syntax is
+// checked as tokens are read, number grammar and string escapes included;
+// strings are decoded only when asked for.
+//
+//   JsonEventReader reader(content);
+//   if (reader.next() != JsonEventReader::Token::BeginObject) ...
+//   while (reader.next() == JsonEventReader::Token::Key) {
+//     const QString name = reader.text();
+//     reader.skipValue();
+//   }
+class JsonEventReader {
+public:
+  enum class Token {
+    None,  // Before the first next()
+    BeginObject, EndObject, BeginArray, EndArray,
+    Key, String, Number, Bool, Null,
+    End,   // Document complete
+    Error  // Syntax error, see error(); sticky
+  };
+
+  explicit JsonEventReader(const QByteArray& content);
+
+  Token next();
+  Token token() const { return m_token; }
+
+  // Decoded text of the current Key or String token
+  QString text() const;
+  // Current Key or String token equals `utf8`; no decoding unless escaped
+  bool textEquals(QByteArrayView utf8) const;
+  // Value of the current Number or Bool token
+  double number() const;
+  bool boolean() const { return m_token == Token::Bool && *m_tokenStart == 't'; }
+
+  // Skip the next value, containers included (e.g. after a Key)
+  bool skipValue();
+  // Skip the rest of the container whose Begin token was read last
+  bool skipRest();
+
+  // Containers open after the current token
+  int depth() const { return int(m_stack.size()); }
+  // Byte offset of the current token, and just past it: after an End
+  // token, [offset of the Begin token, endOffset()) is the whole container
+  int offset() const { return int(m_tokenStart - m_begin); }
+  int endOffset() const { return int(m_pos - m_begin); }
+
+  bool hasError() const { return m_token == Token::Error; }
+  // Located with line and column
+  const JsonErrorInfo& error() const { return m_error; }
+
+private:
+  enum class Expect { Value, FirstKey, FirstValue, Separator };
+
+  Token readKey();
+  Token readValue();
+  Token readString(Token token);
+  Token readNumber();
+  Token fail(const char* message);
+  void skipWhitespace();
+
+  QByteArray m_content;  // Shared; mapped bytes must outlive the reader
+  const char* m_begin;
+  const char* m_pos;
+  const char* m_end;
+  const char* m_tokenStart;
+  const char* m_stringStart = nullptr;  // Contents of the current string token
+  const char* m_stringStop = nullptr;
+  bool m_escaped = false;
+  std::vector<char> m_stack;  // '{' or '[' per open container
+  Expect m_expect = Expect::Value;
+  Token m_token = Token::None;
+  JsonErrorInfo m_error;
+};
+
 class JsonReader {
 public:
+  // Files at least this large are memory-mapped instead of copied, where
+  // mapping is allowed (JsonFileContent::Access::MapLarge)
+  static qint64 mapThreshold();
+  static void setMapThreshold(qint64 bytes);
+
   static bool readFile(const fs::path& path, QJsonDocument& doc, JsonErrorInfo& error);
   static bool readFile(const std::string& path, QJsonDocument& doc, JsonErrorInfo& error);
 
@@ -45,6 +234,55 @@ public:
   static bool readArray(const fs::path& path, QJsonArray& arr, JsonErrorInfo& error);
   static bool readArray(const std::string& path, QJsonArray& arr, JsonErrorInfo& error);
 
+  // Extract selected top-level members of a JSON object without building a
+  // DOM of the whole document. The raw bytes are scanned once; values of
+  // other members are skipped without being decoded, and the scan stops as
+  // soon as every requested key was seen. Bytes after that point are not
+  // validated - a full read (readFile/readObject) reports such errors.
+  // Missing keys are simply absent from `members`.
+  static bool readMembers(const QByteArray& content, const QStringList& keys,
+                          QJsonObject& members, JsonErrorInfo& error);
+  static bool readMembers(const fs::path& path, const QStringList& keys,
+                          QJsonObject& members, JsonErrorInfo& error);
+  static bool readMembers(const std::string& path, const QStringList& keys,
+                          QJsonObject& members, JsonErrorInfo& error);
+
+  // Read and parse many files in parallel, at most maxConcurrency at a time
+  // (0 = ideal thread count). Small files are read into pooled buffers that
+  // are reused across calls and sized to the largest recent file; files of
+  // at least mapThreshold() bytes are read into their own buffer. Results
+  // are in input order.
+  static std::vector<JsonReadResult> readMany(const std::vector<std::string>& paths,
+                                              int maxConcurrency = 0);
+
+  // Streaming form: each result is passed to onResult (in input order, as
+  // soon as it and all earlier ones are ready) and released afterwards.
+  // Workers run a bounded window ahead of the callback.
+  static void readMany(const std::vector<std::string>& paths, const JsonReadCallback& onResult,
+                       int maxConcurrency = 0);
+
+  // Parse `path` and run `checker` on the document; all findings are
+  // returned, each located against one line index of the file
+  static JsonValidationResult validate(const std::string& path, const JsonChecker& checker = {});
+
+  // validate() for a batch of files in parallel, results in input order.
+  // The checker is called concurrently and must be thread-safe.
+  static std::vector<JsonValidationResult> validateMany(const std::vector<std::string>& paths,
+                                                        const JsonChecker& checker = {},
+                                                        int maxConcurrency = 0);
+
+  // validate() without the JsonBackend parse: the checker gets the raw
+  // content, so a checker with its own parser reads each file only once
+  static JsonValidationResult validateContent(const std::string& path, const JsonContentChecker& checker);
+  static std::vector<JsonValidationResult> validateContentMany(const std::vector<std::string>& paths,
+                                                               const JsonContentChecker& checker,
+                                                               int maxConcurrency = 0);
+
+  // Parse bytes already in memory with the build's JsonBackend; errors are
+  // located with line and column
+  static bool parseContent(const QByteArray& content, QJsonDocument& doc, JsonErrorInfo& error);
+
 private:
+  static void readPooled(const std::string& path, JsonReadResult& result);
   static void offsetToLineColumn(const QByteArray& content, int offset, int& line, int& column);
 };
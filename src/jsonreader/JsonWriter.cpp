@@ -0,0 +1,231 @@
+#include "JsonWriter.hpp"
+
+#include <QLocale>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char kHexDigits[] = "0123456789abcdef";
+
+// Two-character escape for c, or 0 when c needs none (or a \u escape)
+char shortEscape(char16_t c)
+{
+  switch (c) {
+    case '"': return '"';
+    case '\\': return '\\';
+    case '\b': return 'b';
+    case '\f': return 'f';
+    case '\n': return 'n';
+    case '\r': return 'r';
+    case '\t': return 't';
+    default: return 0;
+  }
+}
+
+} // namespace
+
+JsonWriter::JsonWriter(QIODevice* device, int indent, qsizetype bufferSize)
+  : m_device(device),
+    m_indent(std::max(indent, 0)),
+    m_buffer(std::max<qsizetype>(bufferSize, 256), Qt::Uninitialized)
+{
+}
+
+JsonWriter::~JsonWriter()
+{
+  flush();
+}
+
+bool JsonWriter::flush()
+{
+  if (m_used > 0 && !m_error) {
+    if (!m_device || m_device->write(m_buffer.constData(), m_used) != m_used) m_error = true;
+  }
+  m_used = 0;
+  return !m_error;
+}
+
+bool JsonWriter::finish()
+{
+  append("\n", 1);
+  return flush();
+}
+
+char* JsonWriter::reserve(qsizetype bytes)
+{
+  if (m_used + bytes > m_buffer.size()) {
+    flush();
+    // A single string larger than the buffer: grow once and keep the size
+    if (bytes > m_buffer.size()) m_buffer.resize(bytes);
+  }
+  char* out = m_buffer.data() + m_used;
+  m_used += bytes;
+  return out;
+}
+
+void JsonWriter::append(const char* data, qsizetype size)
+{
+  std::memcpy(reserve(size), data, size_t(size));
+}
+
+void JsonWriter::newline(size_t depth)
+{
+  if (m_indent == 0) return;
+  const qsizetype spaces = qsizetype(depth) * m_indent;
+  char* out = reserve(1 + spaces);
+  out[0] = '\n';
+  std::memset(out + 1, ' ', size_t(spaces));
+}
+
+void JsonWriter::beforeValue()
+{
+  if (m_afterKey) {
+    m_afterKey = false;
+    return;
+  }
+  if (m_hasItems.empty()) return;
+  if (m_hasItems.back()) append(",", 1);
+  m_hasItems.back() = true;
+  newline(m_hasItems.size());
+}
+
+void JsonWriter::open(char bracket)
+{
+  beforeValue();
+  append(&bracket, 1);
+  m_hasItems.push_back(false);
+}
+
+void JsonWriter::close(char bracket)
+{
+  const bool hadItems = !m_hasItems.empty() && m_hasItems.back();
+  if (!m_hasItems.empty()) m_hasItems.pop_back();
+  if (hadItems) newline(m_hasItems.size());
+  append(&bracket, 1);
+}
+
+void JsonWriter::beginObject() { open('{'); }
+void JsonWriter::endObject() { close('}'); }
+void JsonWriter::beginArray() { open('['); }
+void JsonWriter::endArray() { close(']'); }
+
+void JsonWriter::key(QStringView name)
+{
+  beforeValue();
+  writeString(name);
+  if (m_indent > 0) {
+    append(": ", 2);
+  } else {
+    append(":", 1);
+  }
+  m_afterKey = true;
+}
+
+void JsonWriter::value(QStringView text)
+{
+  beforeValue();
+  writeString(text);
+}
+
+void JsonWriter::value(qint64 number)
+{
+  beforeValue();
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), number);
+  append(digits, qsizetype(result.ptr - digits));
+}
+
+void JsonWriter::value(bool flag)
+{
+  beforeValue();
+  if (flag) {
+    append("true", 4);
+  } else {
+    append("false", 5);
+  }
+}
+
+void JsonWriter::realValue(double number)
+{
+  if (!std::isfinite(number)) {
+    nullValue();
+    return;
+  }
+  beforeValue();
+  const QByteArray digits = QByteArray::number(number, 'g', QLocale::FloatingPointShortest);
+  append(digits.constData(), digits.size());
+}
+
+void JsonWriter::nullValue()
+{
+  beforeValue();
+  append("null", 4);
+}
+
+qsizetype JsonWriter::escapedSize(QStringView text)
+{
+  qsizetype size = 2;
+  const qsizetype n = text.size();
+  for (qsizetype i = 0; i < n; ++i) {
+    const char16_t c = text[i].unicode();
+    if (c < 0x80) {
+      size += shortEscape(c) ? 2 : (c < 0x20 ? 6 : 1);
+    } else if (c < 0x800) {
+      size += 2;
+    } else if (QChar::isHighSurrogate(c) && i + 1 < n && QChar::isLowSurrogate(text[i + 1].unicode())) {
+      size += 4;
+      ++i;
+    } else {
+      size += 3;  // BMP character, or a lone surrogate written as U+FFFD
+    }
+  }
+  return size;
+}
+
+void JsonWriter::writeString(QStringView text)
+{
+  // Exact size first, then encode in place: no temporary UTF-8 copy
+  char* out = reserve(escapedSize(text));
+  *out++ = '"';
+  const qsizetype n = text.size();
+  for (qsizetype i = 0; i < n; ++i) {
+    char32_t c = text[i].unicode();
+    if (c < 0x80) {
+      if (const char escape = shortEscape(char16_t(c))) {
+        *out++ = '\\';
+        *out++ = escape;
+      } else if (c < 0x20) {
+        std::memcpy(out, "\\u00", 4);
+        out[4] = kHexDigits[c >> 4];
+        out[5] = kHexDigits[c & 0xF];
+        out += 6;
+      } else {
+        *out++ = char(c);
+      }
+      continue;
+    }
+
+    if (QChar::isHighSurrogate(c) && i + 1 < n && QChar::isLowSurrogate(text[i + 1].unicode())) {
+      c = QChar::surrogateToUcs4(char16_t(c), text[++i].unicode());
+    } else if (QChar::isSurrogate(c)) {
+      c = 0xFFFD;
+    }
+
+    if (c < 0x800) {
+      *out++ = char(0xC0 | (c >> 6));
+    } else if (c < 0x10000) {
+      *out++ = char(0xE0 | (c >> 12));
+      *out++ = char(0x80 | ((c >> 6) & 0x3F));
+    } else {
+      *out++ = char(0xF0 | (c >> 18));
+      *out++ = char(0x80 | ((c >> 12) & 0x3F));
+      *out++ = char(0x80 | ((c >> 6) & 0x3F));
+    }
+    *out++ = char(0x80 | (c & 0x3F));
+  }
+  *out = '"';
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QStringView>
+#include <vector>
+
+// Streaming JSON writer, the counterpart of JsonReader. Output goes through
+// a fixed-size buffer straight to a QIODevice, so memory use does not grow
+// with the document. Strings are escaped per RFC 8259 and encoded to UTF-8
+// directly into the buffer after their escaped size has been computed.
+//
+//   JsonWriter writer(&file);
+//   writer.beginObject();
+//   writer.member(u"name", u"Box");
+//   writer.key(u"body");
+//   writer.beginArray();
+//   writer.value(u"cube(1);");
+//   writer.endArray();
+//   writer.endObject();
+//   bool ok = writer.finish();
+class JsonWriter {
+public:
+  // indent: spaces per nesting level, 0 writes compact JSON
+  explicit JsonWriter(QIODevice* device, int indent = 2, qsizetype bufferSize = 64 * 1024);
+  ~JsonWriter();
+
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+
+  // Member name; must be followed by exactly one value
+  void key(QStringView name);
+
+  void value(QStringView text);
+  void value(qint64 number);
+  void value(bool flag);
+  void value(const char*) = delete;  // Would silently pick value(bool); use u"..."
+  // Shortest round-trip form; NaN and infinities are written as null
+  void realValue(double number);
+  void nullValue();
+
+  void member(QStringView name, QStringView text) { key(name); value(text); }
+  void member(QStringView name, qint64 number) { key(name); value(number); }
+
+  // Write out the buffer; false once any device write has failed
+  bool flush();
+
+  // Flush and terminate the document with a newline
+  bool finish();
+
+  [[nodiscard]] bool hasError() const { return m_error; }
+
+  // Size of `text` as an escaped JSON string, including the quotes
+  static qsizetype escapedSize(QStringView text);
+
+private:
+  void beforeValue();
+  void open(char bracket);
+  void close(char bracket);
+  void newline(size_t depth);
+  void writeString(QStringView text);
+  char* reserve(qsizetype bytes);
+  void append(const char* data, qsizetype size);
+
+  QIODevice* m_device;
+  int m_indent;
+  QByteArray m_buffer;
+  qsizetype m_used = 0;
+  std::vector<bool> m_hasItems;  // Per open container: an item was written
+  bool m_afterKey = false;
+  bool m_error = false;
+};
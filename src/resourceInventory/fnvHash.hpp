@@ -0,0 +1,73 @@
+/**
+ * @file fnvHash.hpp
+ * @brief FNV-1a hashing for stamps, fingerprints and on-disk indexes
+ *
+ * qHash is seeded per process, so every hash that is compared across
+ * processes or stored in a file (snapshot and index stamps, directory
+ * stamps, scan fingerprints, entry hashes, template pack buckets) uses
+ * these helpers instead.
+ */
+
+#ifndef FNVHASH_H
+#define FNVHASH_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace resourceInventory {
+namespace fnv {
+
+constexpr quint64 kOffset64 = 14695981039346656037ULL;
+constexpr quint64 kPrime64 = 1099511628211ULL;
+constexpr quint32 kOffset32 = 2166136261u;
+constexpr quint32 kPrime32 = 16777619u;
+
+inline quint64 fold(quint64 hash, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kPrime64;
+    }
+    return hash;
+}
+
+template <typename T>
+quint64 foldValue(quint64 hash, T value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only plain values");
+    return fold(hash, &value, sizeof(value));
+}
+
+/// Fold a string followed by a separator, so ("ab", "c") and ("a", "bc") differ
+inline quint64 foldString(quint64 hash, const QString& value)
+{
+    hash = fold(hash, value.constData(), size_t(value.size()) * sizeof(QChar));
+    const quint16 separator = 0xFFFF;
+    return fold(hash, &separator, sizeof(separator));
+}
+
+inline quint64 hash64(const void* data, size_t size)
+{
+    return fold(kOffset64, data, size);
+}
+
+/// 32-bit variant, for compact on-disk hash tables
+inline quint32 hash32(const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    quint32 hash = kOffset32;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kPrime32;
+    }
+    return hash;
+}
+
+} // namespace fnv
+} // namespace resourceInventory
+
+#endif // FNVHASH_H
@@ -0,0 +1,131 @@
+/**
+ * @file installIndex.cpp
+ * @brief Implementation of InstallIndex
+ */
+
+#include "installIndex.hpp"
+#include "fnvHash.hpp"
+#include "inventorySnapshot.hpp"
+#include "applicationNameInfo.hpp"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace resourceInventory {
+
+const QString InstallIndex::fileName = QStringLiteral(".scadtemplates-index");
+const QString InstallIndex::markerFileName = QStringLiteral(".scadtemplates-index.stamp");
+
+QString InstallIndex::indexPath(const QString& rootPath)
+{
+    return QDir(rootPath).filePath(fileName);
+}
+
+bool InstallIndex::write(const platformInfo::ResourceLocation& location,
+                         const QList<ResourceItem>& items,
+                         QString* errorMessage)
+{
+    const QDir root(location.path());
+
+    QList<ResourceItem> relative;
+    relative.reserve(items.size());
+    for (ResourceItem item : items) {
+        item.setPath(root.relativeFilePath(item.path()));
+        item.setSourcePath(root.relativeFilePath(item.sourcePath()));
+        item.setSourceLocationKey(QString());
+        relative.append(item);
+    }
+
+    // Marker first: the stamp stored in the index is taken from it
+    const QString markerPath = QDir(location.path()).filePath(markerFileName);
+    QSaveFile marker(markerPath);
+    if (!marker.open(QIODevice::WriteOnly) || marker.write(buildId().toUtf8() + '\n') < 0
+        || !marker.commit()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot write %1: %2").arg(markerPath, marker.errorString());
+        }
+        return false;
+    }
+
+    const QString path = indexPath(location.path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot write %1: %2").arg(path, file.errorString());
+        }
+        return false;
+    }
+    file.write(InventorySnapshot::serialize(relative, 0, packageStamp(location.path())));
+    if (!file.commit()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot write %1: %2").arg(path, file.errorString());
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool InstallIndex::load(const platformInfo::ResourceLocation& location,
+                        QList<ResourceItem>& items)
+{
+    QFile file(indexPath(location.path()));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Single stamp check before touching the payload
+    InventorySnapshot::Header header;
+    const QByteArray headerBytes = file.read(sizeof(InventorySnapshot::Header));
+    if (!InventorySnapshot::readHeader(headerBytes.constData(), file.size(), header)) {
+        qWarning() << "InstallIndex: Ignoring unreadable index" << file.fileName();
+        return false;
+    }
+    const quint64 stamp = packageStamp(location.path());
+    if (stamp == 0 || header.sourceStamp != stamp) {
+        qDebug() << "InstallIndex: Index is stale for" << location.path();
+        return false;
+    }
+
+    file.seek(0);
+    const QByteArray data = file.readAll();
+    if (!InventorySnapshot::deserialize(data.constData(), data.size(), items)) {
+        qWarning() << "InstallIndex: Corrupt index" << file.fileName();
+        items.clear();
+        return false;
+    }
+
+    const QDir root(location.path());
+    const QString locationKey = location.getDisplayName();
+    for (ResourceItem& item : items) {
+        item.setPath(QDir::cleanPath(root.filePath(item.path())));
+        item.setSourcePath(QDir::cleanPath(root.filePath(item.sourcePath())));
+        item.setSourceLocationKey(locationKey);
+    }
+
+    qDebug() << "InstallIndex: Loaded" << items.size() << "items for" << location.path();
+    return true;
+}
+
+QString InstallIndex::buildId()
+{
+    return QString::fromUtf8(appInfo::version) + QLatin1Char('-') + QString::fromUtf8(appInfo::gitCommitHash);
+}
+
+quint64 InstallIndex::packageStamp(const QString& rootPath)
+{
+    const QFileInfo marker(QDir(rootPath).filePath(markerFileName));
+    if (!marker.isFile()) {
+        return 0;
+    }
+    quint64 hash = fnv::foldString(fnv::kOffset64, buildId());
+    hash = fnv::foldValue(hash, marker.size());
+    hash = fnv::foldValue(hash, marker.lastModified().toSecsSinceEpoch());
+    return hash;
+}
+
+} // namespace resourceInventory
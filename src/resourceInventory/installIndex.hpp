@@ -0,0 +1,78 @@
+/**
+ * @file installIndex.hpp
+ * @brief Prebuilt read-only inventory of an Installation-tier location
+ *
+ * Installation resources (../share/openscad, /usr/share/openscad, ...) do
+ * not change between upgrades, so their inventory is generated once at
+ * package time by the install_index_generator tool (see the install rules
+ * in CMakeLists.txt) and stored next to the resources. At startup the index
+ * is validated against a package stamp - the build id plus one stat of a
+ * marker file - and loaded instead of scanning and parsing the tree.
+ */
+
+#ifndef INSTALLINDEX_H
+#define INSTALLINDEX_H
+
+#include "../platformInfo/export.hpp"
+#include "../platformInfo/ResourceLocation.hpp"
+#include "resourceItem.hpp"
+
+#include <QList>
+#include <QString>
+
+namespace resourceInventory {
+
+/**
+ * @brief Reader/writer for the install-tier index file
+ *
+ * The file is an InventorySnapshot whose source stamp is packageStamp() of
+ * the location root. Item paths are stored relative to the root so the
+ * installed tree may be relocated.
+ */
+class PLATFORMINFO_API InstallIndex {
+public:
+    static const QString fileName;        ///< ".scadtemplates-index"
+    static const QString markerFileName;  ///< ".scadtemplates-index.stamp"
+
+    /// Full path of the index file for a location root
+    static QString indexPath(const QString& rootPath);
+
+    /**
+     * @brief Write the index and its marker file for a scanned location
+     * @param location The Installation location that was scanned
+     * @param items Items discovered in that location
+     * @param errorMessage Receives a description on failure (optional)
+     * @return true if the index was written
+     */
+    static bool write(const platformInfo::ResourceLocation& location,
+                      const QList<ResourceItem>& items,
+                      QString* errorMessage = nullptr);
+
+    /**
+     * @brief Load the index of a location if it is present and current
+     * @param location The Installation location to load
+     * @param items Receives the items, with absolute paths and location key
+     * @return false if the index is missing, unreadable or stale
+     */
+    static bool load(const platformInfo::ResourceLocation& location,
+                     QList<ResourceItem>& items);
+
+    /// Version and commit of this build; an index is only valid for the build that wrote it
+    static QString buildId();
+
+    /**
+     * @brief Package stamp of a root, from one stat of its marker file
+     *
+     * Folds buildId() with the size and modification time (whole seconds,
+     * as kept by package managers and archives) of the marker file that
+     * write() leaves next to the index; 0 if there is no marker. The tree
+     * itself is not walked: installed trees are replaced by an upgrade,
+     * which ships a new build, not edited in place. Touching the marker
+     * invalidates the index after a manual edit.
+     */
+    static quint64 packageStamp(const QString& rootPath);
+};
+
+} // namespace resourceInventory
+
+#endif // INSTALLINDEX_H
@@ -0,0 +1,288 @@
+/**
+ * @file inventorySnapshot.cpp
+ * @brief Implementation of InventorySnapshot and SharedInventory
+ */
+
+#include "inventorySnapshot.hpp"
+#include "fnvHash.hpp"
+#include "../resourceMetadata/ResourceTypeInfo.hpp"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSharedMemory>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace resourceInventory {
+
+namespace {
+
+using fnv::foldString;
+using fnv::foldValue;
+
+struct StampEntry {
+    QString relativePath;
+    qint64 modified = 0;
+
+    bool operator<(const StampEntry& other) const { return relativePath < other.relativePath; }
+};
+
+// Leave headroom so republishing a slightly larger inventory reuses the segment
+qsizetype segmentCapacity(qsizetype payload)
+{
+    constexpr qsizetype kGranule = 256 * 1024;
+    const qsizetype wanted = payload + payload / 2;
+    return ((wanted / kGranule) + 1) * kGranule;
+}
+
+} // namespace
+
+// ============================================================================
+// InventorySnapshot
+// ============================================================================
+
+QByteArray InventorySnapshot::serialize(const QList<ResourceItem>& items,
+                                        quint64 generation,
+                                        quint64 sourceStamp)
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        for (const ResourceItem& item : items) {
+            out << item;
+        }
+    }
+
+    Header header;
+    header.magic = kMagic;
+    header.formatVersion = kFormatVersion;
+    header.generation = generation;
+    header.sourceStamp = sourceStamp;
+    header.itemCount = static_cast<quint32>(items.size());
+    header.payloadSize = static_cast<quint32>(payload.size());
+
+    QByteArray result;
+    result.reserve(qsizetype(sizeof(Header)) + payload.size());
+    result.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    result.append(payload);
+    return result;
+}
+
+bool InventorySnapshot::readHeader(const char* data, qsizetype size, Header& header)
+{
+    if (!data || size < qsizetype(sizeof(Header))) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != kMagic || header.formatVersion != kFormatVersion) {
+        return false;
+    }
+    return qsizetype(sizeof(Header)) + qsizetype(header.payloadSize) <= size;
+}
+
+bool InventorySnapshot::deserialize(const char* data, qsizetype size,
+                                    QList<ResourceItem>& items, Header* header)
+{
+    Header h;
+    if (!readHeader(data, size, h)) {
+        return false;
+    }
+
+    // Wrap the payload instead of copying it; the items are decoded below
+    const QByteArray payload = QByteArray::fromRawData(data + sizeof(Header), h.payloadSize);
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    items.clear();
+    items.reserve(h.itemCount);
+    for (quint32 i = 0; i < h.itemCount; ++i) {
+        ResourceItem item;
+        in >> item;
+        if (in.status() != QDataStream::Ok) {
+            items.clear();
+            return false;
+        }
+        items.append(item);
+    }
+
+    if (header) {
+        *header = h;
+    }
+    return true;
+}
+
+quint64 InventorySnapshot::directoryStamp(const QString& rootPath)
+{
+    const QDir root(rootPath);
+
+    std::vector<StampEntry> entries;
+    for (const QString& folder : resourceMetadata::s_allResourceFolders) {
+        const QFileInfo folderInfo(root.filePath(folder));
+        if (!folderInfo.isDir()) {
+            continue;
+        }
+        entries.push_back({folder, folderInfo.lastModified().toMSecsSinceEpoch()});
+        // One level of category folders; nothing below them is visited
+        QDirIterator it(folderInfo.filePath(), QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        while (it.hasNext()) {
+            it.next();
+            entries.push_back({folder + QLatin1Char('/') + it.fileName(),
+                               it.fileInfo().lastModified().toMSecsSinceEpoch()});
+        }
+    }
+    // Listing order depends on the file system
+    std::sort(entries.begin(), entries.end());
+
+    quint64 hash = fnv::kOffset64;
+    for (const StampEntry& entry : entries) {
+        hash = foldString(hash, entry.relativePath);
+        hash = foldValue(hash, entry.modified);
+    }
+    return hash;
+}
+
+quint64 InventorySnapshot::locationStamp(const QList<platformInfo::ResourceLocation>& locations)
+{
+    quint64 hash = fnv::kOffset64;
+
+    for (const auto& location : locations) {
+        const QString root = location.path();
+        hash = foldString(hash, root);
+        hash = foldValue(hash, qint64(directoryStamp(root)));
+    }
+
+    return hash;
+}
+
+// ============================================================================
+// SharedInventory
+// ============================================================================
+
+SharedInventory::SharedInventory(const QList<platformInfo::ResourceLocation>& locations)
+    : m_key(keyForLocations(locations))
+    , m_sourceStamp(InventorySnapshot::locationStamp(locations))
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    m_memory = std::make_unique<QSharedMemory>(QSharedMemory::legacyNativeKey(m_key));
+#else
+    m_memory = std::make_unique<QSharedMemory>(m_key);
+#endif
+}
+
+SharedInventory::~SharedInventory() = default;
+
+QString SharedInventory::keyForLocations(const QList<platformInfo::ResourceLocation>& locations)
+{
+    QStringList paths;
+    paths.reserve(locations.size());
+    for (const auto& location : locations) {
+        paths.append(QDir::cleanPath(location.path()));
+    }
+    paths.sort();
+
+    quint64 hash = fnv::kOffset64;
+    for (const QString& path : paths) {
+        hash = foldString(hash, path);
+    }
+
+    return QStringLiteral("scadtemplates-inventory-") + QString::number(hash, 16);
+}
+
+bool SharedInventory::attach()
+{
+    if (m_memory->isAttached()) {
+        return true;
+    }
+    return m_memory->attach(QSharedMemory::ReadWrite);
+}
+
+bool SharedInventory::load(QList<ResourceItem>& items)
+{
+    if (!attach()) {
+        return false;  // No sibling has published yet
+    }
+
+    if (!m_memory->lock()) {
+        qWarning() << "SharedInventory: Cannot lock" << m_key << m_memory->errorString();
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(m_memory->constData());
+    InventorySnapshot::Header header;
+    bool fresh = false;
+
+    if (InventorySnapshot::readHeader(data, m_memory->size(), header)) {
+        m_generation = header.generation;
+        if (header.sourceStamp == m_sourceStamp) {
+            fresh = InventorySnapshot::deserialize(data, m_memory->size(), items);
+        }
+    }
+
+    m_memory->unlock();
+
+    if (fresh) {
+        qDebug() << "SharedInventory: Attached to generation" << m_generation
+                 << "with" << items.size() << "items";
+    } else {
+        qDebug() << "SharedInventory: Snapshot generation" << m_generation << "is stale";
+    }
+    return fresh;
+}
+
+bool SharedInventory::publish(const QList<ResourceItem>& items)
+{
+    QByteArray data = InventorySnapshot::serialize(items, 0, m_sourceStamp);
+
+    if (m_memory->isAttached() && m_memory->size() < data.size()) {
+        m_memory->detach();
+    }
+
+    if (!m_memory->isAttached()) {
+        if (!m_memory->create(segmentCapacity(data.size()))) {
+            // Another process owns the segment - reuse it if it is large enough
+            if (m_memory->error() != QSharedMemory::AlreadyExists || !attach()) {
+                qWarning() << "SharedInventory: Cannot create" << m_key << m_memory->errorString();
+                return false;
+            }
+            if (m_memory->size() < data.size()) {
+                qWarning() << "SharedInventory: Existing segment too small for snapshot";
+                m_memory->detach();
+                return false;
+            }
+        }
+    }
+
+    if (!m_memory->lock()) {
+        qWarning() << "SharedInventory: Cannot lock" << m_key << m_memory->errorString();
+        return false;
+    }
+
+    // Next generation follows whatever is currently in the segment
+    InventorySnapshot::Header current;
+    quint64 generation = m_generation;
+    if (InventorySnapshot::readHeader(static_cast<const char*>(m_memory->constData()),
+                                      m_memory->size(), current)) {
+        generation = std::max(generation, current.generation);
+    }
+    ++generation;
+    std::memcpy(data.data() + offsetof(InventorySnapshot::Header, generation),
+                &generation, sizeof(generation));
+
+    std::memcpy(m_memory->data(), data.constData(), size_t(data.size()));
+    m_memory->unlock();
+
+    m_generation = generation;
+    qDebug() << "SharedInventory: Published generation" << m_generation
+             << "with" << items.size() << "items";
+    return true;
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,158 @@
+/**
+ * @file inventorySnapshot.hpp
+ * @brief Serialized inventory snapshots shared between sibling installations
+ *
+ * ResourcePaths::qualifiedSearchPaths() deliberately includes the sibling
+ * installation (LTS <-> Nightly), so both variants scan the same Machine and
+ * User locations. The first process to scan publishes a read-only snapshot
+ * of those items in shared memory; a sibling started later attaches to the
+ * segment and decodes the items from it in one pass instead of walking and
+ * parsing the file system again. Attaching is not zero-copy: every item is
+ * decoded into strings of its own while the segment is locked, and the
+ * segment is not referenced afterwards.
+ */
+
+#ifndef INVENTORYSNAPSHOT_H
+#define INVENTORYSNAPSHOT_H
+
+#include "../platformInfo/export.hpp"
+#include "../platformInfo/ResourceLocation.hpp"
+#include "resourceItem.hpp"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+
+class QSharedMemory;
+
+namespace resourceInventory {
+
+/**
+ * @brief Binary encoding of a list of ResourceItems
+ *
+ * Layout: fixed Header followed by a QDataStream payload of the items.
+ * The header carries a generation counter (bumped on every publish) and
+ * the source stamp of the locations the items were scanned from.
+ */
+class PLATFORMINFO_API InventorySnapshot {
+public:
+    struct Header {
+        quint32 magic = 0;
+        quint32 formatVersion = 0;
+        quint64 generation = 0;     ///< Incremented by every publish
+        quint64 sourceStamp = 0;    ///< locationStamp() at scan time
+        quint32 itemCount = 0;
+        quint32 payloadSize = 0;    ///< Bytes following the header
+    };
+
+    static constexpr quint32 kMagic = 0x53544956;  // "STIV"
+    static constexpr quint32 kFormatVersion = 1;
+
+    /**
+     * @brief Encode items with header into a contiguous buffer
+     */
+    static QByteArray serialize(const QList<ResourceItem>& items,
+                                quint64 generation,
+                                quint64 sourceStamp);
+
+    /**
+     * @brief Read and validate the header at the start of a buffer
+     * @return false if the buffer is too small or magic/version mismatch
+     */
+    static bool readHeader(const char* data, qsizetype size, Header& header);
+
+    /**
+     * @brief Decode items from a buffer produced by serialize()
+     *
+     * The buffer is read through QByteArray::fromRawData and a QDataStream,
+     * so it is not copied as a whole, but every item is decoded into new
+     * strings: the result is a copy, not a view of the buffer.
+     */
+    static bool deserialize(const char* data, qsizetype size,
+                            QList<ResourceItem>& items, Header* header = nullptr);
+
+    /**
+     * @brief Cheap change stamp for one resource root
+     *
+     * Folds the modification times of the resource folders (templates/,
+     * examples/, ...) and of their direct subfolders (categories): one
+     * listing per resource folder, no file is stat'ed or opened. Adding,
+     * removing or atomically saving (QSaveFile, most editors) a resource
+     * in a resource or category folder changes the stamp; changes deeper
+     * down or in-place writes do not, and are picked up by the next
+     * refresh.
+     */
+    static quint64 directoryStamp(const QString& rootPath);
+
+    /**
+     * @brief Cheap change stamp for a set of locations
+     *
+     * Combines the path and directoryStamp() of every location.
+     */
+    static quint64 locationStamp(const QList<platformInfo::ResourceLocation>& locations);
+};
+
+/**
+ * @brief Shared-memory holder for an InventorySnapshot
+ *
+ * The segment key is derived from the (sorted) location paths, so both
+ * sibling variants that scan the same Machine/User locations agree on it.
+ * The publishing process must keep this object alive for the segment to
+ * stay available to siblings.
+ *
+ * Usage:
+ * @code
+ *   SharedInventory shared(sharedLocations);
+ *   QList<ResourceItem> items;
+ *   if (!shared.load(items)) {
+ *       items = scanLocations(sharedLocations);
+ *       shared.publish(items);
+ *   }
+ * @endcode
+ */
+class PLATFORMINFO_API SharedInventory {
+public:
+    explicit SharedInventory(const QList<platformInfo::ResourceLocation>& locations);
+    ~SharedInventory();
+
+    SharedInventory(const SharedInventory&) = delete;
+    SharedInventory& operator=(const SharedInventory&) = delete;
+
+    /**
+     * @brief Attach to an existing snapshot and decode it if still fresh
+     * @param items Receives the snapshot items on success
+     * @return false if no snapshot exists or its source stamp is stale
+     */
+    bool load(QList<ResourceItem>& items);
+
+    /**
+     * @brief Publish items as the next generation of the snapshot
+     * @return true if the snapshot was written to shared memory
+     */
+    bool publish(const QList<ResourceItem>& items);
+
+    /// Generation of the snapshot last loaded or published (0 = none)
+    quint64 generation() const { return m_generation; }
+
+    /// Stamp of the locations computed at construction
+    quint64 sourceStamp() const { return m_sourceStamp; }
+
+    /// Shared memory key used by this inventory
+    QString key() const { return m_key; }
+
+    /// Segment key for a set of locations
+    static QString keyForLocations(const QList<platformInfo::ResourceLocation>& locations);
+
+private:
+    bool attach();
+
+    QString m_key;
+    quint64 m_sourceStamp = 0;
+    quint64 m_generation = 0;
+    std::unique_ptr<QSharedMemory> m_memory;
+};
+
+} // namespace resourceInventory
+
+#endif // INVENTORYSNAPSHOT_H
@@ -1,4 +1,5 @@
 #include "resourceItem.hpp"
+#include <QDataStream>
 #include <QFileInfo>
 #include <QMetaType>
 
@@ -115,20 +116,111 @@ ResourceTier stringToResourceTier(const QString& str)
     return ResourceTier::User;
 }
 
+// ============================================================================
+// Serialization
+// ============================================================================
+
+QDataStream& operator<<(QDataStream& out, const ResourceItem& item)
+{
+    out << item.path() << item.name() << item.displayName() << item.description()
+        << item.category() << item.sourcePath() << item.sourceLocationKey()
+        << static_cast<quint8>(item.type())
+        << static_cast<quint8>(item.tier())
+        << static_cast<quint8>(item.access())
+        << item.exists() << item.isEnabled() << item.isModified()
+        << item.lastModified();
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, ResourceItem& item)
+{
+    QString path, name, displayName, description, category, sourcePath, locationKey;
+    quint8 type = 0, tier = 0, access = 0;
+    bool exists = false, enabled = true, modified = false;
+    QDateTime lastModified;
+    
+    in >> path >> name >> displayName >> description
+       >> category >> sourcePath >> locationKey
+       >> type >> tier >> access
+       >> exists >> enabled >> modified
+       >> lastModified;
+    
+    item.setPath(path);
+    item.setName(name);
+    item.setDisplayName(displayName);
+    item.setDescription(description);
+    item.setCategory(category);
+    item.setSourcePath(sourcePath);
+    item.setSourceLocationKey(locationKey);
+    item.setType(static_cast<ResourceType>(type));
+    item.setTier(static_cast<ResourceTier>(tier));
+    item.setAccess(static_cast<ResourceAccess>(access));
+    item.setExists(exists);
+    item.setEnabled(enabled);
+    item.setModified(modified);
+    item.setLastModified(lastModified);
+    return in;
+}
+
 // ============================================================================
 // ResourceTemplate
 // ============================================================================
 
 ResourceTemplate::ResourceTemplate(const QString& path)
     : ResourceItem(path)
-    , m_format(QStringLiteral("text/scad.template"))
     , m_version(QStringLiteral("1"))
 {
+    setFormat(QStringLiteral("text/scad.template"));
 }
 
 bool ResourceTemplate::isValid() const
 {
-    return ResourceItem::isValid() && !m_body.isEmpty() && !m_prefix.isEmpty();
+    // A lazy template is valid while its source exists; checked with a
+    // stat, so adding a listed template does not load its content
+    return ResourceItem::isValid() && (isLazy() ? m_contentSource->isAvailable() : !content()->body.isEmpty())
+           && !m_prefix.isEmpty();
+}
+
+bool ResourceTemplate::isStale() const
+{
+    // Loads are cached, so this costs one lookup once the content was read
+    return m_contentSource && !m_contentSource->load();
+}
+
+std::shared_ptr<const TemplateContent> ResourceTemplate::content() const
+{
+    if (m_content) {
+        return m_content;
+    }
+    if (m_contentSource) {
+        if (auto loaded = m_contentSource->load()) {
+            return loaded;
+        }
+    }
+    static const std::shared_ptr<const TemplateContent> empty = std::make_shared<TemplateContent>();
+    return empty;
+}
+
+void ResourceTemplate::setContent(std::shared_ptr<const TemplateContent> content)
+{
+    m_content = std::move(content);
+    m_contentSource.reset();
+}
+
+void ResourceTemplate::setContentSource(std::shared_ptr<const TemplateContentSource> source)
+{
+    m_contentSource = std::move(source);
+    m_content.reset();
+}
+
+TemplateContent& ResourceTemplate::ownContent()
+{
+    if (!m_content || m_content.use_count() > 1) {
+        m_content = std::make_shared<TemplateContent>(*content());
+    }
+    m_contentSource.reset();
+    // Every TemplateContent is created non-const; this one is not shared
+    return const_cast<TemplateContent&>(*m_content);
 }
 
 void ResourceTemplate::setEditSubtype(scadtemplates::EditSubtype subtype)
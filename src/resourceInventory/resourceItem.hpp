@@ -7,12 +7,17 @@
 #include "../resourceMetadata/ResourceAccess.hpp"
 #include "../scadtemplates/edittype.hpp"
 #include "../scadtemplates/editsubtype.hpp"
+#include "stringPool.hpp"
 
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
 #include <QVariant>
 
+#include <memory>
+
+class QDataStream;
+
 namespace resourceInventory {
 
 // Use Gold Standard enums from resourceMetadata
@@ -57,15 +62,20 @@ public:
     void setAccess(ResourceAccess access) { m_access = access; }
     
     // Category (for templates: subfolder name; for libraries: category tag)
-    QString category() const { return m_category; }
-    void setCategory(const QString& category) { m_category = category; }
+    QString category() const { return StringPool::instance().string(m_categoryId); }
+    void setCategory(const QString& category) { m_categoryId = StringPool::instance().intern(category); }
     
     // Source tracking (for updates)
     QString sourcePath() const { return m_sourcePath; }
     void setSourcePath(const QString& path) { m_sourcePath = path; }
     
-    QString sourceLocationKey() const { return m_sourceLocationKey; }
-    void setSourceLocationKey(const QString& key) { m_sourceLocationKey = key; }
+    QString sourceLocationKey() const { return StringPool::instance().string(m_locationKeyId); }
+    void setSourceLocationKey(const QString& key) { m_locationKeyId = StringPool::instance().intern(key); }
+    
+    // Category and location key are stored as StringPool ids only; compare
+    // these instead of the strings
+    StringPool::Id categoryId() const { return m_categoryId; }
+    StringPool::Id locationKeyId() const { return m_locationKeyId; }
     
     // State
     bool exists() const { return m_exists; }
@@ -87,13 +97,15 @@ public:
     static int metaTypeId();
     
 protected:
+    friend class ResourceTable;     // Rebuilds items from its columns
+    
     QString m_path;
     QString m_name;
     QString m_displayName;
     QString m_description;
-    QString m_category;
     QString m_sourcePath;           // Original path where found
-    QString m_sourceLocationKey;    // Key in ResLocMap for updates
+    StringPool::Id m_categoryId = StringPool::kEmpty;
+    StringPool::Id m_locationKeyId = StringPool::kEmpty;    // Key in ResLocMap for updates
     
     ResourceType m_type = ResourceType::Unknown;
     ResourceTier m_tier = ResourceTier::User;
@@ -133,44 +145,114 @@ private:
     QStringList m_attachments;
 };
 
+/**
+ * @brief Content of a template that is only needed once it is opened
+ * 
+ * Shared between templates and the content cache; never modified once
+ * published (ResourceTemplate copies it before writing).
+ */
+struct TemplateContent {
+    QString body;           // Assembled template body
+    QString rawText;        // Original legacy format text
+    QString description;    // Description stored with the body (may be empty)
+    QStringList scopes;     // Language scopes for filtering
+    
+    /// Approximate heap size, for cache budgets
+    qsizetype byteSize() const
+    {
+        qsizetype chars = body.size() + rawText.size() + description.size();
+        for (const QString& scope : scopes) {
+            chars += scope.size();
+        }
+        return qsizetype(sizeof(TemplateContent)) + chars * qsizetype(sizeof(QChar));
+    }
+};
+
+/**
+ * @brief Where the content of a lazy template is loaded from
+ * 
+ * Implemented by the scanners (template file or pack entry plus the
+ * fingerprint seen while listing); load() is expected to go through a
+ * shared cache so repeated access does not read the source again.
+ */
+class PLATFORMINFO_API TemplateContentSource {
+public:
+    virtual ~TemplateContentSource() = default;
+    
+    /// Content of the template, or nullptr if the source cannot be read
+    virtual std::shared_ptr<const TemplateContent> load() const = 0;
+    
+    /// Whether the source still exists; a stat, nothing is read
+    virtual bool isAvailable() const = 0;
+};
+
 /**
  * @brief Resource representing a template
  * 
  * Extends ResourceItem with template-specific metadata
  * including format, source tag, and version.
+ * 
+ * Body, raw text and scopes are either owned or lazy: a lazy template
+ * only keeps a TemplateContentSource and materializes its content on
+ * access, so a large listed inventory holds little more than metadata.
+ * Writing any content field makes the template own its content.
  */
 class PLATFORMINFO_API ResourceTemplate : public ResourceItem {
 public:
     ResourceTemplate() = default;
     explicit ResourceTemplate(const QString& path);
     
-    // Template metadata
-    QString format() const { return m_format; }
-    void setFormat(const QString& format) { m_format = format; }
+    // Template metadata (stored as StringPool ids)
+    QString format() const { return StringPool::instance().string(m_formatId); }
+    void setFormat(const QString& format) { m_formatId = StringPool::instance().intern(format); }
+    StringPool::Id formatId() const { return m_formatId; }
     
-    QString source() const { return m_source; }
-    void setSource(const QString& source) { m_source = source; }
+    QString source() const { return StringPool::instance().string(m_sourceId); }
+    void setSource(const QString& source) { m_sourceId = StringPool::instance().intern(source); }
+    StringPool::Id sourceId() const { return m_sourceId; }
     
     QString version() const { return m_version; }
     void setVersion(const QString& version) { m_version = version; }
     
     // Template content
-    QString body() const { return m_body; }
-    void setBody(const QString& body) { m_body = body; }
+    QString body() const { return content()->body; }
+    void setBody(const QString& body) { ownContent().body = body; }
     
     // Raw legacy content (for imported templates)
-    QString rawText() const { return m_rawText; }
-    void setRawText(const QString& text) { m_rawText = text; }
+    QString rawText() const { return content()->rawText; }
+    void setRawText(const QString& text) { ownContent().rawText = text; }
     
     // Template triggering
     QString prefix() const { return m_prefix; }
     void setPrefix(const QString& prefix) { m_prefix = prefix; }
     
     // Language scopes (e.g., "source.scad", "text.plain")
-    QStringList scopes() const { return m_scopes; }
-    void setScopes(const QStringList& scopes) { m_scopes = scopes; }
-    void addScope(const QString& scope) { m_scopes.append(scope); }
-    void clearScopes() { m_scopes.clear(); }
+    QStringList scopes() const { return content()->scopes; }
+    void setScopes(const QStringList& scopes) { ownContent().scopes = scopes; }
+    void addScope(const QString& scope) { ownContent().scopes.append(scope); }
+    void clearScopes() { ownContent().scopes.clear(); }
+    
+    // Content storage
+    
+    /**
+     * @brief Current content; loaded from the source for lazy templates
+     * @return Never null (empty content if there is none or loading fails;
+     *         see isStale())
+     */
+    std::shared_ptr<const TemplateContent> content() const;
+    
+    /// Own the given (shared) content; drops the content source
+    void setContent(std::shared_ptr<const TemplateContent> content);
+    
+    /// Make the template lazy: drops owned content
+    void setContentSource(std::shared_ptr<const TemplateContentSource> source);
+    const std::shared_ptr<const TemplateContentSource>& contentSource() const { return m_contentSource; }
+    bool isLazy() const { return m_contentSource != nullptr; }
+    
+    /// Lazy template whose source can no longer be read (e.g. deleted);
+    /// its content() is empty and must not be written back. Loads the
+    /// content; isValid() only checks that the source exists.
+    bool isStale() const;
     
     // File type classification
     scadtemplates::EditType editType() const { return m_editType; }
@@ -182,13 +264,15 @@ public:
     bool isValid() const override;
     
 private:
-    QString m_format;       // MIME type, e.g., "text/scad.template"
-    QString m_source;       // Source tag: "legacy-converted", "cppsnippet-made", "openscad-made"
+    // Unshared, writable content (copy-on-write; materializes lazy content)
+    TemplateContent& ownContent();
+    
+    StringPool::Id m_formatId = StringPool::kEmpty;  // MIME type, e.g., "text/scad.template"
+    StringPool::Id m_sourceId = StringPool::kEmpty;  // Source tag: "legacy-converted", "cppsnippet-made", "openscad-made"
     QString m_version;      // Version string
-    QString m_body;         // Assembled template body
-    QString m_rawText;      // Original legacy format text
     QString m_prefix;       // Trigger text for template insertion
-    QStringList m_scopes;   // Language scopes for filtering
+    std::shared_ptr<const TemplateContent> m_content;               // Owned content
+    std::shared_ptr<const TemplateContentSource> m_contentSource;   // Lazy content
     scadtemplates::EditType m_editType = scadtemplates::EditType::Text;
     scadtemplates::EditSubtype m_editSubtype = scadtemplates::EditSubtype::Txt;
 };
@@ -202,6 +286,15 @@ PLATFORMINFO_API ResourceType stringToResourceType(const QString& str);
 PLATFORMINFO_API QString resourceTierToString(ResourceTier tier);
 PLATFORMINFO_API ResourceTier stringToResourceTier(const QString& str);
 
+/**
+ * @brief Binary serialization of the ResourceItem base fields
+ * 
+ * Used by inventory snapshots and prebuilt indexes. Subclass fields
+ * (attachments, template body) are not part of the stream.
+ */
+PLATFORMINFO_API QDataStream& operator<<(QDataStream& out, const ResourceItem& item);
+PLATFORMINFO_API QDataStream& operator>>(QDataStream& in, ResourceItem& item);
+
 } // namespace resourceInventory
 
 Q_DECLARE_METATYPE(resourceInventory::ResourceItem)
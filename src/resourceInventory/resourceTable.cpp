@@ -0,0 +1,230 @@
+#include "resourceTable.hpp"
+
+#include <QDateTime>
+
+#include <limits>
+
+namespace resourceInventory {
+
+namespace {
+
+constexpr qint64 kNoDate = std::numeric_limits<qint64>::min();
+
+} // namespace
+
+ResourceTable ResourceTable::fromItems(const QList<ResourceItem>& items)
+{
+    ResourceTable table;
+    table.append(items);
+    return table;
+}
+
+QList<ResourceItem> ResourceTable::toItems() const
+{
+    QList<ResourceItem> items;
+    items.reserve(m_liveRows);
+    for (RowId row = 0; row < RowId(m_flags.size()); ++row) {
+        if (m_flags[row] & Live) {
+            items.append(item(row));
+        }
+    }
+    return items;
+}
+
+ResourceTable::RowId ResourceTable::append(const ResourceItem& item)
+{
+    const RowId row = RowId(m_flags.size());
+    m_path.emplace_back();
+    m_name.emplace_back();
+    m_displayName.emplace_back();
+    m_description.emplace_back();
+    m_sourcePath.emplace_back();
+    m_category.push_back(0);
+    m_locationKey.push_back(0);
+    m_lastModified.push_back(kNoDate);
+    m_type.push_back(0);
+    m_tier.push_back(0);
+    m_access.push_back(0);
+    m_flags.push_back(0);
+    store(row, item);
+    ++m_liveRows;
+    return row;
+}
+
+QList<ResourceTable::RowId> ResourceTable::append(const QList<ResourceItem>& items)
+{
+    reserve(qsizetype(m_flags.size()) + items.size());
+    QList<RowId> rows;
+    rows.reserve(items.size());
+    for (const ResourceItem& item : items) {
+        rows.append(append(item));
+    }
+    return rows;
+}
+
+bool ResourceTable::update(RowId row, const ResourceItem& item)
+{
+    if (!contains(row)) {
+        return false;
+    }
+    m_usedText -= m_path[row].length + m_name[row].length + m_displayName[row].length
+                  + m_description[row].length + m_sourcePath[row].length;
+    store(row, item);
+    if (m_usedText * 2 < m_text.size()) {
+        compact();
+    }
+    return true;
+}
+
+bool ResourceTable::remove(RowId row)
+{
+    if (!contains(row)) {
+        return false;
+    }
+    m_usedText -= m_path[row].length + m_name[row].length + m_displayName[row].length
+                  + m_description[row].length + m_sourcePath[row].length;
+    m_path[row] = m_name[row] = m_displayName[row] = m_description[row] = m_sourcePath[row] = TextRange();
+    m_flags[row] = 0;
+    --m_liveRows;
+    if (m_usedText * 2 < m_text.size()) {
+        compact();
+    }
+    return true;
+}
+
+void ResourceTable::clear()
+{
+    *this = ResourceTable();
+}
+
+void ResourceTable::reserve(qsizetype rows)
+{
+    const size_t count = size_t(rows);
+    m_path.reserve(count);
+    m_name.reserve(count);
+    m_displayName.reserve(count);
+    m_description.reserve(count);
+    m_sourcePath.reserve(count);
+    m_category.reserve(count);
+    m_locationKey.reserve(count);
+    m_lastModified.reserve(count);
+    m_type.reserve(count);
+    m_tier.reserve(count);
+    m_access.reserve(count);
+    m_flags.reserve(count);
+}
+
+bool ResourceTable::contains(RowId row) const
+{
+    return row < RowId(m_flags.size()) && (m_flags[row] & Live);
+}
+
+QList<ResourceTable::RowId> ResourceTable::rows() const
+{
+    QList<RowId> result;
+    result.reserve(m_liveRows);
+    for (RowId row = 0; row < RowId(m_flags.size()); ++row) {
+        if (m_flags[row] & Live) {
+            result.append(row);
+        }
+    }
+    return result;
+}
+
+QString ResourceTable::sourcePath(RowId row) const
+{
+    return text((m_flags[row] & SourceIsPath) ? m_path[row] : m_sourcePath[row]).toString();
+}
+
+ResourceItem ResourceTable::item(RowId row) const
+{
+    ResourceItem result;
+    if (!contains(row)) {
+        return result;
+    }
+    result.m_path = path(row);
+    result.m_name = name(row);
+    result.m_displayName = text(m_displayName[row]).toString();
+    result.m_description = description(row);
+    result.m_sourcePath = sourcePath(row);
+    result.m_categoryId = m_category[row];     // Already interned
+    result.m_locationKeyId = m_locationKey[row];
+    result.m_type = type(row);
+    result.m_tier = tier(row);
+    result.m_access = access(row);
+    result.m_exists = m_flags[row] & Exists;
+    result.m_isEnabled = m_flags[row] & Enabled;
+    result.m_isModified = m_flags[row] & Modified;
+    if (m_lastModified[row] != kNoDate) {
+        result.m_lastModified = QDateTime::fromMSecsSinceEpoch(m_lastModified[row]);
+    }
+    return result;
+}
+
+qsizetype ResourceTable::byteSize() const
+{
+    constexpr qsizetype kRowBytes = 5 * sizeof(TextRange) + 2 * sizeof(StringPool::Id)
+                                    + sizeof(qint64) + 4 * sizeof(quint8);
+    return qsizetype(m_flags.capacity()) * kRowBytes + m_text.capacity() * qsizetype(sizeof(QChar));
+}
+
+ResourceTable::TextRange ResourceTable::addText(const QString& value)
+{
+    TextRange range;
+    if (value.isEmpty()) {
+        return range;
+    }
+    range.offset = quint32(m_text.size());
+    range.length = quint32(value.size());
+    m_text.append(value);
+    m_usedText += value.size();
+    return range;
+}
+
+void ResourceTable::store(RowId row, const ResourceItem& item)
+{
+    const QString path = item.path();
+    const QString name = item.name();
+    const QString displayName = item.displayName();
+    const QString sourcePath = item.sourcePath();
+    // The scanner sets the source path to the item's own path
+    const bool sourceIsPath = !sourcePath.isEmpty() && sourcePath == path;
+    m_path[row] = addText(path);
+    m_name[row] = addText(name);
+    m_displayName[row] = addText(displayName == name ? QString() : displayName);
+    m_description[row] = addText(item.description());
+    m_sourcePath[row] = addText(sourceIsPath ? QString() : sourcePath);
+    m_category[row] = item.categoryId();
+    m_locationKey[row] = item.locationKeyId();
+    const QDateTime lastModified = item.lastModified();
+    m_lastModified[row] = lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : kNoDate;
+    m_type[row] = quint8(item.type());
+    m_tier[row] = quint8(item.tier());
+    m_access[row] = quint8(item.access());
+    m_flags[row] = Live | (item.exists() ? Exists : 0) | (item.isEnabled() ? Enabled : 0)
+                   | (item.isModified() ? Modified : 0) | (sourceIsPath ? SourceIsPath : 0);
+}
+
+void ResourceTable::compact()
+{
+    // Copy the text of live rows into a fresh buffer; row ids do not change
+    QString text;
+    text.reserve(m_usedText);
+    const auto move = [this, &text](TextRange& range) {
+        if (range.length == 0) return;
+        const quint32 offset = quint32(text.size());
+        text.append(QStringView(m_text).mid(range.offset, range.length));
+        range.offset = offset;
+    };
+    for (RowId row = 0; row < RowId(m_flags.size()); ++row) {
+        if (!(m_flags[row] & Live)) continue;
+        move(m_path[row]);
+        move(m_name[row]);
+        move(m_displayName[row]);
+        move(m_description[row]);
+        move(m_sourcePath[row]);
+    }
+    m_text = std::move(text);
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,129 @@
+/**
+ * @file resourceTable.hpp
+ * @brief Columnar storage of ResourceItem base fields
+ *
+ * A QList<ResourceItem> keeps seven QStrings, a QDateTime, the enums and
+ * flags plus a vtable pointer per item, each string with its own heap
+ * block. ResourceTable stores the same fields one column per field: the
+ * free-text fields (path, name, display name, description, source path)
+ * as ranges of one shared character buffer, the repetitive ones (category,
+ * location key) as their StringPool ids, and type/tier/access/flags as
+ * bytes. A row then costs about 60 bytes plus its text.
+ *
+ * ResourceScanner keeps the items of each rescanned folder here between
+ * incremental rescans.
+ */
+
+#ifndef RESOURCETABLE_H
+#define RESOURCETABLE_H
+
+#include "../platformInfo/export.hpp"
+#include "resourceItem.hpp"
+#include "stringPool.hpp"
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <vector>
+
+namespace resourceInventory {
+
+/**
+ * @brief Structure-of-arrays inventory with stable row ids
+ *
+ * Rows are addressed by a 32-bit id that stays valid until the row is
+ * removed or the table is cleared; ids of removed rows are not reused.
+ * Like InventorySnapshot, only the ResourceItem base fields are stored;
+ * item() rebuilds a plain ResourceItem.
+ *
+ * Updating or removing rows leaves their old text in the buffer; the
+ * table compacts itself once more than half of the buffer is unused.
+ * Not thread-safe.
+ */
+class PLATFORMINFO_API ResourceTable {
+public:
+    using RowId = quint32;
+    static constexpr RowId kInvalidRow = ~RowId(0);
+
+    ResourceTable() = default;
+
+    static ResourceTable fromItems(const QList<ResourceItem>& items);
+    QList<ResourceItem> toItems() const;   // Live rows in id order
+
+    RowId append(const ResourceItem& item);
+    QList<RowId> append(const QList<ResourceItem>& items);
+    bool update(RowId row, const ResourceItem& item);
+    bool remove(RowId row);
+    void clear();
+    void reserve(qsizetype rows);
+
+    bool contains(RowId row) const;
+    qsizetype size() const { return m_liveRows; }
+    bool isEmpty() const { return m_liveRows == 0; }
+
+    /// Live row ids in id (insertion) order
+    QList<RowId> rows() const;
+
+    /// Row as a ResourceItem; a default item for unknown ids. Interned
+    /// fields are assigned by id, without going through the pool.
+    ResourceItem item(RowId row) const;
+
+    // Columns; rows must be live (see contains()). Text columns are
+    // returned as copies because the buffer moves on append and compaction.
+    QString path(RowId row) const { return text(m_path[row]).toString(); }
+    QString name(RowId row) const { return text(m_name[row]).toString(); }
+    QString description(RowId row) const { return text(m_description[row]).toString(); }
+    QString category(RowId row) const { return StringPool::instance().string(m_category[row]); }
+    QString sourcePath(RowId row) const;
+    QString sourceLocationKey(RowId row) const { return StringPool::instance().string(m_locationKey[row]); }
+    StringPool::Id categoryId(RowId row) const { return m_category[row]; }
+    StringPool::Id locationKeyId(RowId row) const { return m_locationKey[row]; }
+    ResourceType type(RowId row) const { return static_cast<ResourceType>(m_type[row]); }
+    ResourceTier tier(RowId row) const { return static_cast<ResourceTier>(m_tier[row]); }
+    ResourceAccess access(RowId row) const { return static_cast<ResourceAccess>(m_access[row]); }
+    bool isEnabled(RowId row) const { return m_flags[row] & Enabled; }
+
+    /// Approximate heap size of the columns and the text buffer
+    qsizetype byteSize() const;
+
+private:
+    enum Flag : quint8 { Live = 0x01, Exists = 0x02, Enabled = 0x04, Modified = 0x08, SourceIsPath = 0x10 };
+
+    struct TextRange {
+        quint32 offset = 0;
+        quint32 length = 0;
+    };
+
+    // Valid only until the next append(), update(), remove() or clear()
+    QStringView text(TextRange range) const
+    {
+        return QStringView(m_text).mid(range.offset, range.length);
+    }
+
+    TextRange addText(const QString& value);
+    void store(RowId row, const ResourceItem& item);
+    void compact();
+
+    // One entry per row id, removed rows included
+    std::vector<TextRange> m_path;
+    std::vector<TextRange> m_name;
+    std::vector<TextRange> m_displayName;   // Empty when equal to the name
+    std::vector<TextRange> m_description;
+    std::vector<TextRange> m_sourcePath;    // Empty when equal to the path (SourceIsPath)
+    std::vector<StringPool::Id> m_category;
+    std::vector<StringPool::Id> m_locationKey;
+    std::vector<qint64> m_lastModified;     // ms since epoch (UTC), or kNoDate
+    std::vector<quint8> m_type;
+    std::vector<quint8> m_tier;
+    std::vector<quint8> m_access;
+    std::vector<quint8> m_flags;
+
+    QString m_text;                         // Characters of all text ranges
+    qsizetype m_usedText = 0;               // Characters referenced by live rows
+    qsizetype m_liveRows = 0;
+};
+
+} // namespace resourceInventory
+
+#endif // RESOURCETABLE_H
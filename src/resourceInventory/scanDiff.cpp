@@ -0,0 +1,64 @@
+/**
+ * @file scanDiff.cpp
+ * @brief Implementation of ScanDiff
+ */
+
+#include "scanDiff.hpp"
+#include "fnvHash.hpp"
+
+#include <QDateTime>
+
+#include <utility>
+
+namespace resourceInventory {
+
+quint64 ScanDiff::fingerprint(const ResourceItem& item)
+{
+    using fnv::foldString;
+    using fnv::foldValue;
+
+    quint64 hash = fnv::kOffset64;
+    hash = foldString(hash, item.name());
+    hash = foldString(hash, item.displayName());
+    hash = foldString(hash, item.description());
+    hash = foldString(hash, item.category());
+    hash = foldString(hash, item.sourcePath());
+    hash = foldString(hash, item.sourceLocationKey());
+    hash = foldValue(hash, static_cast<qint32>(item.type()));
+    hash = foldValue(hash, static_cast<qint32>(item.tier()));
+    hash = foldValue(hash, static_cast<qint32>(item.access()));
+    hash = foldValue(hash, item.lastModified().isValid() ? item.lastModified().toMSecsSinceEpoch()
+                                                         : qint64(0));
+    return hash;
+}
+
+void ScanDiff::sortForDiff(QList<ResourceItem>& items)
+{
+    // Fingerprints are computed once per item, not once per comparison
+    QList<QPair<quint64, int>> keys;
+    keys.reserve(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        keys.append({fingerprint(items[i]), i});
+    }
+    std::sort(keys.begin(), keys.end(), [&items](const QPair<quint64, int>& a, const QPair<quint64, int>& b) {
+        const int order = QString::compare(items[a.second].path(), items[b.second].path());
+        return order != 0 ? order < 0 : a.first < b.first;
+    });
+
+    QList<ResourceItem> sorted;
+    sorted.reserve(items.size());
+    for (const auto& key : std::as_const(keys)) {
+        sorted.append(items[key.second]);
+    }
+    items = std::move(sorted);
+}
+
+QList<ScanDiff::Change> ScanDiff::diff(const QList<ResourceItem>& before,
+                                       const QList<ResourceItem>& after)
+{
+    return diff(before, after,
+                [](const ResourceItem& item) { return item.path(); },
+                [](const ResourceItem& item) { return fingerprint(item); });
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,111 @@
+/**
+ * @file scanDiff.hpp
+ * @brief Linear diff of two sorted scan results
+ *
+ * A rescan used to replace the whole inventory model, which loses the
+ * selection and expansion state of every view. ScanDiff compares the
+ * previous and the new results of a scan, both sorted by (path,
+ * fingerprint), in one merge pass and returns a compact change list that
+ * models apply with targeted row inserts, removals and dataChanged.
+ */
+
+#ifndef SCANDIFF_H
+#define SCANDIFF_H
+
+#include "../platformInfo/export.hpp"
+#include "resourceItem.hpp"
+
+#include <QList>
+#include <QString>
+
+#include <algorithm>
+
+namespace resourceInventory {
+
+/**
+ * @brief Sorted-merge diff of scan results
+ *
+ * The generic diff() works on any item list given a path and fingerprint
+ * accessor; the ResourceItem overloads use the item's path() and
+ * fingerprint(). Both inputs must be sorted with the same ordering
+ * (sortForDiff()); the merge is then O(n + m) with no hashing.
+ */
+class PLATFORMINFO_API ScanDiff {
+public:
+    struct Change {
+        enum Kind : quint8 { Added, Removed, Modified };
+
+        Kind kind = Added;
+        int oldIndex = -1;  ///< Index in the previous list (Removed/Modified)
+        int newIndex = -1;  ///< Index in the new list (Added/Modified)
+    };
+
+    /**
+     * @brief Hash of the fields shown by the inventory views
+     *
+     * Two items with the same path and fingerprint are considered equal;
+     * a different fingerprint reports the item as Modified.
+     */
+    static quint64 fingerprint(const ResourceItem& item);
+
+    /// Sort scan results by (path, fingerprint) for diff()
+    static void sortForDiff(QList<ResourceItem>& items);
+
+    /// Diff two ResourceItem lists sorted with sortForDiff()
+    static QList<Change> diff(const QList<ResourceItem>& before,
+                              const QList<ResourceItem>& after);
+
+    /**
+     * @brief Diff two lists sorted by (pathOf, fingerprintOf)
+     * @param before Previous results
+     * @param after New results
+     * @param pathOf Returns the identity (path) of an item
+     * @param fingerprintOf Returns the content fingerprint of an item
+     *
+     * Items with an equal path are paired in order; duplicate paths are
+     * paired by position, surplus ones become Added/Removed.
+     */
+    template <typename T, typename PathFn, typename FingerprintFn>
+    static QList<Change> diff(const QList<T>& before, const QList<T>& after,
+                              PathFn pathOf, FingerprintFn fingerprintOf)
+    {
+        QList<Change> changes;
+        int i = 0;
+        int j = 0;
+        while (i < before.size() && j < after.size()) {
+            const int order = QString::compare(pathOf(before[i]), pathOf(after[j]));
+            if (order < 0) {
+                changes.append({Change::Removed, i++, -1});
+            } else if (order > 0) {
+                changes.append({Change::Added, -1, j++});
+            } else {
+                if (fingerprintOf(before[i]) != fingerprintOf(after[j])) {
+                    changes.append({Change::Modified, i, j});
+                }
+                ++i;
+                ++j;
+            }
+        }
+        for (; i < before.size(); ++i) {
+            changes.append({Change::Removed, i, -1});
+        }
+        for (; j < after.size(); ++j) {
+            changes.append({Change::Added, -1, j});
+        }
+        return changes;
+    }
+
+    /// Sort any list by (pathOf, fingerprintOf) for the generic diff()
+    template <typename T, typename PathFn, typename FingerprintFn>
+    static void sortForDiff(QList<T>& items, PathFn pathOf, FingerprintFn fingerprintOf)
+    {
+        std::sort(items.begin(), items.end(), [&](const T& a, const T& b) {
+            const int order = QString::compare(pathOf(a), pathOf(b));
+            return order != 0 ? order < 0 : fingerprintOf(a) < fingerprintOf(b);
+        });
+    }
+};
+
+} // namespace resourceInventory
+
+#endif // SCANDIFF_H
@@ -0,0 +1,71 @@
+#include "stringPool.hpp"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+namespace resourceInventory {
+
+StringPool& StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+StringPool::StringPool()
+{
+    m_strings.append(QString());
+}
+
+StringPool::Id StringPool::intern(const QString& value, QString* shared)
+{
+    if (value.isEmpty()) {
+        if (shared) shared->clear();
+        return kEmpty;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_ids.constFind(value);
+        if (it != m_ids.constEnd()) {
+            if (shared) *shared = m_strings.at(it.value());
+            return it.value();
+        }
+    }
+
+    // Another thread may have added it since the read lock was released
+    QWriteLocker locker(&m_lock);
+    auto it = m_ids.constFind(value);
+    if (it == m_ids.constEnd()) {
+        it = m_ids.insert(value, Id(m_strings.size()));
+        m_strings.append(value);
+    }
+    if (shared) *shared = m_strings.at(it.value());
+    return it.value();
+}
+
+std::optional<StringPool::Id> StringPool::find(const QString& value) const
+{
+    if (value.isEmpty()) {
+        return kEmpty;
+    }
+    QReadLocker locker(&m_lock);
+    const auto it = m_ids.constFind(value);
+    if (it == m_ids.constEnd()) {
+        return std::nullopt;
+    }
+    return it.value();
+}
+
+QString StringPool::string(Id id) const
+{
+    QReadLocker locker(&m_lock);
+    return id < Id(m_strings.size()) ? m_strings.at(id) : QString();
+}
+
+qsizetype StringPool::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.size();
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,67 @@
+/**
+ * @file stringPool.hpp
+ * @brief Process-wide interning of low-cardinality resource strings
+ *
+ * Categories, location keys, formats ("text/scad.template") and source
+ * tags ("legacy-converted", "vscode-snippet") repeat across every item of
+ * an inventory. Interning them keeps one copy of each
+ * distinct value and gives it a compact id; items store only the id, and
+ * comparisons use ids instead of strings.
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "../platformInfo/export.hpp"
+
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+
+#include <optional>
+
+namespace resourceInventory {
+
+/**
+ * @brief Thread-safe pool of distinct strings with stable 32-bit ids
+ *
+ * Ids are dense, start at 1 and stay valid for the life of the process;
+ * id 0 is the empty string. Entries are never removed, so only fields
+ * with few distinct values belong here (not paths, names or text).
+ * Lookups of known strings take a shared lock only.
+ */
+class PLATFORMINFO_API StringPool {
+public:
+    using Id = quint32;
+    static constexpr Id kEmpty = 0;
+
+    static StringPool& instance();
+
+    /**
+     * @brief Id of a string, added on first use
+     * @param value String to intern
+     * @param shared If given, receives the pooled copy (sharing its data)
+     */
+    Id intern(const QString& value, QString* shared = nullptr);
+
+    /// Id of a string already in the pool, without adding it
+    std::optional<Id> find(const QString& value) const;
+
+    /// String of an id; empty for unknown ids
+    QString string(Id id) const;
+
+    /// Number of distinct strings, the empty string included
+    qsizetype size() const;
+
+private:
+    StringPool();
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Id> m_ids;
+    QList<QString> m_strings;   // Indexed by id
+};
+
+} // namespace resourceInventory
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,463 @@
+/**
+ * @file templatePack.cpp
+ * @brief Implementation of TemplatePack
+ */
+
+#include "templatePack.hpp"
+#include "fnvHash.hpp"
+
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+
+#include <cstring>
+#include <vector>
+
+namespace resourceInventory {
+
+struct TemplatePack::StringRef {
+    quint32 offset;  ///< Into the string table
+    quint32 size;    ///< UTF-8 bytes
+};
+
+struct TemplatePack::Record {
+    StringRef prefix;
+    StringRef name;
+    StringRef category;
+    StringRef description;
+    StringRef body;
+    quint32 scopesBegin;   ///< First entry in the scope table
+    quint32 scopeCount;
+    quint32 prefixHash;
+    quint32 nextInBucket;  ///< Next record with the same bucket, or kNoRecord
+};
+
+namespace {
+
+struct Header {
+    quint32 magic;
+    quint32 formatVersion;
+    quint32 templateCount;
+    quint32 recordsOffset;
+    quint32 scopeCount;
+    quint32 scopesOffset;
+    quint32 bucketCount;   ///< Power of two
+    quint32 bucketsOffset;
+    quint32 stringsSize;
+    quint32 stringsOffset;
+    quint32 fileSize;
+    quint32 reserved;
+};
+
+static_assert(sizeof(Header) == 12 * sizeof(quint32), "Header must not be padded");
+
+constexpr quint32 kNoRecord = 0xFFFFFFFFu;
+
+// Bucket hash of the UTF-8 prefix; part of the file format
+quint32 hashPrefix(const char* data, qsizetype size)
+{
+    return fnv::hash32(data, size_t(size));
+}
+
+inline quint32 le(quint32 value)
+{
+    return qFromLittleEndian(value);
+}
+
+// Every on-disk struct is a sequence of quint32
+template <typename T>
+void toLittleEndian(T& value)
+{
+    static_assert(sizeof(T) % sizeof(quint32) == 0, "Only quint32 fields");
+    auto* words = reinterpret_cast<quint32*>(&value);
+    for (size_t i = 0; i < sizeof(T) / sizeof(quint32); ++i) {
+        words[i] = qToLittleEndian(words[i]);
+    }
+}
+
+template <typename T>
+QByteArray bytesOf(const std::vector<T>& values)
+{
+    return QByteArray(reinterpret_cast<const char*>(values.data()), qsizetype(values.size() * sizeof(T)));
+}
+
+} // namespace
+
+const QString TemplatePack::fileExtension = QStringLiteral(".stpack");
+
+TemplatePack::TemplatePack() = default;
+
+TemplatePack::~TemplatePack()
+{
+    close();
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool TemplatePack::write(const QString& path, const QList<ResourceTemplate>& templates,
+                         QString* errorMessage)
+{
+    auto fail = [&](const QString& message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    // Entries are addressed by prefix (find(), entryPath()): it must be unique
+    QSet<QString> prefixes;
+    for (const ResourceTemplate& tmpl : templates) {
+        if (prefixes.contains(tmpl.prefix())) {
+            return fail(QStringLiteral("Duplicate template prefix \"%1\"").arg(tmpl.prefix()));
+        }
+        prefixes.insert(tmpl.prefix());
+    }
+
+    const auto count = quint32(templates.size());
+    quint32 bucketCount = 1;
+    while (bucketCount < count) {
+        bucketCount <<= 1;
+    }
+
+    // Identical strings (categories, scopes, descriptions) are stored once
+    QByteArray strings;
+    QHash<QByteArray, StringRef> interned;
+    auto addString = [&](const QString& value) {
+        const QByteArray utf8 = value.toUtf8();
+        const auto it = interned.constFind(utf8);
+        if (it != interned.cend()) {
+            return *it;
+        }
+        const StringRef ref{quint32(strings.size()), quint32(utf8.size())};
+        strings.append(utf8);
+        interned.insert(utf8, ref);
+        return ref;
+    };
+
+    std::vector<Record> records(count);
+    std::vector<StringRef> scopes;
+    for (quint32 i = 0; i < count; ++i) {
+        const ResourceTemplate& tmpl = templates[int(i)];
+        Record& rec = records[i];
+        const QByteArray prefixUtf8 = tmpl.prefix().toUtf8();
+        rec.prefix = addString(tmpl.prefix());
+        rec.name = addString(tmpl.name());
+        rec.category = addString(tmpl.category());
+        rec.description = addString(tmpl.description());
+        rec.body = addString(tmpl.body());
+        rec.scopesBegin = quint32(scopes.size());
+        for (const QString& scope : tmpl.scopes()) {
+            scopes.push_back(addString(scope));
+        }
+        rec.scopeCount = quint32(scopes.size()) - rec.scopesBegin;
+        rec.prefixHash = hashPrefix(prefixUtf8.constData(), prefixUtf8.size());
+    }
+
+    // Chains are built back to front so a lookup finds the first of
+    // several templates sharing a prefix
+    std::vector<quint32> buckets(bucketCount, kNoRecord);
+    for (quint32 i = count; i-- > 0;) {
+        const quint32 bucket = records[i].prefixHash & (bucketCount - 1);
+        records[i].nextInBucket = buckets[bucket];
+        buckets[bucket] = i;
+    }
+
+    while (strings.size() % 4 != 0) {
+        strings.append('\0');
+    }
+
+    Header header{};
+    header.magic = kMagic;
+    header.formatVersion = kFormatVersion;
+    header.templateCount = count;
+    header.recordsOffset = quint32(sizeof(Header));
+    header.scopeCount = quint32(scopes.size());
+    header.scopesOffset = header.recordsOffset + count * quint32(sizeof(Record));
+    header.bucketCount = bucketCount;
+    header.bucketsOffset = header.scopesOffset + header.scopeCount * quint32(sizeof(StringRef));
+    header.stringsSize = quint32(strings.size());
+    header.stringsOffset = header.bucketsOffset + bucketCount * quint32(sizeof(quint32));
+
+    const quint64 fileSize = quint64(header.stringsOffset) + quint64(strings.size());
+    if (fileSize > quint64(kNoRecord) || quint64(count) * sizeof(Record) > quint64(kNoRecord)) {
+        return fail(QStringLiteral("Template pack too large: %1").arg(path));
+    }
+    header.fileSize = quint32(fileSize);
+
+    toLittleEndian(header);
+    for (Record& rec : records) {
+        toLittleEndian(rec);
+    }
+    for (StringRef& ref : scopes) {
+        toLittleEndian(ref);
+    }
+    for (quint32& bucket : buckets) {
+        bucket = qToLittleEndian(bucket);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(QStringLiteral("Cannot write %1: %2").arg(path, file.errorString()));
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(bytesOf(records));
+    file.write(bytesOf(scopes));
+    file.write(bytesOf(buckets));
+    file.write(strings);
+    if (!file.commit()) {
+        return fail(QStringLiteral("Cannot write %1: %2").arg(path, file.errorString()));
+    }
+    return true;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool TemplatePack::open(const QString& path, QString* errorMessage)
+{
+    close();
+
+    m_file = std::make_unique<QFile>(path);
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot open %1: %2").arg(path, m_file->errorString());
+        }
+        m_file.reset();
+        return false;
+    }
+
+    m_size = m_file->size();
+    m_data = m_size >= qint64(sizeof(Header)) ? m_file->map(0, m_size) : nullptr;
+    m_path = path;
+    if (!validate(errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TemplatePack::close()
+{
+    if (m_file && m_data) {
+        m_file->unmap(const_cast<uchar*>(m_data));
+    }
+    m_file.reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_count = 0;
+    m_records = nullptr;
+    m_scopes = nullptr;
+    m_scopeCount = 0;
+    m_buckets = nullptr;
+    m_bucketCount = 0;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+    m_path.clear();
+}
+
+bool TemplatePack::validate(QString* errorMessage)
+{
+    auto fail = [&](const char* reason) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Invalid template pack %1: %2")
+                                .arg(m_path, QLatin1String(reason));
+        }
+        return false;
+    };
+
+    if (!m_data) {
+        return fail("file too small or cannot be mapped");
+    }
+
+    Header header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (le(header.magic) != kMagic) {
+        return fail("bad magic");
+    }
+    if (le(header.formatVersion) != kFormatVersion) {
+        return fail("unsupported format version");
+    }
+    if (quint64(le(header.fileSize)) != quint64(m_size)) {
+        return fail("truncated");
+    }
+
+    const quint32 count = le(header.templateCount);
+    const quint32 scopeCount = le(header.scopeCount);
+    const quint32 bucketCount = le(header.bucketCount);
+    const quint32 stringsSize = le(header.stringsSize);
+
+    // Every section must be aligned and lie inside the file
+    auto inFile = [&](quint32 offset, quint64 bytes) {
+        return offset % 4 == 0 && quint64(offset) + bytes <= quint64(m_size);
+    };
+    if (!inFile(le(header.recordsOffset), quint64(count) * sizeof(Record))
+        || !inFile(le(header.scopesOffset), quint64(scopeCount) * sizeof(StringRef))
+        || !inFile(le(header.bucketsOffset), quint64(bucketCount) * sizeof(quint32))
+        || !inFile(le(header.stringsOffset), stringsSize)) {
+        return fail("section out of range");
+    }
+    if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0) {
+        return fail("bad bucket count");
+    }
+
+    m_count = int(count);
+    m_records = reinterpret_cast<const Record*>(m_data + le(header.recordsOffset));
+    m_scopeCount = scopeCount;
+    m_scopes = reinterpret_cast<const StringRef*>(m_data + le(header.scopesOffset));
+    m_bucketCount = bucketCount;
+    m_buckets = reinterpret_cast<const quint32*>(m_data + le(header.bucketsOffset));
+    m_stringsSize = stringsSize;
+    m_strings = reinterpret_cast<const char*>(m_data + le(header.stringsOffset));
+
+    // Checked once, so accessors need no bounds checks
+    auto validString = [&](const StringRef& ref) {
+        return quint64(le(ref.offset)) + le(ref.size) <= quint64(m_stringsSize);
+    };
+    for (quint32 i = 0; i < count; ++i) {
+        const Record& rec = m_records[i];
+        if (!validString(rec.prefix) || !validString(rec.name) || !validString(rec.category)
+            || !validString(rec.description) || !validString(rec.body)) {
+            return fail("string out of range");
+        }
+        if (quint64(le(rec.scopesBegin)) + le(rec.scopeCount) > m_scopeCount) {
+            return fail("scope range out of range");
+        }
+        const quint32 next = le(rec.nextInBucket);
+        if (next != kNoRecord && next >= count) {
+            return fail("bad hash chain");
+        }
+    }
+    for (quint32 i = 0; i < m_scopeCount; ++i) {
+        if (!validString(m_scopes[i])) {
+            return fail("scope string out of range");
+        }
+    }
+    for (quint32 i = 0; i < m_bucketCount; ++i) {
+        const quint32 first = le(m_buckets[i]);
+        if (first != kNoRecord && first >= count) {
+            return fail("bad hash bucket");
+        }
+    }
+    return true;
+}
+
+const TemplatePack::Record* TemplatePack::record(int index) const
+{
+    return index >= 0 && index < m_count ? &m_records[index] : nullptr;
+}
+
+QString TemplatePack::string(const StringRef& ref) const
+{
+    return QString::fromUtf8(m_strings + le(ref.offset), qsizetype(le(ref.size)));
+}
+
+int TemplatePack::find(const QString& prefix) const
+{
+    if (!isOpen()) {
+        return -1;
+    }
+    const QByteArray utf8 = prefix.toUtf8();
+    const quint32 hash = hashPrefix(utf8.constData(), utf8.size());
+
+    // Compared as raw bytes in the mapping; the chain length is bounded by
+    // the record count so a corrupt cycle cannot loop forever
+    quint32 index = le(m_buckets[hash & (m_bucketCount - 1)]);
+    for (int steps = 0; index != kNoRecord && steps < m_count; ++steps) {
+        const Record& rec = m_records[index];
+        if (le(rec.prefixHash) == hash && le(rec.prefix.size) == quint32(utf8.size())
+            && std::memcmp(m_strings + le(rec.prefix.offset), utf8.constData(), size_t(utf8.size())) == 0) {
+            return int(index);
+        }
+        index = le(rec.nextInBucket);
+    }
+    return -1;
+}
+
+QString TemplatePack::prefix(int index) const
+{
+    const Record* rec = record(index);
+    return rec ? string(rec->prefix) : QString();
+}
+
+QString TemplatePack::name(int index) const
+{
+    const Record* rec = record(index);
+    return rec ? string(rec->name) : QString();
+}
+
+QString TemplatePack::category(int index) const
+{
+    const Record* rec = record(index);
+    return rec ? string(rec->category) : QString();
+}
+
+QString TemplatePack::description(int index) const
+{
+    const Record* rec = record(index);
+    return rec ? string(rec->description) : QString();
+}
+
+QString TemplatePack::body(int index) const
+{
+    const Record* rec = record(index);
+    return rec ? string(rec->body) : QString();
+}
+
+QStringList TemplatePack::scopes(int index) const
+{
+    QStringList result;
+    const Record* rec = record(index);
+    if (!rec) {
+        return result;
+    }
+    const quint32 begin = le(rec->scopesBegin);
+    const quint32 count = le(rec->scopeCount);
+    result.reserve(int(count));
+    for (quint32 i = 0; i < count; ++i) {
+        result.append(string(m_scopes[begin + i]));
+    }
+    return result;
+}
+
+ResourceTemplate TemplatePack::templateAt(int index) const
+{
+    ResourceTemplate tmpl;
+    if (!record(index)) {
+        return tmpl;
+    }
+    const QString templatePrefix = prefix(index);
+    tmpl.setPath(entryPath(m_path, templatePrefix));
+    tmpl.setPrefix(templatePrefix);
+    tmpl.setName(name(index));
+    tmpl.setDisplayName(tmpl.name());
+    tmpl.setCategory(category(index));
+    tmpl.setDescription(description(index));
+    tmpl.setBody(body(index));
+    tmpl.setScopes(scopes(index));
+    tmpl.setFormat(QStringLiteral("text/scad.template"));
+    tmpl.setType(ResourceType::Templates);
+    return tmpl;
+}
+
+QString TemplatePack::entryPath(const QString& packPath, const QString& prefix)
+{
+    return packPath + QLatin1Char('#') + prefix;
+}
+
+bool TemplatePack::splitEntryPath(const QString& entryPath, QString& packPath, QString& prefix)
+{
+    const qsizetype marker = entryPath.indexOf(fileExtension + QLatin1Char('#'));
+    if (marker < 0) {
+        return false;
+    }
+    packPath = entryPath.left(marker + fileExtension.size());
+    prefix = entryPath.mid(marker + fileExtension.size() + 1);
+    return true;
+}
+
+} // namespace resourceInventory
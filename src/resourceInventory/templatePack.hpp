@@ -0,0 +1,144 @@
+/**
+ * @file templatePack.hpp
+ * @brief Compiled, memory-mappable template packs (.stpack)
+ *
+ * Large curated template sets stored as one JSON file per template cost
+ * one open and one parse per template at every scan. A pack holds the
+ * whole set in a single binary file: a header, one fixed-size record per
+ * template, a hash index by prefix and a string table. The file is mapped
+ * and queried in place - looking up a prefix or listing names decodes only
+ * the strings that are asked for, and nothing is parsed.
+ *
+ * Packs are produced by the template_pack_compiler tool and picked up by
+ * TemplateScanner from the templates/ folder of a location.
+ *
+ * A mapping faults (SIGBUS) if its file is truncated while mapped, so
+ * packs are treated as immutable: write() replaces a pack atomically
+ * (a new file renamed over the old one), and readers that still map the
+ * old pack keep its data. Packs must not be rewritten in place.
+ */
+
+#ifndef TEMPLATEPACK_H
+#define TEMPLATEPACK_H
+
+#include "../platformInfo/export.hpp"
+#include "resourceItem.hpp"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+class QFile;
+
+namespace resourceInventory {
+
+/**
+ * @brief Reader/writer for .stpack template packs
+ *
+ * Layout (all integers little-endian quint32, every section 4-byte aligned):
+ * @code
+ *   Header
+ *   Record[templateCount]    prefix/name/category/description/body refs,
+ *                            scope range, prefix hash, next-in-bucket
+ *   StringRef[scopeCount]    scopes of all records, contiguous per record
+ *   quint32[bucketCount]     first record of each prefix hash bucket
+ *   char[stringsSize]        UTF-8 string table (identical strings shared)
+ * @endcode
+ *
+ * Usage:
+ * @code
+ *   TemplatePack pack;
+ *   if (pack.open(path)) {
+ *       const int index = pack.find(QStringLiteral("union"));
+ *       if (index >= 0) {
+ *           ResourceTemplate tmpl = pack.templateAt(index);
+ *       }
+ *   }
+ * @endcode
+ */
+class PLATFORMINFO_API TemplatePack {
+public:
+    static const QString fileExtension;  ///< ".stpack"
+
+    static constexpr quint32 kMagic = 0x4B505453;  // "STPK"
+    static constexpr quint32 kFormatVersion = 1;
+
+    TemplatePack();
+    ~TemplatePack();
+
+    TemplatePack(const TemplatePack&) = delete;
+    TemplatePack& operator=(const TemplatePack&) = delete;
+
+    /**
+     * @brief Compile templates into a pack file
+     * @param path Output file (written atomically)
+     * @param templates Templates to store; prefix, name, category,
+     *        description, body and scopes are kept
+     * @param errorMessage Receives a description on failure (optional)
+     * @return false on a write error or if two templates share a prefix
+     */
+    static bool write(const QString& path, const QList<ResourceTemplate>& templates,
+                      QString* errorMessage = nullptr);
+
+    /**
+     * @brief Map a pack file and validate its structure
+     *
+     * All offsets are checked once here, so the accessors below never read
+     * outside the mapping. The pack stays mapped until close(); see the
+     * file comment on replacing packs.
+     */
+    bool open(const QString& path, QString* errorMessage = nullptr);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    QString path() const { return m_path; }
+
+    /// Number of templates in the pack
+    int count() const { return m_count; }
+
+    /// Index of the template with this prefix, or -1 (hash lookup)
+    int find(const QString& prefix) const;
+
+    QString prefix(int index) const;
+    QString name(int index) const;
+    QString category(int index) const;
+    QString description(int index) const;
+    QString body(int index) const;
+    QStringList scopes(int index) const;
+
+    /// All stored fields of one template; path is entryPath() of it
+    ResourceTemplate templateAt(int index) const;
+
+    /// Path identifying a template inside a pack: "<packPath>#<prefix>"
+    static QString entryPath(const QString& packPath, const QString& prefix);
+
+    /// Split an entryPath(); false if the path does not point into a pack
+    static bool splitEntryPath(const QString& entryPath, QString& packPath, QString& prefix);
+
+private:
+    struct StringRef;
+    struct Record;
+
+    const Record* record(int index) const;
+    QString string(const StringRef& ref) const;
+    bool validate(QString* errorMessage);
+
+    QString m_path;
+    std::unique_ptr<QFile> m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    int m_count = 0;
+    const Record* m_records = nullptr;
+    const StringRef* m_scopes = nullptr;
+    quint32 m_scopeCount = 0;
+    const quint32* m_buckets = nullptr;
+    quint32 m_bucketCount = 0;
+    const char* m_strings = nullptr;
+    quint32 m_stringsSize = 0;
+};
+
+} // namespace resourceInventory
+
+#endif // TEMPLATEPACK_H
@@ -70,7 +70,7 @@ const QMap<ResourceType, ResourceTypeInfo> ResourceTypeInfo::s_resourceTypes = {
      ResourceTypeInfo(ResourceType::Templates, QStringLiteral("templates"),
                       QStringLiteral("Template Files"),
                       {}, // no sub-resources
-                      {QStringLiteral(".json")}, {})},
+                      {QStringLiteral(".json"), QStringLiteral(".scad")}, {})},
 
     {ResourceType::Libraries,
      ResourceTypeInfo(
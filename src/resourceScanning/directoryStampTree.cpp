@@ -0,0 +1,176 @@
+#include "directoryStampTree.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QScopeGuard>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace resourceInventory {
+
+namespace {
+
+// Own stamp of a directory: mtime and inode, from a single stat. identity
+// names the directory itself, whatever links lead to it.
+bool statDirectory(const QString& path, qint64& mtime, quint64& inode, QString& identity)
+{
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+#if defined(Q_OS_DARWIN)
+    const long nsec = st.st_mtimespec.tv_nsec;
+#else
+    const long nsec = st.st_mtim.tv_nsec;
+#endif
+    mtime = qint64(st.st_mtime) * 1000 + nsec / 1000000;
+    inode = static_cast<quint64>(st.st_ino);
+    identity = QString::number(quint64(st.st_dev)) + QLatin1Char(':') + QString::number(inode);
+    return true;
+#else
+    const QFileInfo fi(path);
+    if (!fi.isDir()) {
+        return false;
+    }
+    mtime = fi.lastModified().toMSecsSinceEpoch();
+    inode = 0;
+    identity = fi.isSymLink() ? fi.canonicalFilePath() : fi.absoluteFilePath();
+    return true;
+#endif
+}
+
+QString parentPath(const QString& path)
+{
+    const int slash = path.lastIndexOf(QLatin1Char('/'));
+    return slash > 0 ? path.left(slash) : QString();
+}
+
+} // namespace
+
+// ============================================================================
+// DirectoryStampTree
+// ============================================================================
+
+DirectoryStampTree::Changes DirectoryStampTree::update(const QString& rootPath, UpdateMode mode)
+{
+    Changes changes;
+    const QString root = QDir::cleanPath(rootPath);
+    QSet<QString> ancestors;
+    if (!visit(root, mode, ancestors, changes)) {
+        removeSubtree(root, changes);
+    }
+    return changes;
+}
+
+bool DirectoryStampTree::visit(const QString& path, UpdateMode mode, QSet<QString>& ancestors,
+                               Changes& changes)
+{
+    qint64 mtime = 0;
+    quint64 inode = 0;
+    QString identity;
+    if (!statDirectory(path, mtime, inode, identity) || ancestors.contains(identity)) {
+        return false;  // Gone, or a link back to an ancestor
+    }
+    ancestors.insert(identity);
+    const auto leave = qScopeGuard([&ancestors, &identity] { ancestors.remove(identity); });
+
+    const auto it = m_nodes.constFind(path);
+    const bool known = it != m_nodes.cend();
+    const bool selfChanged = !known || mode == UpdateMode::Full || it->dirty
+                             || it->stamp.mtime != mtime || it->stamp.inode != inode;
+    // Copied: recursion below may rehash m_nodes
+    const QStringList previousChildren = known ? it->children : QStringList();
+
+    if (!selfChanged) {
+        // Entries are unchanged; stat the known subdirectories only
+        QStringList remaining;
+        for (const QString& child : previousChildren) {
+            const QString childPath = path + QLatin1Char('/') + child;
+            if (!visit(childPath, mode, ancestors, changes)) {
+                removeSubtree(childPath, changes);
+                continue;
+            }
+            remaining.append(child);
+        }
+
+        m_nodes[path].children = remaining;
+        return true;
+    }
+
+    // Own stamp changed, flagged, forced or first visit: relist this directory
+    const QDir dir(path);
+    const QStringList entries = dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::Name);
+    QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString& skipped : m_skippedNames) {
+        subdirs.removeAll(skipped);
+    }
+
+    for (const QString& old : previousChildren) {
+        if (!subdirs.contains(old)) {
+            removeSubtree(path + QLatin1Char('/') + old, changes);
+        }
+    }
+
+    QStringList children;
+    for (const QString& sub : subdirs) {
+        if (visit(path + QLatin1Char('/') + sub, mode, ancestors, changes)) {
+            children.append(sub);
+        }
+    }
+
+    Node& node = m_nodes[path];
+    node.stamp.mtime = mtime;
+    node.stamp.inode = inode;
+    node.stamp.childCount = static_cast<quint32>(entries.size());
+    node.children = children;
+    node.dirty = false;
+
+    changes.changed.append(path);
+    return true;
+}
+
+void DirectoryStampTree::removeSubtree(const QString& path, Changes& changes)
+{
+    const auto it = m_nodes.constFind(path);
+    if (it == m_nodes.cend()) {
+        return;
+    }
+    const QStringList children = it->children;
+    for (const QString& child : children) {
+        removeSubtree(path + QLatin1Char('/') + child, changes);
+    }
+    m_nodes.remove(path);
+    changes.removed.append(path);
+}
+
+void DirectoryStampTree::markDirty(const QString& dirPath)
+{
+    QString path = QDir::cleanPath(dirPath);
+
+    // Unknown (new) directory: its nearest known ancestor must be relisted
+    while (!path.isEmpty() && !m_nodes.contains(path)) {
+        path = parentPath(path);
+    }
+    if (path.isEmpty()) {
+        return;
+    }
+
+    m_nodes[path].dirty = true;
+}
+
+bool DirectoryStampTree::contains(const QString& dirPath) const
+{
+    return m_nodes.contains(QDir::cleanPath(dirPath));
+}
+
+DirectoryStampTree::Stamp DirectoryStampTree::stamp(const QString& dirPath) const
+{
+    return m_nodes.value(QDir::cleanPath(dirPath)).stamp;
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,101 @@
+#ifndef DIRECTORYSTAMPTREE_HPP
+#define DIRECTORYSTAMPTREE_HPP
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "../resourceScanning/export.hpp"
+
+namespace resourceInventory {
+
+/**
+ * @brief Tree of per-directory stamps for incremental rescans
+ *
+ * Every directory below a scanned root is remembered with its own stamp
+ * (mtime, inode) and the number of its entries. An incremental update()
+ * stats every known directory - one stat each, no listing - and lists
+ * again only those whose own mtime/inode changed or that were flagged
+ * dirty (e.g. by a QFileSystemWatcher). Listing and rescanning, the
+ * expensive part, is thus proportional to the number of changed
+ * directories, while the stats stay proportional to the tree.
+ *
+ * A directory's mtime does not change when something below its direct
+ * entries changes, so no stamp of an ancestor can tell that a subtree is
+ * unchanged; pruning unchanged subtrees without statting them would need
+ * watcher events for every directory, which markDirty() already covers.
+ *
+ * Symbolic links to directories are followed, but a directory that is
+ * already one of its own ancestors (e.g. examples/loop -> ..) is skipped.
+ * A file edited in place does not bump its directory's mtime; such edits
+ * are seen through markDirty() or a full update.
+ */
+class RESOURCESCANNING_API DirectoryStampTree
+{
+public:
+    struct Stamp {
+        qint64 mtime = 0;           ///< Modification time in ms since epoch
+        quint64 inode = 0;          ///< Inode/file id (0 where unavailable)
+        quint32 childCount = 0;     ///< Number of entries in the directory
+    };
+
+    struct Changes {
+        QStringList changed;        ///< Directories that were (re)listed
+        QStringList removed;        ///< Directories that no longer exist
+
+        bool isEmpty() const { return changed.isEmpty() && removed.isEmpty(); }
+    };
+
+    enum class UpdateMode {
+        Incremental,                ///< Relist changed and dirty directories
+        Full                        ///< Relist every directory (explicit refresh)
+    };
+
+    /**
+     * @brief Refresh the stamps below rootPath
+     * @return Directories whose contents must be rescanned or dropped
+     *
+     * The first update of a root, and every Full update, reports every
+     * directory as changed.
+     */
+    Changes update(const QString& rootPath, UpdateMode mode = UpdateMode::Incremental);
+
+    /**
+     * @brief Flag a directory whose contents changed without an mtime bump
+     *
+     * The directory is listed again on the next update(). An unknown
+     * directory flags its nearest known ancestor instead.
+     */
+    void markDirty(const QString& dirPath);
+
+    /// Names of subdirectories that are never descended (e.g. ".git")
+    void setSkippedNames(const QStringList& names) { m_skippedNames = names; }
+
+    bool contains(const QString& dirPath) const;
+    Stamp stamp(const QString& dirPath) const;
+
+    /// All directories currently tracked (e.g. to register with a watcher)
+    QStringList directories() const { return m_nodes.keys(); }
+
+    void clear() { m_nodes.clear(); }
+
+private:
+    struct Node {
+        Stamp stamp;
+        QStringList children;       ///< Subdirectory names, sorted
+        bool dirty = false;         ///< Relist on next update
+    };
+
+    // ancestors: identities of the directories on the current path, to
+    // break symlink loops
+    bool visit(const QString& path, UpdateMode mode, QSet<QString>& ancestors, Changes& changes);
+    void removeSubtree(const QString& path, Changes& changes);
+
+    QHash<QString, Node> m_nodes;
+    QStringList m_skippedNames;
+};
+
+} // namespace resourceInventory
+
+#endif // DIRECTORYSTAMPTREE_HPP
@@ -0,0 +1,92 @@
+#include "exampleDirManifest.hpp"
+#include "../jsonreader/JsonReader.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QDebug>
+
+namespace resourceInventory {
+
+const QString ExampleDirManifest::fileName = QStringLiteral("example-dir.json");
+
+static QStringList toStringList(const QJsonArray& array)
+{
+    QStringList result;
+    result.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        if (value.isString() && !value.toString().isEmpty()) {
+            result.append(value.toString());
+        }
+    }
+    return result;
+}
+
+bool ExampleDirManifest::load(const QString& dirPath, ExampleDirManifest& manifest)
+{
+    const QString manifestPath = QDir(dirPath).filePath(fileName);
+    if (!QFileInfo::exists(manifestPath)) {
+        return false;
+    }
+
+    QJsonObject obj;
+    JsonErrorInfo error;
+    if (!JsonReader::readObject(manifestPath.toStdString(), obj, error)) {
+        qWarning() << "ExampleDirManifest: Ignoring invalid manifest"
+                   << QString::fromStdString(error.formatError());
+        return false;
+    }
+
+    manifest = ExampleDirManifest();
+    manifest.sort = obj.value(QStringLiteral("sort")).toInt();
+    manifest.name = obj.value(QStringLiteral("name")).toString();
+    manifest.tooltip = obj.value(QStringLiteral("tooltip")).toString();
+
+    const QJsonValue categories = obj.value(QStringLiteral("categories"));
+    if (categories.isArray()) {
+        manifest.hasCategories = true;
+        manifest.categories = toStringList(categories.toArray());
+    }
+
+    const QJsonValue scripts = obj.value(QStringLiteral("scripts"));
+    if (scripts.isArray()) {
+        manifest.hasScripts = true;
+        for (const QJsonValue& entry : scripts.toArray()) {
+            Script script;
+            if (entry.isString()) {
+                script.file = entry.toString();
+            } else if (entry.isObject()) {
+                const QJsonObject scriptObj = entry.toObject();
+                script.file = scriptObj.value(QStringLiteral("file")).toString();
+                script.attachments = toStringList(scriptObj.value(QStringLiteral("attachments")).toArray());
+            }
+            if (!script.file.isEmpty()) {
+                manifest.scripts.append(script);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ExampleDirManifest::isFresh(const QString& dirPath)
+{
+    const QFileInfo dirInfo(dirPath);
+    const QFileInfo manifestInfo(QDir(dirPath).filePath(fileName));
+    if (!dirInfo.isDir() || !manifestInfo.isFile()) {
+        return false;
+    }
+    return manifestInfo.lastModified() >= dirInfo.lastModified();
+}
+
+bool ExampleDirManifest::loadTrusted(const QString& dirPath, ExampleDirManifest& manifest)
+{
+    if (!isFresh(dirPath)) {
+        return false;
+    }
+    return load(dirPath, manifest) && manifest.hasScripts;
+}
+
+} // namespace resourceInventory
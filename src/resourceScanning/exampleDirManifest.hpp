@@ -0,0 +1,76 @@
+#ifndef EXAMPLEDIRMANIFEST_HPP
+#define EXAMPLEDIRMANIFEST_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "../resourceScanning/export.hpp"
+
+namespace resourceInventory {
+
+/**
+ * @brief Per-directory manifest for example/test folders (example-dir.json)
+ *
+ * Curated example folders carry an example-dir.json describing the folder
+ * (sort, name, tooltip). The manifest may additionally list the folder's
+ * contents so the scanner does not have to enumerate and filter it:
+ *
+ * {
+ *   "sort": 900,
+ *   "name": "Examples",
+ *   "tooltip": "Top Level",
+ *   "categories": ["Basics", "Functions"],          // subfolders to descend
+ *   "scripts": [
+ *     "logo.scad",                                   // no attachments
+ *     { "file": "cube.scad",
+ *       "attachments": ["cube.png", "cube/data.dat"] }
+ *   ]
+ * }
+ *
+ * Paths are relative to the directory holding the manifest. A manifest is
+ * only trusted when it lists "scripts" and is at least as new as its
+ * directory; adding or removing a file bumps the directory mtime, which
+ * makes the manifest stale and the scanner falls back to enumeration.
+ */
+class RESOURCESCANNING_API ExampleDirManifest
+{
+public:
+    struct Script {
+        QString file;               ///< Script file name relative to the directory
+        QStringList attachments;    ///< Attachment paths relative to the directory
+    };
+
+    static const QString fileName;  ///< "example-dir.json"
+
+    int sort = 0;
+    QString name;
+    QString tooltip;
+    QList<Script> scripts;
+    QStringList categories;
+    bool hasScripts = false;        ///< "scripts" key present
+    bool hasCategories = false;     ///< "categories" key present
+
+    /**
+     * @brief Read and parse the manifest of a directory
+     * @param dirPath Directory that may contain example-dir.json
+     * @param manifest Receives the parsed manifest
+     * @return false if there is no manifest or it is not valid JSON
+     */
+    static bool load(const QString& dirPath, ExampleDirManifest& manifest);
+
+    /**
+     * @brief Load the manifest only if it can replace a directory listing
+     * @return true if the manifest lists scripts and is not older than dirPath
+     */
+    static bool loadTrusted(const QString& dirPath, ExampleDirManifest& manifest);
+
+    /**
+     * @brief Check whether the manifest mtime is >= the directory mtime
+     */
+    static bool isFresh(const QString& dirPath);
+};
+
+} // namespace resourceInventory
+
+#endif // EXAMPLEDIRMANIFEST_HPP
@@ -0,0 +1,131 @@
+#ifndef LRUBYTECACHE_HPP
+#define LRUBYTECACHE_HPP
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <list>
+#include <optional>
+#include <utility>
+
+namespace resourceInventory {
+
+/**
+ * @brief Least-recently-used cache bounded by the estimated bytes of its values
+ *
+ * The storage behind TemplateContentCache and ParsedTemplateCache. Values
+ * are meant to be cheap to copy (shared pointers); the caller estimates
+ * each value's size when inserting it. Once the total exceeds the byte
+ * budget the least recently used entries are dropped; the newest entry
+ * stays even if it alone exceeds the budget.
+ *
+ * Thread-safe. Callers look up with find(), load outside the lock on a
+ * miss and insert() the result; two threads missing the same key may
+ * both load it, and the first insert wins.
+ */
+template <typename Key, typename Value>
+class LruByteCache
+{
+public:
+    explicit LruByteCache(qint64 byteBudget) : m_byteBudget(byteBudget) {}
+
+    /// Cached value moved to the front, or nothing (counted as a miss)
+    std::optional<Value> find(const Key& key)
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_index.constFind(key);
+        if (it == m_index.constEnd()) {
+            ++m_misses;
+            return std::nullopt;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it.value());
+        ++m_hits;
+        return it.value()->value;
+    }
+
+    /// Add a value unless another thread did; returns the cached one
+    Value insert(const Key& key, Value value, qint64 bytes)
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_index.constFind(key);
+        if (it != m_index.constEnd()) {
+            return it.value()->value;  // Loaded by another thread meanwhile
+        }
+        m_entries.push_front({key, std::move(value), bytes});
+        m_index.insert(key, m_entries.begin());
+        m_bytesUsed += bytes;
+        Value added = m_entries.front().value;
+        evict();
+        return added;
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_entries.clear();
+        m_index.clear();
+        m_bytesUsed = 0;
+    }
+
+    qint64 byteBudget() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_byteBudget;
+    }
+
+    void setByteBudget(qint64 bytes)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_byteBudget = qMax<qint64>(0, bytes);
+        evict();
+    }
+
+    qint64 bytesUsed() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_bytesUsed;
+    }
+
+    qint64 hits() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_hits;
+    }
+
+    qint64 misses() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_misses;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        qint64 bytes = 0;
+    };
+
+    // Drop least recently used entries beyond the budget; lock held
+    void evict()
+    {
+        while (m_bytesUsed > m_byteBudget && m_entries.size() > 1) {
+            const Entry& last = m_entries.back();
+            m_bytesUsed -= last.bytes;
+            m_index.remove(last.key);
+            m_entries.pop_back();
+        }
+    }
+
+    mutable QMutex m_mutex;
+    std::list<Entry> m_entries;     // Most recently used first
+    QHash<Key, typename std::list<Entry>::iterator> m_index;
+    qint64 m_byteBudget;
+    qint64 m_bytesUsed = 0;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+};
+
+} // namespace resourceInventory
+
+#endif // LRUBYTECACHE_HPP
@@ -0,0 +1,138 @@
+#include "parsedTemplateCache.hpp"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace resourceInventory {
+
+namespace {
+
+// Rough in-memory size of a parsed document: the Qt value tree takes about
+// twice the UTF-8 source, plus a fixed overhead per entry
+qint64 estimatedBytes(const QByteArray& content)
+{
+    return 2 * qint64(content.size()) + 256;
+}
+
+} // namespace
+
+ParsedTemplateCache::ParsedTemplateCache()
+    : m_cache(32 * 1024 * 1024)
+{
+}
+
+ParsedTemplateCache& ParsedTemplateCache::instance()
+{
+    static ParsedTemplateCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ParsedTemplateCache::Parsed> ParsedTemplateCache::get(const QString& path)
+{
+    const QFileInfo info(path);
+    return get(Key{path, info.exists() ? info.size() : -1, info.lastModified().toMSecsSinceEpoch()});
+}
+
+const QStringList& ParsedTemplateCache::listingKeys()
+{
+    static const QStringList keys{QStringLiteral("name"), QStringLiteral("category")};
+    return keys;
+}
+
+std::shared_ptr<const ParsedTemplateCache::Parsed> ParsedTemplateCache::get(const Key& key)
+{
+    if (const auto cached = m_cache.find({key, false})) {
+        return cached->parsed;
+    }
+
+    auto parsed = std::make_shared<Parsed>();
+    qint64 bytes = 256;
+    const auto file = JsonFileContent::open(key.path.toStdString(), parsed->error);
+    if (file) {
+        parsed->read = true;
+        JsonReader::parseContent(file->data(), parsed->document, parsed->error);
+        parsed->error.filename = key.path.toStdString();
+        bytes = estimatedBytes(file->data());
+        if (file->data().size() != key.size) {
+            return parsed;  // Changed since the fingerprint was taken: do not cache
+        }
+    }
+
+    return m_cache.insert({key, false}, {parsed, nullptr}, bytes).parsed;
+}
+
+std::shared_ptr<const ParsedTemplateCache::Listing> ParsedTemplateCache::listing(const QString& path)
+{
+    const QFileInfo info(path);
+    return listing(Key{path, info.exists() ? info.size() : -1, info.lastModified().toMSecsSinceEpoch()});
+}
+
+std::shared_ptr<const ParsedTemplateCache::Listing> ParsedTemplateCache::listing(const Key& key)
+{
+    if (auto cached = findListing(key)) {
+        return cached;
+    }
+
+    JsonErrorInfo error;
+    const auto file = JsonFileContent::open(key.path.toStdString(), error);
+    if (file) {
+        return listing(key, file->data());
+    }
+    auto listing = std::make_shared<Listing>();
+    listing->error = error;
+
+    return m_cache.insert({key, true}, {nullptr, listing}, 256).listing;
+}
+
+std::shared_ptr<const ParsedTemplateCache::Listing> ParsedTemplateCache::listing(const Key& key,
+                                                                                 const QByteArray& content)
+{
+    auto listing = std::make_shared<Listing>();
+    listing->read = true;
+    JsonReader::readMembers(content, listingKeys(), listing->members, listing->error);
+    listing->error.filename = key.path.toStdString();
+    if (content.size() != key.size) {
+        return listing;  // Changed since the fingerprint was taken: do not cache
+    }
+
+    // Members are short strings; the fixed part dominates
+    return m_cache.insert({key, true}, {nullptr, listing}, 256).listing;
+}
+
+std::shared_ptr<const ParsedTemplateCache::Listing> ParsedTemplateCache::findListing(const Key& key)
+{
+    const auto cached = m_cache.find({key, true});
+    return cached ? cached->listing : nullptr;
+}
+
+void ParsedTemplateCache::clear()
+{
+    m_cache.clear();
+}
+
+qint64 ParsedTemplateCache::byteBudget() const
+{
+    return m_cache.byteBudget();
+}
+
+void ParsedTemplateCache::setByteBudget(qint64 bytes)
+{
+    m_cache.setByteBudget(bytes);
+}
+
+qint64 ParsedTemplateCache::bytesUsed() const
+{
+    return m_cache.bytesUsed();
+}
+
+qint64 ParsedTemplateCache::hits() const
+{
+    return m_cache.hits();
+}
+
+qint64 ParsedTemplateCache::misses() const
+{
+    return m_cache.misses();
+}
+
+} // namespace resourceInventory
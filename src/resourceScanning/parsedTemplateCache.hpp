@@ -0,0 +1,126 @@
+#ifndef PARSEDTEMPLATECACHE_HPP
+#define PARSEDTEMPLATECACHE_HPP
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <utility>
+
+#include "../jsonreader/JsonReader.hpp"
+#include "../platformInfo/export.hpp"
+#include "lruByteCache.hpp"
+#include "templateContentCache.hpp"
+
+namespace resourceInventory {
+
+/**
+ * @brief Process-wide cache of parsed template JSON files
+ *
+ * The editor, the content load of a template and TemplateParser read
+ * template files through this cache, so a file is parsed once per change
+ * instead of once per consumer. Listing (the scanner, the tree model's
+ * repaints) only needs a few top-level members: listing() reads those
+ * with JsonReader::readMembers() and caches them separately, so listing
+ * a folder never builds a DOM of bodies nobody opened.
+ *
+ * Entries are keyed by path, size and mtime; an edited file gets a new
+ * key and the stale entry ages out. Failures are cached as well, so a
+ * broken file is not read again until it changes. The least recently
+ * used entries of both kinds are dropped once their estimated size
+ * exceeds the byte budget. Thread-safe; parsing happens outside the lock.
+ */
+class PLATFORMINFO_API ParsedTemplateCache
+{
+public:
+    using Key = TemplateContentCache::Key;
+
+    struct Parsed {
+        QJsonDocument document;
+        JsonErrorInfo error;        ///< Set when the file could not be read or parsed
+        bool read = false;          ///< The file was read; error is then a parse error
+
+        bool ok() const { return !error.hasError(); }
+    };
+
+    struct Listing {
+        QJsonObject members;        ///< The listingKeys() present in the file
+        JsonErrorInfo error;        ///< Set when the file could not be read or scanned
+        bool read = false;          ///< The file was read; error is then a syntax error
+
+        bool ok() const { return !error.hasError(); }
+    };
+
+    static ParsedTemplateCache& instance();
+
+    /// Members read by listing(): "name" and "category"
+    static const QStringList& listingKeys();
+
+    /**
+     * @brief Parsed file in its current state
+     *
+     * Costs one stat() on a hit. Never null.
+     */
+    std::shared_ptr<const Parsed> get(const QString& path);
+
+    /**
+     * @brief Parsed file for a fingerprint the caller already has
+     *
+     * The file is not stat()ed on a hit; a file that no longer matches the
+     * fingerprint when read is parsed but not cached. Never null.
+     */
+    std::shared_ptr<const Parsed> get(const Key& key);
+
+    /**
+     * @brief Listing members of the file in its current state
+     *
+     * Only the members up to the last listing key are scanned; the rest of
+     * the file is neither decoded nor validated until get() parses it.
+     * Never null.
+     */
+    std::shared_ptr<const Listing> listing(const QString& path);
+
+    /// listing() for a fingerprint the caller already has (see get(const Key&))
+    std::shared_ptr<const Listing> listing(const Key& key);
+
+    /**
+     * @brief Listing of file content the caller already read
+     *
+     * Lets a scan read files on I/O threads and scan them on others. The
+     * result is cached unless the content no longer matches the
+     * fingerprint's size. Never null.
+     */
+    std::shared_ptr<const Listing> listing(const Key& key, const QByteArray& content);
+
+    /// Cached listing for a fingerprint, or null; never reads the file
+    std::shared_ptr<const Listing> findListing(const Key& key);
+
+    /// Drop every entry (e.g. after files were rewritten in place)
+    void clear();
+
+    qint64 byteBudget() const;
+    void setByteBudget(qint64 bytes);   // Default 32 MiB
+
+    qint64 bytesUsed() const;
+    qint64 hits() const;
+    qint64 misses() const;
+
+private:
+    ParsedTemplateCache();
+
+    // A parsed document or a listing; exactly one pointer is set
+    struct Entry {
+        std::shared_ptr<const Parsed> parsed;
+        std::shared_ptr<const Listing> listing;
+    };
+    using EntryKey = std::pair<Key, bool>;  // Fingerprint, and true for a listing
+
+    // Both kinds share one LRU order and byte budget
+    LruByteCache<EntryKey, Entry> m_cache;
+};
+
+} // namespace resourceInventory
+
+#endif // PARSEDTEMPLATECACHE_HPP
@@ -1,11 +1,39 @@
 #include "resourceScanner.hpp"
+#include "exampleDirManifest.hpp"
+#include "resourceInventory/resourceTable.hpp"
+#include "resourceInventory/templatePack.hpp"
 #include <QDir>
 #include <QFileInfo>
 #include <QDirIterator>
 #include <QStandardItemModel>
 #include <QStandardItem>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
 
-// Allowed attachments for script-like resources (examples/tests/templates)
+namespace resourceInventory {
+
+using resourceMetadata::ResourceTypeInfo;
+
+// Folders never descended when scanning templates
+static const QStringList kSkippedFolders = {
+    QStringLiteral("build"), QStringLiteral(".git"), QStringLiteral("node_modules")
+};
+
+// Attachments of templates in category folders; ResourceTypeInfo lists
+// none for templates, as top-level templates are plain items
 static const QStringList kScriptAttachmentFilters = {
     QStringLiteral("*.png"), QStringLiteral("*.jpg"), QStringLiteral("*.jpeg"),
     QStringLiteral("*.svg"), QStringLiteral("*.gif"),
@@ -14,245 +42,246 @@ static const QStringList kScriptAttachmentFilters = {
     QStringLiteral("*.dat")
 };
 
-namespace resourceInventory {
+// How long the destructor waits for background scans before detaching them
+static constexpr int kShutdownWaitMs = 1000;
 
-// Shared no-op scanner for resource types that are handled elsewhere
-static QList<ResourceItem> scanNoOp(const QString& basePath,
-                                      ResourceTier tier,
-                                      const QString& locationKey)
-{
-    Q_UNUSED(basePath);
-    Q_UNUSED(tier);
-    Q_UNUSED(locationKey);
-    return {};
-}
+namespace {
 
-// ============================================================================
-// ResourceScanner
-// ============================================================================
-
-ResourceScanner::ResourceScanner(QObject* parent)
-    : QObject(parent)
+QStringList toNameFilters(const QStringList& extensions)
 {
+    QStringList filters;
+    for (const QString& ext : extensions) {
+        filters << (QLatin1Char('*') + ext);
+    }
+    return filters;
 }
 
-QString ResourceScanner::resourceSubfolder(ResourceType type)
+bool matchesAny(const QString& fileName, const QStringList& nameFilters)
 {
-    switch (type) {
-        case ResourceType::ColorSchemes: return QStringLiteral("color-schemes");
-        case ResourceType::RenderColors: return QStringLiteral("color-schemes/render");
-        case ResourceType::EditorColors: return QStringLiteral("color-schemes/editor");
-        case ResourceType::Fonts:        return QStringLiteral("fonts");
-        case ResourceType::Libraries:     return QStringLiteral("libraries");
-        case ResourceType::Examples:     return QStringLiteral("examples");
-        case ResourceType::Tests:        return QStringLiteral("tests");
-        case ResourceType::Templates:    return QStringLiteral("templates");
-        case ResourceType::Shaders:      return QStringLiteral("shaders");
-        case ResourceType::Translations: return QStringLiteral("locale");
-        default:                        return QString();
+    for (const QString& filter : nameFilters) {
+        // Filters are "*.ext"; compare the suffix including the dot
+        if (fileName.endsWith(QStringView(filter).mid(1), Qt::CaseInsensitive)) {
+            return true;
+        }
     }
+    return false;
 }
 
-QStringList ResourceScanner::resourceExtensions(ResourceType type)
+bool lessIgnoreCase(const QString& a, const QString& b)
 {
-    switch (type) {
-        case ResourceType::ColorSchemes:
-        case ResourceType::RenderColors:
-        case ResourceType::EditorColors:
-            return {QStringLiteral(".json")};
-        case ResourceType::Fonts:
-            return {QStringLiteral(".ttf"), QStringLiteral(".otf"), 
-                    QStringLiteral(".woff"), QStringLiteral(".woff2")};
-        case ResourceType::Libraries:
-        case ResourceType::Examples:
-        case ResourceType::Tests:
-        case ResourceType::Templates:
-            return {QStringLiteral(".scad")};
-        case ResourceType::Shaders:
-            return {QStringLiteral(".vert"), QStringLiteral(".frag"), 
-                    QStringLiteral(".glsl")};
-        case ResourceType::Translations:
-            return {QStringLiteral(".qm"), QStringLiteral(".ts")};
-        default:
-            return {};
-    }
+    return a.compare(b, Qt::CaseInsensitive) < 0;
 }
 
-QList<ResourceItem> ResourceScanner::scanLocation(
-    const platformInfo::ResourceLocation& location,
-    ResourceType type,
-    ResourceTier tier)
+// One read-only item per entry of a compiled template pack, as listed by
+// TemplateScanner::scanTemplatePacks(); the entry's own category wins over
+// the folder's
+void addPackEntries(const QFileInfo& packInfo,
+                    ResourceTier tier,
+                    const QString& locationKey,
+                    const QString& category,
+                    const ResourceScanner::ItemCallback& onItemFound)
 {
-    if (!location.exists() || !location.isEnabled()) {
-        return {};
-    }
-    
-    QString basePath = location.path();
-    QString locationKey = location.getDisplayName();
-    
-    // Determine the subfolder for this resource type
-    QString subfolder = resourceSubfolder(type);
-    if (!subfolder.isEmpty()) {
-        basePath = QDir::cleanPath(basePath + QLatin1Char('/') + subfolder);
+    const QString packPath = packInfo.absoluteFilePath();
+    TemplatePack pack;
+    QString error;
+    if (!pack.open(packPath, &error)) {
+        qWarning() << "ResourceScanner:" << error;
+        return;
     }
     
-    QDir dir(basePath);
-    if (!dir.exists()) {
-        return {};
+    for (int i = 0; i < pack.count(); ++i) {
+        const QString name = pack.name(i).trimmed();
+        if (name.isEmpty()) {
+            continue;
+        }
+        const QString entryCategory = pack.category(i).trimmed();
+        ResourceItem item;
+        item.setPath(TemplatePack::entryPath(packPath, pack.prefix(i)));
+        item.setType(ResourceType::Templates);
+        item.setTier(tier);
+        item.setName(name);
+        item.setDisplayName(name);
+        item.setDescription(pack.description(i));
+        item.setCategory(entryCategory.isEmpty() ? category : entryCategory);
+        item.setSourcePath(packPath);
+        item.setSourceLocationKey(locationKey);
+        item.setAccess(ResourceAccess::ReadOnly);
+        item.setExists(true);
+        item.setLastModified(packInfo.lastModified());
+        onItemFound(item);
     }
+}
+
+// Build the scan table once from ResourceTypeInfo
+QMap<ResourceType, ResourceScanner::ScanRule> buildScanRules()
+{
+    using Recursion = ResourceScanner::Recursion;
+    QMap<ResourceType, ResourceScanner::ScanRule> rules;
     
-    switch (type) {
-        case ResourceType::ColorSchemes:
-            return scanColorSchemes(basePath, tier, locationKey);
-        case ResourceType::RenderColors:
-            return scanRenderColors(basePath, tier, locationKey);
-        case ResourceType::EditorColors:
-            return scanEditorColors(basePath, tier, locationKey);
-        case ResourceType::Fonts:
-            return scanFonts(basePath, tier, locationKey);
-        case ResourceType::Examples:
-            return scanExamples(basePath, tier, locationKey);
-        case ResourceType::Tests:
-            return scanTests(basePath, tier, locationKey);
-        case ResourceType::Templates:
-            // Use callback-based version - this shouldn't be called
-            return {};
-        case ResourceType::Translations:
-            return scanTranslations(basePath, tier, locationKey);
-        case ResourceType::Libraries:
-            // Libraries need special handling - each subfolder is a library
-            return {};  // Will be converted to callback in Phase 6
-        default:
-            return {};
+    for (const ResourceTypeInfo& info : ResourceTypeInfo::allResourceTypes()) {
+        const ResourceType type = info.getType();
+        if (type == ResourceType::Unknown || type == ResourceType::Group) {
+            continue;
+        }
+        
+        ResourceScanner::ScanRule rule;
+        rule.type = type;
+        rule.subfolder = info.getSubDir();
+        rule.nameFilters = toNameFilters(info.getPrimaryExtensions());
+        rule.attachmentFilters = toNameFilters(info.getAttachmentExtensions());
+        rule.access = (type == ResourceType::Templates) ? ResourceAccess::ReadWrite
+                                                        : ResourceAccess::ReadOnly;
+        
+        switch (type) {
+            case ResourceType::Examples:
+            case ResourceType::Tests:
+                rule.recursion = Recursion::OneLevel;
+                break;
+            case ResourceType::Templates:
+                rule.recursion = Recursion::Recursive;
+                rule.categoryAttachmentFilters = kScriptAttachmentFilters;
+                rule.listPacks = true;
+                break;
+            case ResourceType::ColorSchemes:
+            case ResourceType::RenderColors:
+            case ResourceType::EditorColors:
+            case ResourceType::Shaders:
+                rule.recursion = Recursion::Flat;
+                break;
+            default:
+                // Fonts are supplied by the system, translations and
+                // libraries are discovered elsewhere
+                rule.recursion = Recursion::None;
+                break;
+        }
+        
+        // Editor and render colors share the color-schemes folder in
+        // ResourceTypeInfo; the scanner keeps them in their own subfolders
+        if (type == ResourceType::RenderColors) {
+            rule.subfolder = QStringLiteral("color-schemes/render");
+        } else if (type == ResourceType::EditorColors) {
+            rule.subfolder = QStringLiteral("color-schemes/editor");
+        }
+        
+        for (ResourceType sub : info.getSubResTypes()) {
+            const ResourceTypeInfo subInfo = ResourceTypeInfo::s_resourceTypes.value(sub);
+            if (type == ResourceType::ColorSchemes) {
+                // Container: files of any of its sub-resources
+                for (const QString& filter : toNameFilters(subInfo.getPrimaryExtensions())) {
+                    if (!rule.nameFilters.contains(filter)) {
+                        rule.nameFilters << filter;
+                    }
+                }
+            } else if (rule.recursion == Recursion::OneLevel && sub != ResourceType::Group
+                       && !(type == ResourceType::Examples && sub == ResourceType::Tests)) {
+                // examples/tests stays a group of example scripts
+                rule.delegates << sub;
+            }
+        }
+        
+        rules.insert(type, rule);
     }
+    return rules;
 }
 
+} // namespace
+
 // ============================================================================
-// Legacy scan methods (will be converted to callbacks in Phase 6)
+// ResourceScanner
 // ============================================================================
 
-QList<ResourceItem> ResourceScanner::scanColorSchemes(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+// State shared with the background scans; outlives the scanner if a
+// scan is stuck in the file system
+struct ResourceScanner::BackgroundScans {
+    QMutex mutex;
+    ResourceScanner* owner = nullptr;   // Receiver of late results; null once destroyed
+    std::atomic_bool cancelled{false};
+};
+
+ResourceScanner::ResourceScanner(QObject* parent)
+    : QObject(parent)
+    , m_background(std::make_shared<BackgroundScans>())
+    , m_backgroundPool(new QThreadPool)
 {
-    QList<ResourceItem> results;
-    
-    // ColorSchemes is a container type that scans for both editor and render colors
-    // Scan for .json files at the basePath level and categorize them
-    QDir dir(basePath);
-    if (!dir.exists()) return results;
-    
-    QStringList filters = {QStringLiteral("*.json")};
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
-    
-    // For now, create ColorSchemes items but a more sophisticated approach
-    // could parse the JSON to determine if they're editor or render colors
-    for (const QFileInfo& fi : files) {
-        ResourceItem item(fi.absoluteFilePath(), ResourceType::ColorSchemes, tier);
-        item.setName(fi.baseName());
-        item.setDisplayName(fi.baseName());
-        item.setSourcePath(fi.absoluteFilePath());
-        item.setSourceLocationKey(locationKey);
-        item.setAccess(ResourceAccess::ReadOnly);
-        results.append(item);
-    }
-    
-    return results;
+    m_background->owner = this;
+    m_backgroundPool->setObjectName(QStringLiteral("ResourceScannerPool"));
 }
 
-QList<ResourceItem> ResourceScanner::scanRenderColors(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+ResourceScanner::~ResourceScanner()
 {
-    QList<ResourceItem> results;
-    QDir dir(basePath);
-    
-    if (!dir.exists()) return results;
-    
-    QStringList filters = {QStringLiteral("*.json")};
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
-    
-    for (const QFileInfo& fi : files) {
-        ResourceItem item(fi.absoluteFilePath(), ResourceType::RenderColors, tier);
-        item.setName(fi.baseName());
-        item.setDisplayName(fi.baseName());
-        item.setSourcePath(fi.absoluteFilePath());
-        item.setSourceLocationKey(locationKey);
-        item.setAccess(ResourceAccess::ReadOnly);
-        results.append(item);
+    // Background scans do not touch this scanner; stop them delivering
+    // results and ask them to stop between folders
+    {
+        QMutexLocker lock(&m_background->mutex);
+        m_background->owner = nullptr;
     }
+    m_background->cancelled = true;
     
-    return results;
+    // A scan blocked in a hung mount cannot be interrupted; rather than
+    // blocking shutdown, leave the pool and its threads behind
+    if (!m_backgroundPool->waitForDone(kShutdownWaitMs)) {
+        qWarning() << "ResourceScanner: Detaching" << m_backgroundPool->activeThreadCount()
+                   << "unfinished background scan(s)";
+        return;
+    }
+    delete m_backgroundPool;
 }
 
-QList<ResourceItem> ResourceScanner::scanEditorColors(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+const ResourceScanner::ScanRule* ResourceScanner::scanRule(ResourceType type)
 {
-    QList<ResourceItem> results;
-    QDir dir(basePath);
-    
-    if (!dir.exists()) return results;
-    
-    QStringList filters = {QStringLiteral("*.json")};
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
-    
-    for (const QFileInfo& fi : files) {
-        ResourceItem item(fi.absoluteFilePath(), ResourceType::EditorColors, tier);
-        item.setName(fi.baseName());
-        item.setDisplayName(fi.baseName());
-        item.setSourcePath(fi.absoluteFilePath());
-        item.setSourceLocationKey(locationKey);
-        item.setAccess(ResourceAccess::ReadOnly);
-        results.append(item);
-    }
-    
-    return results;
+    static const QMap<ResourceType, ScanRule> rules = buildScanRules();
+    const auto it = rules.constFind(type);
+    return it != rules.cend() ? &it.value() : nullptr;
 }
 
-QList<ResourceItem> ResourceScanner::scanFonts(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+QString ResourceScanner::resourceSubfolder(ResourceType type)
 {
-    // Fonts are supplied by the system; only bundled font is handled elsewhere.
-    return scanNoOp(basePath, tier, locationKey);
+    const ScanRule* rule = scanRule(type);
+    return rule ? rule->subfolder : QString();
 }
 
-QList<ResourceItem> ResourceScanner::scanExamples(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+QStringList ResourceScanner::resourceExtensions(ResourceType type)
 {
-    QList<ResourceItem> results;
-    
-    // One-level scan: top-level .scad files plus immediate subfolders
-    QDir dir(basePath);
-    if (!dir.exists()) return results;
-
-    auto processDir = [&](const QString& path, const QString& category) {
-        QDir d(path);
-        QFileInfoList files = d.entryInfoList({QStringLiteral("*.scad")}, QDir::Files);
-        for (const QFileInfo& fi : files) {
-            ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(),
-                                                              ResourceType::Examples,
-                                                              tier,
-                                                              locationKey);
-            script.setCategory(category);
-            results.append(script);
-        }
-    };
-
-    // Top-level examples
-    processDir(basePath, QString());
+    const ScanRule* rule = scanRule(type);
+    if (!rule) {
+        return {};
+    }
+    QStringList extensions;
+    for (const QString& filter : rule->nameFilters) {
+        extensions << filter.mid(1);
+    }
+    return extensions;
+}
 
-    // One-level subfolders as categories
-    QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& sub : subfolders) {
-        processDir(dir.absoluteFilePath(sub), sub);
+void ResourceScanner::scanLocation(
+    const platformInfo::ResourceLocation& location,
+    ResourceType type,
+    ResourceTier tier,
+    ItemCallback onItemFound)
+{
+    const ScanRule* rule = scanRule(type);
+    if (!rule || !onItemFound || !QDir(location.path()).exists()) {
+        return;
     }
+    
+    const QString basePath = QDir::cleanPath(location.path() + QLatin1Char('/') + rule->subfolder);
+    scanType(type, basePath, tier, location.getDisplayName(), std::move(onItemFound));
+}
 
+QList<ResourceItem> ResourceScanner::scanLocation(
+    const platformInfo::ResourceLocation& location,
+    ResourceType type,
+    ResourceTier tier)
+{
+    QList<ResourceItem> results;
+    scanLocation(location, type, tier, [&results](const ResourceItem& item) {
+        results.append(item);
+    });
     return results;
 }
 
-// ============================================================================
-// NEW CALLBACK-BASED API (Phase 1)
-// ============================================================================
-
-void ResourceScanner::scanExamples(
+void ResourceScanner::scanType(
+    ResourceType type,
     const QString& basePath,
     ResourceTier tier,
     const QString& locationKey,
@@ -260,135 +289,212 @@ void ResourceScanner::scanExamples(
 {
     if (!onItemFound) return;  // Null callback guard
     
-    QDir dir(basePath);
-    if (!dir.exists()) return;
-
-    // Scan top-level .scad files (examples without category)
-    QFileInfoList topLevelFiles = dir.entryInfoList({QStringLiteral("*.scad")}, QDir::Files);
-    for (const QFileInfo& fi : topLevelFiles) {
-        ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(),
-                                                          ResourceType::Examples,
-                                                          tier,
-                                                          locationKey);
-        // No category for top-level
-        onItemFound(script);
-    }
-
-    // Process subfolders based on resource type
-    QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& sub : subfolders) {
-        QString subPath = dir.absoluteFilePath(sub);
-        QString lowerSub = sub.toLower();
-        
-        if (lowerSub == QStringLiteral("templates")) {
-            // Delegate to templates scanner
-            scanTemplates(subPath, tier, locationKey, onItemFound);
-        }
-        else if (lowerSub == QStringLiteral("tests")) {
-            // Delegate to tests scanner (convert to callback first in Phase 6)
-            // For now, scan as Group
-            scanGroup(subPath, tier, locationKey, sub, onItemFound);
-        }
-        else {
-            // It's a Group (category folder) - scan .scad files with attachments
-            scanGroup(subPath, tier, locationKey, sub, onItemFound);
-        }
-    }
+    const ScanRule* rule = scanRule(type);
+    if (!rule || rule->recursion == Recursion::None) return;
+    if (!QDir(basePath).exists()) return;
+    
+    scanRuleFolder(*rule, QDir::cleanPath(basePath), tier, locationKey,
+                   QString(), 0, true, onItemFound);
 }
 
-// Helper: Scan a Group folder (category with .scad scripts + attachments, no recursion)
-void ResourceScanner::scanGroup(
-    const QString& groupPath,
+// ============================================================================
+// Scan engine
+// ============================================================================
+
+void ResourceScanner::scanRuleFolder(
+    const ScanRule& rule,
+    const QString& folderPath,
     ResourceTier tier,
     const QString& locationKey,
     const QString& category,
-    ItemCallback onItemFound)
+    int depth,
+    bool recurse,
+    const ItemCallback& onItemFound)
 {
-    if (!onItemFound) return;
+    if (m_cancelled && m_cancelled->load()) {
+        return;  // Owning scanner was destroyed (background scans only)
+    }
+    
+    const bool descend = recurse && rule.recursion != Recursion::Flat
+                         && (rule.recursion != Recursion::OneLevel || depth == 0);
+    
+    // Scripts of category folders may have attachments of their own
+    const QStringList& attachmentFilters = (rule.attachmentFilters.isEmpty() && !category.isEmpty())
+        ? rule.categoryAttachmentFilters
+        : rule.attachmentFilters;
     
-    QDir dir(groupPath);
-    if (!dir.exists()) return;
+    // A trusted manifest replaces the listing of a script folder
+    ExampleDirManifest manifest;
+    const bool trusted = !rule.attachmentFilters.isEmpty()
+                         && ExampleDirManifest::loadTrusted(folderPath, manifest);
+    if (trusted) {
+        const QDir dir(folderPath);
+        for (const ExampleDirManifest::Script& entry : manifest.scripts) {
+            if (!matchesAny(QFileInfo(entry.file).fileName(), rule.nameFilters)) {
+                continue;  // Only what a listing would pick as primary
+            }
+            const QString scriptPath = QDir::cleanPath(dir.absoluteFilePath(entry.file));
+            ResourceScript script = makeScript(scriptPath, rule.type, tier, locationKey);
+            for (const QString& attachment : entry.attachments) {
+                script.addAttachment(QDir::cleanPath(dir.absoluteFilePath(attachment)));
+            }
+            script.setCategory(category);
+            onItemFound(script);
+        }
+    }
+    
+    // One listing per folder: primary files, attachment candidates, subfolders
+    QFileInfoList primaries;
+    QFileInfoList attachments;
+    QFileInfoList packs;
+    QStringList subdirs;
+    const bool needListing = !trusted || (descend && !(depth == 0 && manifest.hasCategories));
+    if (needListing) {
+        QDirIterator it(folderPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo fi = it.fileInfo();
+            const QString fileName = fi.fileName();
+            if (fi.isDir()) {
+                subdirs << fileName;
+            } else if (trusted) {
+                continue;
+            } else if (matchesAny(fileName, rule.nameFilters)) {
+                primaries << fi;
+            } else if (matchesAny(fileName, attachmentFilters)) {
+                attachments << fi;
+            } else if (rule.listPacks && fileName.endsWith(TemplatePack::fileExtension, Qt::CaseInsensitive)) {
+                packs << fi;
+            }
+        }
+        const auto byFileName = [](const QFileInfo& a, const QFileInfo& b) {
+            return lessIgnoreCase(a.fileName(), b.fileName());
+        };
+        std::sort(primaries.begin(), primaries.end(), byFileName);
+        std::sort(packs.begin(), packs.end(), byFileName);
+        std::sort(subdirs.begin(), subdirs.end(), lessIgnoreCase);
+    }
     
-    // Scan all .scad files in this Group folder
-    QFileInfoList files = dir.entryInfoList({QStringLiteral("*.scad")}, QDir::Files);
-    for (const QFileInfo& fi : files) {
-        ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(),
-                                                          ResourceType::Examples,
-                                                          tier,
-                                                          locationKey);
+    for (const QFileInfo& fi : std::as_const(primaries)) {
+        const QString filePath = fi.absoluteFilePath();
+        const QString baseName = fi.baseName();
+        
+        if (attachmentFilters.isEmpty()) {
+            ResourceItem item;
+            item.setPath(filePath);
+            item.setType(rule.type);
+            item.setTier(tier);
+            item.setName(baseName);
+            item.setDisplayName(baseName);
+            item.setCategory(category);
+            item.setSourcePath(filePath);
+            item.setSourceLocationKey(locationKey);
+            item.setAccess(rule.access);
+            item.setExists(true);
+            item.setLastModified(fi.lastModified());
+            onItemFound(item);
+            continue;
+        }
+        
+        ResourceScript script;
+        script.setPath(filePath);
+        script.setType(rule.type);
+        script.setTier(tier);
+        script.setName(baseName);
+        script.setScriptPath(filePath);
+        script.setSourcePath(filePath);
+        script.setSourceLocationKey(locationKey);
+        script.setAccess(rule.access);
         script.setCategory(category);
+        script.setExists(true);
+        script.setLastModified(fi.lastModified());
+        
+        // Attachments sharing the script's base name, then its data folder
+        for (const QFileInfo& candidate : std::as_const(attachments)) {
+            if (candidate.baseName().startsWith(baseName)) {
+                script.addAttachment(candidate.absoluteFilePath());
+            }
+        }
+        if (subdirs.contains(baseName)) {
+            QDirIterator data(folderPath + QLatin1Char('/') + baseName, attachmentFilters,
+                              QDir::Files, QDirIterator::Subdirectories);
+            while (data.hasNext()) {
+                script.addAttachment(data.next());
+            }
+        }
         onItemFound(script);
     }
-}
-
-void ResourceScanner::scanTemplates(
-    const QString& basePath,
-    ResourceTier tier,
-    const QString& locationKey,
-    ItemCallback onItemFound)
-{
-    if (!onItemFound) return;  // Null callback guard
     
-    QDir dir(basePath);
-    if (!dir.exists()) return;
-    
-    // Templates: subfolders define categories
-    // First scan top-level templates (no category)
-    // Support both .scad (legacy) and .json (modern VS Code snippet format) templates
-    QStringList filters = {QStringLiteral("*.scad"), QStringLiteral("*.json")};
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
+    // Packs follow the plain files, as in TemplateScanner::scanLocation()
+    for (const QFileInfo& fi : std::as_const(packs)) {
+        addPackEntries(fi, tier, locationKey, category, onItemFound);
+    }
     
-    for (const QFileInfo& fi : files) {
-        ResourceItem item(fi.absoluteFilePath(), ResourceType::Templates, tier);
-        item.setName(fi.baseName());
-        item.setDisplayName(fi.baseName());
-        item.setSourcePath(fi.absoluteFilePath());
-        item.setSourceLocationKey(locationKey);
-        item.setAccess(ResourceAccess::ReadWrite);  // Templates are writable
-        onItemFound(item);  // Stream to callback
+    if (!descend) {
+        return;
     }
     
-    // Scan subfolders (each is a category)
-    QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& subfolder : subfolders) {
-        QString subPath = dir.absoluteFilePath(subfolder);
+    const QStringList folders = (trusted && depth == 0 && manifest.hasCategories)
+        ? manifest.categories
+        : subdirs;
+    for (const QString& sub : folders) {
+        const QString subPath = folderPath + QLatin1Char('/') + sub;
         
-        // Recursive scan with callback streaming
-        std::function<void(const QString&, const QString&)> scanRecursive;
-        scanRecursive = [&](const QString& folderPath, const QString& category) {
-            QDir d(folderPath);
-            if (!d.exists()) return;
-            
-            // Scan files in this folder
-            QFileInfoList subFiles = d.entryInfoList(filters, QDir::Files);
-            for (const QFileInfo& fi : subFiles) {
-                ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(),
-                                                                 ResourceType::Templates,
-                                                                 tier,
-                                                                 locationKey);
-                script.setCategory(category);
-                onItemFound(script);  // Stream to callback
+        if (rule.recursion == Recursion::OneLevel) {
+            // Sub-resource folders (e.g. examples/templates) use their own rule
+            const ScanRule* delegate = nullptr;
+            for (ResourceType type : rule.delegates) {
+                const ScanRule* candidate = scanRule(type);
+                if (candidate && candidate->subfolder.compare(sub, Qt::CaseInsensitive) == 0) {
+                    delegate = candidate;
+                    break;
+                }
             }
-            
-            // Recurse into subfolders
-            QStringList subs = d.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-            for (const QString& sub : subs) {
-                if (sub == QLatin1String("build") ||
-                    sub == QLatin1String(".git") ||
-                    sub == QLatin1String("node_modules")) {
-                    continue;
+            if (delegate) {
+                if (delegate->recursion != Recursion::None && QDir(subPath).exists()) {
+                    scanRuleFolder(*delegate, subPath, tier, locationKey, QString(), 0, true, onItemFound);
                 }
-                
-                QString newCategory = category.isEmpty() ? sub
-                                                          : (category + QLatin1Char('/') + sub);
-                scanRecursive(d.absoluteFilePath(sub), newCategory);
+                continue;
             }
-        };
+            // Group folder: subfolder name is the category
+            if (QDir(subPath).exists()) {
+                scanRuleFolder(rule, subPath, tier, locationKey, sub, 1, false, onItemFound);
+            }
+            continue;
+        }
         
-        scanRecursive(subPath, subfolder);
+        // Recursive: the relative path is the category
+        if (kSkippedFolders.contains(sub)) {
+            continue;
+        }
+        const QString subCategory = category.isEmpty() ? sub
+                                                       : (category + QLatin1Char('/') + sub);
+        scanRuleFolder(rule, subPath, tier, locationKey, subCategory, depth + 1, true, onItemFound);
     }
 }
 
+// ============================================================================
+// Per-type adapters
+// ============================================================================
+
+void ResourceScanner::scanExamples(
+    const QString& basePath,
+    ResourceTier tier,
+    const QString& locationKey,
+    ItemCallback onItemFound)
+{
+    scanType(ResourceType::Examples, basePath, tier, locationKey, std::move(onItemFound));
+}
+
+void ResourceScanner::scanTemplates(
+    const QString& basePath,
+    ResourceTier tier,
+    const QString& locationKey,
+    ItemCallback onItemFound)
+{
+    scanType(ResourceType::Templates, basePath, tier, locationKey, std::move(onItemFound));
+}
+
 QList<ResourceItem> ResourceScanner::scanTemplatesToList(
     const QString& basePath,
     ResourceTier tier,
@@ -444,38 +550,117 @@ void ResourceScanner::scanExamplesToModel(
 }
 
 
-void ResourceScanner::addItemToModel(QStandardItemModel* model, const ResourceItem& item)
+namespace {
+
+// Store an item and its metadata roles in a model row
+void setModelItem(QStandardItem* standardItem, const ResourceItem& item)
 {
-    if (!model) return;
-    
-    // Custom roles for metadata storage
-    enum ItemRole {
-        ItemDataRole = Qt::UserRole,  // Store full ResourceItem
-        TypeRole = Qt::UserRole + 1,
-        TierRole = Qt::UserRole + 2,
-        PathRole = Qt::UserRole + 3,
-        CategoryRole = Qt::UserRole + 4,
-        AccessRole = Qt::UserRole + 5,
-        LocationKeyRole = Qt::UserRole + 6
-    };
-    
-    auto* standardItem = new QStandardItem(item.displayName());
+    standardItem->setText(item.displayName());
     
     // Store full item as QVariant for easy retrieval
-    standardItem->setData(QVariant::fromValue(item), ItemDataRole);
+    standardItem->setData(QVariant::fromValue(item), ResourceScanner::ItemDataRole);
     
     // Store metadata in custom roles (for filtering/sorting)
-    standardItem->setData(static_cast<int>(item.type()), TypeRole);
-    standardItem->setData(static_cast<int>(item.tier()), TierRole);
-    standardItem->setData(item.sourcePath(), PathRole);
-    standardItem->setData(item.category(), CategoryRole);
-    standardItem->setData(static_cast<int>(item.access()), AccessRole);
-    standardItem->setData(item.sourceLocationKey(), LocationKeyRole);
+    standardItem->setData(static_cast<int>(item.type()), ResourceScanner::TypeRole);
+    standardItem->setData(static_cast<int>(item.tier()), ResourceScanner::TierRole);
+    standardItem->setData(item.sourcePath(), ResourceScanner::PathRole);
+    standardItem->setData(item.category(), ResourceScanner::CategoryRole);
+    standardItem->setData(static_cast<int>(item.access()), ResourceScanner::AccessRole);
+    standardItem->setData(item.sourceLocationKey(), ResourceScanner::LocationKeyRole);
+}
+
+} // namespace
+
+void ResourceScanner::addItemToModel(QStandardItemModel* model, const ResourceItem& item)
+{
+    if (!model) return;
+    
+    auto* standardItem = new QStandardItem;
+    setModelItem(standardItem, item);
     
     // Add to model
     model->appendRow(standardItem);
 }
 
+QList<ResourceItem> ResourceScanner::itemsInModel(const QStandardItemModel* model)
+{
+    QList<ResourceItem> items;
+    if (!model) return items;
+    
+    items.reserve(model->rowCount());
+    for (int row = 0; row < model->rowCount(); ++row) {
+        const QVariant data = model->item(row)->data(ItemDataRole);
+        if (data.isValid()) {
+            items.append(data.value<ResourceItem>());
+        }
+    }
+    return items;
+}
+
+void ResourceScanner::applyChangesToModel(QStandardItemModel* model,
+                                          const QList<ResourceItem>& before,
+                                          const QList<ResourceItem>& after,
+                                          const QList<ScanDiff::Change>& changes)
+{
+    if (!model || changes.isEmpty()) return;
+    
+    // Rows of the previous items, found in one pass over the model. The same
+    // path can be listed by several locations, so rows are keyed by
+    // (path, location key); each change takes its row out of the map.
+    using RowKey = QPair<QString, StringPool::Id>;
+    const auto keyOf = [](const ResourceItem& item) {
+        return RowKey(item.path(), item.locationKeyId());
+    };
+    QMultiHash<RowKey, int> rowByKey;
+    rowByKey.reserve(model->rowCount());
+    for (int row = 0; row < model->rowCount(); ++row) {
+        const QVariant data = model->item(row)->data(ItemDataRole);
+        if (data.isValid()) {
+            rowByKey.insert(keyOf(data.value<ResourceItem>()), row);
+        }
+    }
+    const auto takeRow = [&rowByKey, &keyOf](const ResourceItem& item) {
+        const auto it = rowByKey.find(keyOf(item));
+        if (it == rowByKey.end()) {
+            return -1;
+        }
+        const int row = it.value();
+        rowByKey.erase(it);
+        return row;
+    };
+    
+    QList<int> removedRows;
+    for (const ScanDiff::Change& change : changes) {
+        switch (change.kind) {
+            case ScanDiff::Change::Modified: {
+                const int row = takeRow(before[change.oldIndex]);
+                if (row >= 0) {
+                    setModelItem(model->item(row), after[change.newIndex]);  // Emits dataChanged
+                } else {
+                    addItemToModel(model, after[change.newIndex]);
+                }
+                break;
+            }
+            case ScanDiff::Change::Removed: {
+                const int row = takeRow(before[change.oldIndex]);
+                if (row >= 0) {
+                    removedRows.append(row);
+                }
+                break;
+            }
+            case ScanDiff::Change::Added:
+                addItemToModel(model, after[change.newIndex]);
+                break;
+        }
+    }
+    
+    // Highest rows first so the remaining row numbers stay valid
+    std::sort(removedRows.begin(), removedRows.end(), std::greater<int>());
+    for (int row : std::as_const(removedRows)) {
+        model->removeRow(row);
+    }
+}
+
 // ============================================================================
 // Phase 2: High-Level scanToModel() API
 // ============================================================================
@@ -487,11 +672,15 @@ void ResourceScanner::scanToModel(QStandardItemModel* model,
         return;
     }
     
-    // Define callback that adds items to model
-    auto addToModel = [this, model](const ResourceItem& item) {
+    const QStringList pending = scanLocationsWithDeadline(locations, [this, model](const ResourceItem& item) {
         addItemToModel(model, item);
-    };
-    
+    });
+    addPendingToModel(model, pending);
+}
+
+void ResourceScanner::scanLocations(const QList<platformInfo::ResourceLocation>& locations,
+                                    ItemCallback onItemFound)
+{
     // Scan all locations (tier is encoded in each location)
     for (const auto& loc : locations) {
         QString basePath = loc.path();
@@ -501,147 +690,631 @@ void ResourceScanner::scanToModel(QStandardItemModel* model,
         // Scan templates
         QString templatesPath = QDir::cleanPath(basePath + QStringLiteral("/templates"));
         if (QDir(templatesPath).exists()) {
-            scanTemplates(templatesPath, tier, displayName, addToModel);
+            scanType(ResourceType::Templates, templatesPath, tier, displayName, onItemFound);
         }
         
         // Scan examples
         QString examplesPath = QDir::cleanPath(basePath + QStringLiteral("/examples"));
         if (QDir(examplesPath).exists()) {
-            scanExamples(examplesPath, tier, displayName, addToModel);
+            scanType(ResourceType::Examples, examplesPath, tier, displayName, onItemFound);
         }
     }
 }
 
 // ============================================================================
-// LEGACY API (to be removed in Phase 5)
+// Deadline scans
 // ============================================================================
 
-QList<ResourceItem> ResourceScanner::scanTranslations(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+namespace {
+
+// State shared between the caller and the background scan of one location
+struct LocationJob {
+    QMutex mutex;
+    QWaitCondition finished;
+    QThread* thread = nullptr;      // Pool thread running the scan
+    QList<ResourceItem> items;
+    QStringList changedDirs;        // Rescans only: folders to watch
+    QStringList removedDirs;        // Rescans only: folders to stop watching
+    bool done = false;
+    bool deferred = false;          // Caller gave up waiting; deliver queued
+};
+
+// Give every new job a thread of its own, on top of those still busy with
+// deferred locations of earlier calls, so a slow one never delays the others
+void reserveThreads(QThreadPool* pool, int jobs)
 {
-    // Translations are handled elsewhere; discovery is intentionally disabled here.
-    return scanNoOp(basePath, tier, locationKey);
+    pool->setMaxThreadCount(qMax(pool->maxThreadCount(), pool->activeThreadCount() + jobs));
 }
 
-QList<ResourceItem> ResourceScanner::scanTests(
-    const QString& basePath, ResourceTier tier, const QString& locationKey)
+// Called by a pool thread starting a job
+void startJob(LocationJob& job)
 {
-    QList<ResourceItem> results;
-    
-    // One-level scan: top-level .scad files plus immediate subfolders
-    QDir dir(basePath);
-    if (!dir.exists()) return results;
-
-    auto processDir = [&](const QString& path, const QString& category) {
-        QDir d(path);
-        QFileInfoList files = d.entryInfoList({QStringLiteral("*.scad")}, QDir::Files);
-        for (const QFileInfo& fi : files) {
-            ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(),
-                                                              ResourceType::Tests,
-                                                              tier,
-                                                              locationKey);
-            script.setCategory(category);
-            results.append(script);
+    QMutexLocker lock(&job.mutex);
+    job.thread = QThread::currentThread();
+    job.thread->setPriority(QThread::NormalPriority);  // Pool threads are reused
+}
+
+// Wait for a job until the deadline (0 = no deadline), measured from
+// elapsed's start. A job still running then is marked deferred and its
+// thread drops to low priority. The caller holds job.mutex.
+bool waitForJob(LocationJob& job, int deadline, const QElapsedTimer& elapsed)
+{
+    while (!job.done) {
+        if (deadline <= 0) {
+            job.finished.wait(&job.mutex);
+            continue;
         }
-    };
+        const qint64 remaining = deadline - elapsed.elapsed();
+        if (remaining <= 0 || !job.finished.wait(&job.mutex, QDeadlineTimer(remaining))) {
+            break;
+        }
+    }
+    if (job.done) {
+        return true;
+    }
+    job.deferred = true;
+    if (job.thread) {
+        job.thread->setPriority(QThread::LowPriority);
+    }
+    return false;
+}
 
-    // Top-level tests
-    processDir(basePath, QString());
+} // namespace
 
-    // One-level subfolders as categories
-    QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& sub : subfolders) {
-        processDir(dir.absoluteFilePath(sub), sub);
-    }
+// Incremental rescan state of one location. A rescan holds mutex from start
+// to finish; the watcher only appends to dirty, so it never waits for one.
+struct ResourceScanner::LocationCache {
+    QMutex mutex;
+    DirectoryStampTree stampTree;
+    ResourceTable itemTable;                        // Items of all scanned folders
+    QMap<QString, QList<ResourceTable::RowId>> dirRows;  // Rows per scanned folder
 
-    return results;
+    QMutex dirtyMutex;
+    QStringList dirty;                              // Flagged folders, for the next rescan
+};
+
+void ResourceScanner::setLocationDeadline(const QString& path, int msecs)
+{
+    m_locationDeadlines.insert(QDir::cleanPath(path), msecs);
 }
 
-ResourceScript ResourceScanner::scanScriptWithAttachments(
-    const QString& scriptPath,
-    ResourceType type,
-    ResourceTier tier,
-    const QString& locationKey)
+int ResourceScanner::locationDeadline(const QString& path) const
 {
-    ResourceScript script(scriptPath);
-    script.setType(type);
-    script.setTier(tier);
-    script.setScriptPath(scriptPath);
-    script.setSourcePath(scriptPath);
-    script.setSourceLocationKey(locationKey);
-    script.setAccess(type == ResourceType::Templates ? ResourceAccess::ReadWrite 
-                                                     : ResourceAccess::ReadOnly);
+    return m_locationDeadlines.value(QDir::cleanPath(path), m_defaultDeadline);
+}
+
+QStringList ResourceScanner::scanLocationsWithDeadline(
+    const QList<platformInfo::ResourceLocation>& locations,
+    ItemCallback onItemFound)
+{
+    bool anyDeadline = false;
+    for (const auto& loc : locations) {
+        anyDeadline = anyDeadline || locationDeadline(loc.path()) > 0;
+    }
+    if (!anyDeadline) {
+        scanLocations(locations, std::move(onItemFound));
+        return {};
+    }
+    
+    // Start every location at once
+    reserveThreads(m_backgroundPool, int(locations.size()));
+    QList<std::shared_ptr<LocationJob>> jobs;
+    for (const auto& loc : locations) {
+        auto job = std::make_shared<LocationJob>();
+        jobs.append(job);
+        m_backgroundPool->start([background = m_background, loc, job]() {
+            startJob(*job);
+            
+            // A scanner of its own, so the job never refers to the caller's
+            // scanner, which may be destroyed while the job runs
+            QList<ResourceItem> items;
+            {
+                ResourceScanner scanner;
+                scanner.m_cancelled = &background->cancelled;
+                scanner.scanLocations({loc}, [&items](const ResourceItem& item) {
+                    items.append(item);
+                });
+            }
+            
+            QMutexLocker lock(&job->mutex);
+            job->done = true;
+            job->thread = nullptr;
+            if (!job->deferred) {
+                job->items = std::move(items);
+                job->finished.wakeAll();
+                return;
+            }
+            lock.unlock();
+            
+            // Posting under the lock keeps the owner alive until queued;
+            // a queued call is dropped if the owner is destroyed before it runs
+            const QString path = QDir::cleanPath(loc.path());
+            QMutexLocker ownerLock(&background->mutex);
+            if (ResourceScanner* owner = background->owner) {
+                QMetaObject::invokeMethod(owner, [owner, path, items]() {
+                    owner->finishPendingLocation(path, items);
+                }, Qt::QueuedConnection);
+            }
+        });
+    }
     
-    // Look for attachments in the same folder
-    QFileInfo fi(scriptPath);
-    QDir dir = fi.dir();
+    // Deadlines run concurrently; all are measured from the same start
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QStringList pending;
+    for (int i = 0; i < locations.size(); ++i) {
+        const QString path = QDir::cleanPath(locations[i].path());
+        const int deadline = locationDeadline(path);
+        LocationJob& job = *jobs[i];
+        
+        QMutexLocker lock(&job.mutex);
+        if (!waitForJob(job, deadline, elapsed)) {
+            lock.unlock();
+            
+            qDebug() << "ResourceScanner: Location" << path << "exceeded" << deadline
+                     << "ms, continuing in background";
+            m_pendingModels.insert(path, {});
+            pending.append(path);
+            emit locationPending(path);
+            continue;
+        }
+        
+        const QList<ResourceItem> items = std::move(job.items);
+        lock.unlock();
+        if (onItemFound) {
+            for (const ResourceItem& item : items) {
+                onItemFound(item);
+            }
+        }
+    }
     
-    // Only look for attachments that share the script's base name or are in a data subfolder
-    QString baseName = fi.baseName();
-    QFileInfoList candidates = dir.entryInfoList(kScriptAttachmentFilters, QDir::Files);
+    return pending;
+}
+
+void ResourceScanner::addPendingToModel(QStandardItemModel* model, const QStringList& paths)
+{
+    if (!model) return;
     
-    for (const QFileInfo& candidate : candidates) {
-        // Include if filename starts with script's base name
-        if (candidate.baseName().startsWith(baseName)) {
-            script.addAttachment(candidate.absoluteFilePath());
+    for (const QString& path : paths) {
+        const auto it = m_pendingModels.find(path);
+        if (it == m_pendingModels.end()) {
+            continue;  // Already finished
         }
+        it->append(model);
+        
+        auto* placeholder = new QStandardItem(tr("%1 (scanning...)").arg(path));
+        placeholder->setData(path, PathRole);
+        placeholder->setData(path, LocationKeyRole);
+        placeholder->setData(true, PendingRole);
+        placeholder->setEnabled(false);
+        model->appendRow(placeholder);
     }
+}
+
+bool ResourceScanner::waitForPendingScans(int msecs)
+{
+    return m_backgroundPool->waitForDone(msecs);
+}
+
+void ResourceScanner::finishPendingLocation(const QString& path, const QList<ResourceItem>& items)
+{
+    const QList<QPointer<QStandardItemModel>> models = m_pendingModels.take(path);
+    qDebug() << "ResourceScanner: Background scan of" << path << "finished with"
+             << items.size() << "items";
     
-    // Check for a data subfolder with same name as script
-    QString dataFolder = dir.absoluteFilePath(baseName);
-    if (QDir(dataFolder).exists()) {
-        QDirIterator it(dataFolder, kScriptAttachmentFilters, QDir::Files, QDirIterator::Subdirectories);
-        while (it.hasNext()) {
-            script.addAttachment(it.next());
+    for (const QPointer<QStandardItemModel>& model : models) {
+        if (!model) {
+            continue;
+        }
+        for (int row = model->rowCount() - 1; row >= 0; --row) {
+            const QStandardItem* item = model->item(row);
+            if (item && item->data(PendingRole).toBool() && item->data(PathRole).toString() == path) {
+                model->removeRow(row);
+                addItemsToModel(model, items);
+                break;
+            }
         }
     }
     
-    return script;
+    emit locationScanFinished(path, items);
+    if (m_pendingModels.isEmpty()) {
+        emit pendingScansFinished();
+    }
 }
 
-void ResourceScanner::scanFolderRecursive(
-    const QString& folderPath,
-    const QStringList& extensions,
-    ResourceType type,
-    ResourceTier tier,
-    const QString& locationKey,
-    const QString& category,
-    QList<ResourceItem>& results)
+void ResourceScanner::addItemsToModel(QStandardItemModel* model,
+                                      const QList<ResourceItem>& items)
 {
-    QDir dir(folderPath);
-    if (!dir.exists()) return;
+    if (!model) return;
     
-    // Build filter list
-    QStringList filters;
-    for (const QString& ext : extensions) {
-        filters << (QStringLiteral("*") + ext);
+    for (const ResourceItem& item : items) {
+        addItemToModel(model, item);
+    }
+}
+
+// ============================================================================
+// Incremental rescan
+// ============================================================================
+
+std::shared_ptr<ResourceScanner::LocationCache> ResourceScanner::locationCache(const QString& path)
+{
+    std::shared_ptr<LocationCache>& cache = m_locationCaches[QDir::cleanPath(path)];
+    if (!cache) {
+        cache = std::make_shared<LocationCache>();
+        cache->stampTree.setSkippedNames(kSkippedFolders);
+    }
+    return cache;
+}
+
+ResourceScanner::RescanResult ResourceScanner::rescanLocation(
+    const platformInfo::ResourceLocation& location,
+    LocationCache& cache,
+    DirectoryStampTree::UpdateMode mode)
+{
+    QStringList dirty;
+    {
+        QMutexLocker lock(&cache.dirtyMutex);
+        dirty.swap(cache.dirty);
+    }
+    for (const QString& path : std::as_const(dirty)) {
+        cache.stampTree.markDirty(path);
     }
     
-    // Scan files in this folder
-    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
-    for (const QFileInfo& fi : files) {
-        ResourceScript script = scanScriptWithAttachments(fi.absoluteFilePath(), 
-                                                           type, tier, locationKey);
-        script.setCategory(category);
-        results.append(script);
+    RescanResult result;
+    for (const QString& folder : {QStringLiteral("templates"), QStringLiteral("examples")}) {
+        const QString root = QDir::cleanPath(location.path() + QLatin1Char('/') + folder);
+        const DirectoryStampTree::Changes changes = cache.stampTree.update(root, mode);
+        
+        for (const QString& removed : changes.removed) {
+            for (const auto row : cache.dirRows.take(removed)) {
+                cache.itemTable.remove(row);
+            }
+        }
+        result.removedDirs += changes.removed;
+        result.changedDirs += changes.changed;
+        
+        // Map each changed directory to the folder(s) whose items it affects
+        QSet<QString> toScan;
+        for (const QString& changed : changes.changed) {
+            for (const QString& owner : owningScanDirectories(root, changed)) {
+                toScan.insert(owner);
+            }
+        }
+        
+        for (const QString& dirPath : std::as_const(toScan)) {
+            if (!cache.stampTree.contains(dirPath)) {
+                continue;
+            }
+            QList<ResourceItem> items;
+            rescanDirectory(location, root, dirPath, [&items](const ResourceItem& item) {
+                items.append(item);
+            });
+            for (const auto row : cache.dirRows.value(dirPath)) {
+                cache.itemTable.remove(row);
+            }
+            cache.dirRows.insert(dirPath, cache.itemTable.append(items));
+        }
+        
+        if (!changes.isEmpty()) {
+            qDebug() << "ResourceScanner: Rescanned" << toScan.size()
+                     << "folders under" << root;
+        }
+        
+        // Collect cached items of this root in path order
+        for (auto it = cache.dirRows.lowerBound(root); it != cache.dirRows.end(); ++it) {
+            if (it.key() != root && !it.key().startsWith(root + QLatin1Char('/'))) {
+                break;
+            }
+            for (const auto row : it.value()) {
+                result.items.append(cache.itemTable.item(row));
+            }
+        }
     }
+    return result;
+}
+
+QList<ResourceItem> ResourceScanner::rescanLocations(
+    const QList<platformInfo::ResourceLocation>& locations,
+    DirectoryStampTree::UpdateMode mode)
+{
+    QList<ResourceItem> results;
+    QStringList watchAdd;
+    QStringList watchRemove;
     
-    // Recurse into subfolders (for templates, this extends the category)
-    QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& subfolder : subfolders) {
-        // Skip common non-resource folders
-        if (subfolder == QLatin1String("build") || 
-            subfolder == QLatin1String(".git") ||
-            subfolder == QLatin1String("node_modules")) {
-            continue;
+    for (const auto& loc : locations) {
+        const std::shared_ptr<LocationCache> cache = locationCache(loc.path());
+        QMutexLocker lock(&cache->mutex);
+        RescanResult result = rescanLocation(loc, *cache, mode);
+        results += std::move(result.items);
+        watchAdd += result.changedDirs;
+        watchRemove += result.removedDirs;
+    }
+    
+    updateWatches(watchAdd, watchRemove);
+    return results;
+}
+
+QStringList ResourceScanner::rescanLocationsWithDeadline(
+    const QList<platformInfo::ResourceLocation>& locations,
+    DirectoryStampTree::UpdateMode mode,
+    LocationCallback onLocationRescanned)
+{
+    bool anyDeadline = false;
+    for (const auto& loc : locations) {
+        anyDeadline = anyDeadline || locationDeadline(loc.path()) > 0;
+    }
+    if (!anyDeadline) {
+        for (const auto& loc : locations) {
+            const QList<ResourceItem> items = rescanLocations({loc}, mode);
+            if (onLocationRescanned) {
+                onLocationRescanned(loc, items);
+            }
         }
+        return {};
+    }
+    
+    reserveThreads(m_backgroundPool, int(locations.size()));
+    QList<std::shared_ptr<LocationJob>> jobs;
+    for (const auto& loc : locations) {
+        auto job = std::make_shared<LocationJob>();
+        jobs.append(job);
+        m_backgroundPool->start([background = m_background, cache = locationCache(loc.path()),
+                                 loc, mode, job, onLocationRescanned]() {
+            startJob(*job);
+            
+            // Held until the result is posted, so results of one location
+            // are delivered in the order the rescans were requested
+            QMutexLocker cacheLock(&cache->mutex);
+            RescanResult result;
+            {
+                ResourceScanner scanner;
+                scanner.m_cancelled = &background->cancelled;
+                result = scanner.rescanLocation(loc, *cache, mode);
+            }
+            
+            QMutexLocker lock(&job->mutex);
+            job->done = true;
+            job->thread = nullptr;
+            if (!job->deferred) {
+                job->items = std::move(result.items);
+                job->changedDirs = std::move(result.changedDirs);
+                job->removedDirs = std::move(result.removedDirs);
+                job->finished.wakeAll();
+                return;
+            }
+            lock.unlock();
+            
+            QMutexLocker ownerLock(&background->mutex);
+            if (ResourceScanner* owner = background->owner) {
+                QMetaObject::invokeMethod(owner, [owner, loc, result, onLocationRescanned]() {
+                    qDebug() << "ResourceScanner: Background rescan of" << loc.path() << "finished with"
+                             << result.items.size() << "items";
+                    owner->updateWatches(result.changedDirs, result.removedDirs);
+                    if (onLocationRescanned) {
+                        onLocationRescanned(loc, result.items);
+                    }
+                }, Qt::QueuedConnection);
+            }
+        });
+    }
+    
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QStringList pending;
+    for (int i = 0; i < locations.size(); ++i) {
+        const QString path = QDir::cleanPath(locations[i].path());
+        const int deadline = locationDeadline(path);
+        LocationJob& job = *jobs[i];
         
-        QString newCategory = category.isEmpty() ? subfolder 
-                                                  : (category + QLatin1Char('/') + subfolder);
+        QMutexLocker lock(&job.mutex);
+        if (!waitForJob(job, deadline, elapsed)) {
+            lock.unlock();
+            qDebug() << "ResourceScanner: Rescan of" << path << "exceeded" << deadline
+                     << "ms, continuing in background";
+            pending.append(path);
+            continue;
+        }
         
-        scanFolderRecursive(dir.absoluteFilePath(subfolder), extensions,
-                           type, tier, locationKey, newCategory, results);
+        const QList<ResourceItem> items = std::move(job.items);
+        const QStringList changedDirs = std::move(job.changedDirs);
+        const QStringList removedDirs = std::move(job.removedDirs);
+        lock.unlock();
+        updateWatches(changedDirs, removedDirs);
+        if (onLocationRescanned) {
+            onLocationRescanned(locations[i], items);
+        }
+    }
+    
+    return pending;
+}
+
+void ResourceScanner::updateWatches(const QStringList& add, const QStringList& remove)
+{
+    if (!m_watcher) {
+        return;
+    }
+    const QStringList watchedList = m_watcher->directories();
+    const QSet<QString> watched(watchedList.cbegin(), watchedList.cend());
+    QSet<QString> watchAdd(add.cbegin(), add.cend());
+    QSet<QString> watchRemove(remove.cbegin(), remove.cend());
+    watchAdd.subtract(watched);
+    watchRemove.intersect(watched);
+    if (!watchRemove.isEmpty()) m_watcher->removePaths(watchRemove.values());
+    if (!watchAdd.isEmpty()) m_watcher->addPaths(watchAdd.values());
+}
+
+void ResourceScanner::setWatchEnabled(bool enabled)
+{
+    if (enabled == (m_watcher != nullptr)) {
+        return;
+    }
+    
+    if (!enabled) {
+        delete m_watcher;
+        m_watcher = nullptr;
+        return;
+    }
+    
+    m_watcher = new QFileSystemWatcher(this);
+    QStringList directories;
+    for (const auto& cache : std::as_const(m_locationCaches)) {
+        QMutexLocker lock(&cache->mutex);   // Waits for a running rescan
+        directories += cache->stampTree.directories();
+    }
+    if (!directories.isEmpty()) {
+        m_watcher->addPaths(directories);
+    }
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString& path) {
+        // Flag it for the rescan of the location that contains it
+        for (auto it = m_locationCaches.cbegin(); it != m_locationCaches.cend(); ++it) {
+            if (path == it.key() || path.startsWith(it.key() + QLatin1Char('/'))) {
+                QMutexLocker lock(&it.value()->dirtyMutex);
+                it.value()->dirty.append(path);
+            }
+        }
+        emit resourcesChanged();
+    });
+}
+
+const ResourceScanner::ScanRule* ResourceScanner::ruleForPath(
+    const QString& root,
+    const QString& dirPath,
+    QString& ruleRoot,
+    QStringList& parts) const
+{
+    const QString rootName = QFileInfo(root).fileName();
+    const ScanRule* rule = nullptr;
+    for (ResourceType type : resourceMetadata::s_topLevel) {
+        const ScanRule* candidate = scanRule(type);
+        if (candidate && candidate->subfolder == rootName) {
+            rule = candidate;
+            break;
+        }
+    }
+    if (!rule) {
+        return nullptr;
+    }
+    
+    ruleRoot = root;
+    parts = QDir(root).relativeFilePath(dirPath).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    
+    // Follow delegated sub-resource folders (examples/templates, ...)
+    bool delegated = true;
+    while (delegated && !parts.isEmpty() && rule->recursion == Recursion::OneLevel) {
+        delegated = false;
+        for (ResourceType type : rule->delegates) {
+            const ScanRule* candidate = scanRule(type);
+            if (candidate && candidate->subfolder.compare(parts.first(), Qt::CaseInsensitive) == 0) {
+                ruleRoot += QLatin1Char('/') + parts.takeFirst();
+                rule = candidate;
+                delegated = true;
+                break;
+            }
+        }
+    }
+    return rule;
+}
+
+QStringList ResourceScanner::owningScanDirectories(const QString& root, const QString& dirPath) const
+{
+    QString ruleRoot;
+    QStringList parts;
+    const ScanRule* rule = ruleForPath(root, dirPath, ruleRoot, parts);
+    if (!rule || rule->recursion == Recursion::None) {
+        return {};
+    }
+    
+    if (parts.isEmpty()) {
+        return {dirPath};
+    }
+    
+    switch (rule->recursion) {
+        case Recursion::OneLevel:
+            // Groups are one level deep; anything below is a data folder of
+            // a script in the group. A group may also be the data folder of a
+            // top-level script.
+            if (parts.size() == 1) {
+                return {dirPath, ruleRoot};
+            }
+            return {ruleRoot + QLatin1Char('/') + parts.first()};
+        case Recursion::Recursive:
+            // Every folder is a category; with attachments a change may also
+            // alter the data folder of a script in the parent folder (for
+            // category attachments, only if the parent is a category)
+            if (rule->attachmentFilters.isEmpty()
+                && (rule->categoryAttachmentFilters.isEmpty() || parts.size() < 2)) {
+                return {dirPath};
+            }
+            return {dirPath, QFileInfo(dirPath).absolutePath()};
+        default:
+            return {};
+    }
+}
+
+void ResourceScanner::rescanDirectory(
+    const platformInfo::ResourceLocation& location,
+    const QString& root,
+    const QString& dirPath,
+    const ItemCallback& onItemFound)
+{
+    QString ruleRoot;
+    QStringList parts;
+    const ScanRule* rule = ruleForPath(root, dirPath, ruleRoot, parts);
+    if (!rule || rule->recursion == Recursion::None) {
+        return;
+    }
+    
+    const ResourceTier tier = location.tier();
+    const QString locationKey = location.getDisplayName();
+    
+    if (parts.isEmpty()) {
+        scanRuleFolder(*rule, dirPath, tier, locationKey, QString(), 0, false, onItemFound);
+        return;
     }
+    
+    switch (rule->recursion) {
+        case Recursion::OneLevel: {
+            if (parts.size() != 1) {
+                return;
+            }
+            // Group folder, unless the root manifest restricts the categories
+            ExampleDirManifest rootManifest;
+            if (ExampleDirManifest::loadTrusted(ruleRoot, rootManifest)
+                && rootManifest.hasCategories && !rootManifest.categories.contains(parts.first())) {
+                return;
+            }
+            scanRuleFolder(*rule, dirPath, tier, locationKey, parts.first(), 1, false, onItemFound);
+            return;
+        }
+        case Recursion::Recursive:
+            for (const QString& part : std::as_const(parts)) {
+                if (kSkippedFolders.contains(part)) {
+                    return;
+                }
+            }
+            scanRuleFolder(*rule, dirPath, tier, locationKey, parts.join(QLatin1Char('/')),
+                           int(parts.size()), false, onItemFound);
+            return;
+        default:
+            return;
+    }
+}
+
+ResourceScript ResourceScanner::makeScript(
+    const QString& scriptPath,
+    ResourceType type,
+    ResourceTier tier,
+    const QString& locationKey)
+{
+    ResourceScript script(scriptPath);
+    script.setType(type);
+    script.setTier(tier);
+    script.setScriptPath(scriptPath);
+    script.setSourcePath(scriptPath);
+    script.setSourceLocationKey(locationKey);
+    script.setAccess(type == ResourceType::Templates ? ResourceAccess::ReadWrite 
+                                                     : ResourceAccess::ReadOnly);
+    return script;
 }
 
 } // namespace resourceInventory
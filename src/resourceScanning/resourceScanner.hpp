@@ -5,12 +5,20 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QPointer>
+#include <QThreadPool>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include "resourceInventory/resourceItem.hpp"
+#include "resourceInventory/scanDiff.hpp"
 #include "platformInfo/ResourceLocation.hpp"
+#include "directoryStampTree.hpp"
 #include "export.hpp"
 
 class QStandardItemModel;
+class QFileSystemWatcher;
 
 namespace resourceInventory {
 
@@ -27,6 +35,11 @@ namespace resourceInventory {
  * - libraries/       -> Library folders (each containing .scad files)
  * - templates/       -> Template .scad files (subfolders = categories)
  * - locale/          -> Translation files
+ * 
+ * All folder types are scanned by one table-driven engine: each type's
+ * ScanRule (subfolder, primary extensions, attachments and recursion
+ * policy) is derived from ResourceTypeInfo. The per-type methods below
+ * are thin adapters over scanType().
  */
 class RESOURCESCANNING_API ResourceScanner : public QObject {
     Q_OBJECT
@@ -35,7 +48,68 @@ public:
     // Callback for streaming resource items as they're discovered
     using ItemCallback = std::function<void(const ResourceItem&)>;
     
+    // Callback receiving all items of one rescanned location
+    using LocationCallback = std::function<void(const platformInfo::ResourceLocation& location,
+                                                const QList<ResourceItem>& items)>;
+    
+    /**
+     * @brief Custom roles of the items added to a QStandardItemModel
+     */
+    enum ItemRole {
+        ItemDataRole = Qt::UserRole,    ///< Full ResourceItem
+        TypeRole = Qt::UserRole + 1,
+        TierRole = Qt::UserRole + 2,
+        PathRole = Qt::UserRole + 3,
+        CategoryRole = Qt::UserRole + 4,
+        AccessRole = Qt::UserRole + 5,
+        LocationKeyRole = Qt::UserRole + 6,
+        PendingRole = Qt::UserRole + 7  ///< Placeholder of a location still scanning
+    };
+    
+    /**
+     * @brief How far the scan engine descends below a type's folder
+     */
+    enum class Recursion {
+        None,       ///< Not discovered by this scanner (handled elsewhere)
+        Flat,       ///< Files directly in the folder only
+        OneLevel,   ///< Top-level files plus one level of group folders
+        Recursive   ///< All subfolders; the relative path is the category
+    };
+    
+    /**
+     * @brief One row of the scan table, derived from ResourceTypeInfo
+     */
+    struct ScanRule {
+        ResourceType type = ResourceType::Unknown;
+        QString subfolder;              ///< Folder below the location root
+        QStringList nameFilters;        ///< "*.ext" patterns of primary files
+        QStringList attachmentFilters;  ///< "*.ext" patterns of attachments
+        QStringList categoryAttachmentFilters;  ///< Attachments of scripts in category folders only
+        Recursion recursion = Recursion::None;
+        ResourceAccess access = ResourceAccess::ReadOnly;
+        QList<ResourceType> delegates;  ///< Sub-types whose folder is scanned by their own rule
+        bool listPacks = false;         ///< List the entries of compiled template packs
+    };
+    
+    /**
+     * @brief Scan rule for a resource type (nullptr for Unknown/Group)
+     */
+    static const ScanRule* scanRule(ResourceType type);
+    
     explicit ResourceScanner(QObject* parent = nullptr);
+    ~ResourceScanner() override;
+    
+    /**
+     * @brief Scan a single location for a specific resource type (streaming)
+     * @param location The ResourceLocation to scan
+     * @param type The type of resource to look for
+     * @param tier The tier this location belongs to
+     * @param onItemFound Callback invoked for each discovered item
+     */
+    void scanLocation(const platformInfo::ResourceLocation& location,
+                      ResourceType type,
+                      ResourceTier tier,
+                      ItemCallback onItemFound);
     
     /**
      * @brief Scan a single location for a specific resource type
@@ -48,6 +122,24 @@ public:
                                         ResourceType type,
                                         ResourceTier tier);
     
+    /**
+     * @brief Scan a folder with the rule of a resource type (streaming)
+     * @param type The resource type whose ScanRule drives the scan
+     * @param basePath The type's folder (e.g. ".../examples")
+     * @param tier The resource tier
+     * @param locationKey Display name of the location
+     * @param onItemFound Callback invoked for each discovered item
+     * 
+     * Every folder is listed once; primary files, attachment candidates and
+     * subfolders are split from that single listing and items are emitted
+     * directly to the callback.
+     */
+    void scanType(ResourceType type,
+                  const QString& basePath,
+                  ResourceTier tier,
+                  const QString& locationKey,
+                  ItemCallback onItemFound);
+    
     // ========================================================================
     // NEW CALLBACK-BASED API (Phase 1)
     // ========================================================================
@@ -133,10 +225,156 @@ public:
      * 
      * High-level method that iterates all locations and resource types,
      * streaming items directly to the model using callback pattern.
+     * Locations exceeding their deadline appear as pending placeholders
+     * (see scanLocationsWithDeadline() and addPendingToModel()).
      */
     void scanToModel(QStandardItemModel* model,
                      const QList<platformInfo::ResourceLocation>& locations);
     
+    /**
+     * @brief Scan all resource locations, streaming items to a callback
+     * @param locations Resource locations to scan
+     * @param onItemFound Callback invoked for each discovered item
+     * 
+     * Same traversal as scanToModel(); used when items must be collected
+     * (e.g. to publish an inventory snapshot) before reaching a model.
+     */
+    void scanLocations(const QList<platformInfo::ResourceLocation>& locations,
+                       ItemCallback onItemFound);
+    
+    /**
+     * @brief Scan locations, deferring those that exceed their deadline
+     * @param locations Resource locations to scan
+     * @param onItemFound Callback invoked (on the calling thread) for the
+     *                    items of every location that finished in time
+     * @return Paths of the locations still scanning in the background
+     * 
+     * Every location is scanned concurrently on the scanner's background
+     * pool, so a slow location (network share, cold mount) never delays
+     * the others. The caller waits at most for the location's deadline;
+     * a location still scanning then is reported as pending, its thread
+     * drops to low priority and its items arrive later through
+     * locationScanFinished(). Without any deadline configured this is
+     * scanLocations() and returns an empty list.
+     * 
+     * Background scans run on scanners of their own. Destroying this
+     * scanner cancels them between folders and waits briefly; a scan
+     * still blocked in the file system is then left behind rather than
+     * holding up shutdown, and its results are dropped.
+     */
+    QStringList scanLocationsWithDeadline(const QList<platformInfo::ResourceLocation>& locations,
+                                          ItemCallback onItemFound);
+    
+    /**
+     * @brief Deadline applied to every location without its own deadline
+     * @param msecs Budget in milliseconds; 0 disables deferring
+     */
+    void setDefaultLocationDeadline(int msecs) { m_defaultDeadline = msecs; }
+    
+    /**
+     * @brief Deadline of one location (e.g. a known network path)
+     * @param path Location root path
+     * @param msecs Budget in milliseconds; 0 waits for the location
+     */
+    void setLocationDeadline(const QString& path, int msecs);
+    
+    /// Deadline applied to a location in milliseconds (0 = none)
+    int locationDeadline(const QString& path) const;
+    
+    /// Locations whose background scan has not finished yet
+    QStringList pendingLocations() const { return m_pendingModels.keys(); }
+    
+    /**
+     * @brief Show pending locations in a model until their items arrive
+     * @param model The model to populate
+     * @param paths Pending location paths from scanLocationsWithDeadline()
+     * 
+     * Adds one placeholder row per location (PendingRole set). When the
+     * location finishes, the placeholder is replaced by its items; if the
+     * model was rebuilt meanwhile (placeholder gone) nothing is added.
+     */
+    void addPendingToModel(QStandardItemModel* model, const QStringList& paths);
+    
+    /**
+     * @brief Block until all background location scans finished
+     * @param msecs Maximum time to wait, -1 for no limit
+     * @return true if no scan is running anymore
+     * 
+     * Results are still delivered through the event loop.
+     */
+    bool waitForPendingScans(int msecs = -1);
+    
+    /**
+     * @brief Add previously discovered items to a model
+     * @param model The model to populate
+     * @param items Items from a scan or an inventory snapshot
+     */
+    void addItemsToModel(QStandardItemModel* model, const QList<ResourceItem>& items);
+    
+    /**
+     * @brief Items currently shown in a model (placeholders excluded)
+     * @param model A model filled by addItemsToModel()/scanToModel()
+     * @return Items in row order
+     */
+    static QList<ResourceItem> itemsInModel(const QStandardItemModel* model);
+    
+    /**
+     * @brief Apply a scan diff to a model instead of rebuilding it
+     * @param model A model filled by addItemsToModel()/scanToModel()
+     * @param before Previous results the changes refer to (sorted)
+     * @param after New results the changes refer to (sorted)
+     * @param changes ScanDiff::diff(before, after)
+     * 
+     * Rows are matched by item path and location key. Removed rows are taken out, modified
+     * rows are updated in place (dataChanged) and added items appended, so
+     * selection and persistent indexes of unchanged rows survive.
+     */
+    void applyChangesToModel(QStandardItemModel* model,
+                             const QList<ResourceItem>& before,
+                             const QList<ResourceItem>& after,
+                             const QList<ScanDiff::Change>& changes);
+    
+    /**
+     * @brief Incrementally rescan locations (templates and examples)
+     * @param locations Resource locations to scan
+     * @return All items of the locations, in path order
+     * 
+     * The scanner keeps, per location, a DirectoryStampTree and the items
+     * found per folder (as rows of a ResourceTable). Every known folder is
+     * stat'ed; only folders whose stamp changed (or that were flagged by
+     * the file watcher) are listed again, and items of unchanged folders
+     * are reused. The first call, and every Full call (an explicit
+     * refresh), scans everything. Blocks until every location is done;
+     * see rescanLocationsWithDeadline() for the UI.
+     */
+    QList<ResourceItem> rescanLocations(const QList<platformInfo::ResourceLocation>& locations,
+                                        DirectoryStampTree::UpdateMode mode = DirectoryStampTree::UpdateMode::Incremental);
+    
+    /**
+     * @brief rescanLocations() with the deadlines of scanLocationsWithDeadline()
+     * @param onLocationRescanned Called on the scanner's thread with the
+     *        items of each location (in path order): before returning for
+     *        locations that finished within their deadline, through the
+     *        event loop for the others
+     * @return Paths of the locations still rescanning in the background
+     * 
+     * Every location is rescanned on the background pool. Rescans of one
+     * location run one at a time, in the order they were requested, and
+     * its results are delivered in that order. Without any deadline
+     * configured, every location is rescanned on the calling thread.
+     */
+    QStringList rescanLocationsWithDeadline(const QList<platformInfo::ResourceLocation>& locations,
+                                            DirectoryStampTree::UpdateMode mode,
+                                            LocationCallback onLocationRescanned);
+    
+    /**
+     * @brief Watch rescanned folders and flag them dirty when they change
+     * 
+     * Emits resourcesChanged(); the next rescanLocations() picks up the
+     * flagged folders even when their mtime did not change.
+     */
+    void setWatchEnabled(bool enabled);
+    
     // ========================================================================
     // LEGACY API (to be removed in Phase 5)
     // ========================================================================
@@ -160,41 +398,76 @@ signals:
     void locationScanned(const QString& path, int itemCount);
     void scanCompleted(ResourceType type, int totalItems);
     void scanError(const QString& message);
+    void resourcesChanged();
+    void locationPending(const QString& path);
+    void locationScanFinished(const QString& path, const QList<ResourceItem>& items);
+    void pendingScansFinished();   // Every deferred location finished, whatever its tier
 
 private:
     // Helper to add item to QStandardItemModel with custom roles
     void addItemToModel(QStandardItemModel* model, const ResourceItem& item);
     
-    // Scanning methods for specific types (LEGACY - returns vectors)
-    QList<ResourceItem> scanColorSchemes(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanRenderColors(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanEditorColors(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanFonts(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanExamples(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanTests(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    QList<ResourceItem> scanTranslations(const QString& basePath, ResourceTier tier, const QString& locationKey);
-    
-    // Helper for scanning script files with attachments
-    ResourceScript scanScriptWithAttachments(const QString& scriptPath, 
-                                              ResourceType type,
-                                              ResourceTier tier, 
-                                              const QString& locationKey);
+    // Scan engine: emit the items of one folder and, if recurse is set,
+    // descend according to the rule's recursion policy
+    void scanRuleFolder(const ScanRule& rule,
+                        const QString& folderPath,
+                        ResourceTier tier,
+                        const QString& locationKey,
+                        const QString& category,
+                        int depth,
+                        bool recurse,
+                        const ItemCallback& onItemFound);
     
-    // Helper for scanning a Group folder (category with .scad files, no recursion)
-    void scanGroup(const QString& groupPath,
-                   ResourceTier tier,
-                   const QString& locationKey,
-                   const QString& category,
-                   ItemCallback onItemFound);
-    
-    // Helper for recursive folder scanning
-    void scanFolderRecursive(const QString& folderPath,
-                             const QStringList& extensions,
-                             ResourceType type,
-                             ResourceTier tier,
-                             const QString& locationKey,
-                             const QString& category,
-                             QList<ResourceItem>& results);
+    // Helper creating a script item without attachments
+    ResourceScript makeScript(const QString& scriptPath,
+                              ResourceType type,
+                              ResourceTier tier,
+                              const QString& locationKey);
+    
+    // Incremental rescan helpers: folders whose items depend on dirPath,
+    // and the non-recursive scan of one such folder below root
+    QStringList owningScanDirectories(const QString& root, const QString& dirPath) const;
+    void rescanDirectory(const platformInfo::ResourceLocation& location,
+                         const QString& root,
+                         const QString& dirPath,
+                         const ItemCallback& onItemFound);
+    
+    // Merge the late items of a deferred location (on the scanner's thread)
+    void finishPendingLocation(const QString& path, const QList<ResourceItem>& items);
+    
+    // Incremental rescan of one location; the caller holds cache.mutex.
+    // Runs on a background scanner for deadline rescans.
+    struct LocationCache;
+    struct RescanResult {
+        QList<ResourceItem> items;
+        QStringList changedDirs;    // Folders to watch
+        QStringList removedDirs;    // Folders to stop watching
+    };
+    std::shared_ptr<LocationCache> locationCache(const QString& path);
+    RescanResult rescanLocation(const platformInfo::ResourceLocation& location,
+                                LocationCache& cache,
+                                DirectoryStampTree::UpdateMode mode);
+    void updateWatches(const QStringList& add, const QStringList& remove);
+    
+    // Resolve the rule and rule root that own a folder below a type root,
+    // following delegated sub-types (e.g. examples/templates)
+    const ScanRule* ruleForPath(const QString& root,
+                                const QString& dirPath,
+                                QString& ruleRoot,
+                                QStringList& parts) const;
+    
+    // Incremental rescan state, shared with running background rescans
+    QHash<QString, std::shared_ptr<LocationCache>> m_locationCaches;  // By location path
+    QFileSystemWatcher* m_watcher = nullptr;
+    
+    // Deadline scans
+    int m_defaultDeadline = 0;
+    QHash<QString, int> m_locationDeadlines;  // Per-location overrides
+    QHash<QString, QList<QPointer<QStandardItemModel>>> m_pendingModels;  // Pending path -> models showing it
+    struct BackgroundScans;
+    std::shared_ptr<BackgroundScans> m_background;  // Shared with running background scans
+    QThreadPool* m_backgroundPool;                  // Left running on shutdown if a scan hangs
+    const std::atomic_bool* m_cancelled = nullptr;  // Set on the scanners of background scans
 };
 
 } // namespace resourceInventory
@@ -0,0 +1,365 @@
+#include "schemaValidator.hpp"
+#include "exampleDirManifest.hpp"
+#include "templateScanner.hpp"
+
+#include <nlohmann/json.hpp>
+#include <nlohmann/json-schema.hpp>
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonObject>
+
+#include <array>
+#include <memory>
+#include <optional>
+
+namespace resourceInventory {
+
+namespace {
+
+using nlohmann::json;
+using nlohmann::json_schema::json_validator;
+
+const char kLegacyTemplateSchema[] = R"json({
+  "$schema": "http://json-schema.org/draft-07/schema#",
+  "title": "Legacy OpenSCAD template",
+  "type": "object",
+  "required": ["key", "content"],
+  "properties": {
+    "key": { "type": "string", "minLength": 1 },
+    "content": { "type": "string" }
+  }
+})json";
+
+const char kSnippetTemplateSchema[] = R"json({
+  "$schema": "http://json-schema.org/draft-07/schema#",
+  "title": "VS Code snippet templates",
+  "type": "object",
+  "minProperties": 1,
+  "patternProperties": {
+    "^_": {},
+    "^[^_]": {
+      "type": "object",
+      "required": ["prefix", "body"],
+      "properties": {
+        "_format": { "const": "vscode-snippet" },
+        "_source": { "type": "string" },
+        "_version": { "type": "integer", "minimum": 1 },
+        "prefix": { "type": "string", "minLength": 1 },
+        "body": {
+          "oneOf": [
+            { "type": "string" },
+            { "type": "array", "items": { "type": "string" } }
+          ]
+        },
+        "description": { "type": "string" },
+        "scope": {
+          "oneOf": [
+            { "type": "string" },
+            { "type": "array", "items": { "type": "string" } }
+          ]
+        }
+      }
+    }
+  }
+})json";
+
+const char kScannerTemplateSchema[] = R"json({
+  "$schema": "http://json-schema.org/draft-07/schema#",
+  "title": "Template",
+  "type": "object",
+  "required": ["name"],
+  "properties": {
+    "name": { "type": "string", "pattern": "\\S" },
+    "category": { "type": "string" },
+    "parameters": { "type": "array", "items": { "type": "string" } },
+    "body": { "type": "string" }
+  }
+})json";
+
+const char kColorSchemeSchema[] = R"json({
+  "$schema": "http://json-schema.org/draft-07/schema#",
+  "title": "Editor or render color scheme",
+  "type": "object",
+  "required": ["name"],
+  "properties": {
+    "name": { "type": "string", "minLength": 1 },
+    "index": { "type": "integer" },
+    "show-in-gui": { "type": "boolean" },
+    "colors": {
+      "type": "object",
+      "additionalProperties": { "type": ["string", "object", "array"] }
+    }
+  }
+})json";
+
+const char kExampleManifestSchema[] = R"json({
+  "$schema": "http://json-schema.org/draft-07/schema#",
+  "title": "example-dir.json",
+  "type": "object",
+  "properties": {
+    "sort": { "type": "integer" },
+    "name": { "type": "string" },
+    "tooltip": { "type": "string" },
+    "categories": { "type": "array", "items": { "type": "string", "minLength": 1 } },
+    "scripts": {
+      "type": "array",
+      "items": {
+        "oneOf": [
+          { "type": "string", "minLength": 1 },
+          {
+            "type": "object",
+            "required": ["file"],
+            "properties": {
+              "file": { "type": "string", "minLength": 1 },
+              "attachments": { "type": "array", "items": { "type": "string" } }
+            }
+          }
+        ]
+      }
+    }
+  }
+})json";
+
+constexpr size_t kSchemaCount = 5;
+
+// Collects every violation instead of stopping at the first
+class CollectingErrorHandler : public nlohmann::json_schema::basic_error_handler {
+public:
+    struct Error {
+        std::string pointer;
+        std::string message;
+    };
+
+    void error(const json::json_pointer& pointer, const json& instance,
+               const std::string& message) override
+    {
+        basic_error_handler::error(pointer, instance, message);
+        errors.push_back({pointer.to_string(), message});
+    }
+
+    std::vector<Error> errors;
+};
+
+// Validators compiled on first use and shared by all threads; validation
+// only reads them
+class CompiledSchemas {
+public:
+    static const CompiledSchemas& instance()
+    {
+        static const CompiledSchemas schemas;
+        return schemas;
+    }
+
+    const json_validator* validator(SchemaValidator::Schema schema) const
+    {
+        return m_validators[size_t(schema)].get();
+    }
+
+private:
+    CompiledSchemas()
+    {
+        for (size_t i = 0; i < kSchemaCount; ++i) {
+            const auto schema = SchemaValidator::Schema(i);
+            try {
+                auto validator = std::make_unique<json_validator>();
+                validator->set_root_schema(json::parse(SchemaValidator::schemaText(schema).toStdString()));
+                m_validators[i] = std::move(validator);
+            } catch (const std::exception& e) {
+                qWarning() << "SchemaValidator: Cannot compile" << SchemaValidator::schemaName(schema)
+                           << "schema:" << e.what();
+            }
+        }
+    }
+
+    std::array<std::unique_ptr<json_validator>, kSchemaCount> m_validators;
+};
+
+// Schema implied by the file's name or folder, if any
+std::optional<SchemaValidator::Schema> schemaForPath(const QString& filePath)
+{
+    const QFileInfo info(filePath);
+    if (info.fileName() == ExampleDirManifest::fileName) {
+        return SchemaValidator::Schema::ExampleManifest;
+    }
+    if (QDir::fromNativeSeparators(info.absolutePath()).contains(QStringLiteral("/color-schemes"))) {
+        return SchemaValidator::Schema::ColorScheme;
+    }
+    return std::nullopt;
+}
+
+// Templates: the formats differ in their top-level member names
+SchemaValidator::Schema templateSchema(bool hasKey, bool hasContent, bool hasName)
+{
+    if (hasKey && hasContent) {
+        return SchemaValidator::Schema::LegacyTemplate;
+    }
+    if (hasName) {
+        return SchemaValidator::Schema::ScannerTemplate;
+    }
+    return SchemaValidator::Schema::SnippetTemplate;
+}
+
+// Parse the raw content into the schema library's document type; syntax
+// errors are reported at the byte nlohmann stopped at
+bool parseInstance(JsonDiagnostics& diagnostics, json& instance)
+{
+    const QByteArray& content = diagnostics.content();
+    try {
+        instance = json::parse(content.constData(), content.constData() + content.size());
+    } catch (const json::parse_error& e) {
+        diagnostics.add(std::string("Invalid JSON: ") + e.what(), int(e.byte > 0 ? e.byte - 1 : 0));
+        return false;
+    }
+    return true;
+}
+
+bool validateInstance(SchemaValidator::Schema schema, const json& instance, JsonDiagnostics& diagnostics)
+{
+    const std::string name = SchemaValidator::schemaName(schema).toStdString();
+    const json_validator* validator = CompiledSchemas::instance().validator(schema);
+    if (!validator) {
+        diagnostics.add("No compiled " + name + " schema");
+        return false;
+    }
+
+    CollectingErrorHandler handler;
+    try {
+        validator->validate(instance, handler);
+    } catch (const std::exception& e) {
+        diagnostics.add(name + ": " + e.what());
+        return false;
+    }
+
+    for (const auto& error : handler.errors) {
+        std::string message = name + ": " + error.message;
+        if (!error.pointer.empty()) {
+            message += " (at " + error.pointer + ")";
+        }
+        diagnostics.add(message, diagnostics.pointerOffset(QString::fromStdString(error.pointer)));
+    }
+    return handler.errors.empty();
+}
+
+} // namespace
+
+SchemaValidator::Schema SchemaValidator::schemaFor(const QString& filePath, const QByteArray& content)
+{
+    if (const auto schema = schemaForPath(filePath)) {
+        return *schema;
+    }
+
+    QJsonObject members;
+    JsonErrorInfo error;
+    JsonReader::readMembers(content, {QStringLiteral("key"), QStringLiteral("content"), QStringLiteral("name")},
+                            members, error);
+    return templateSchema(members.contains(QStringLiteral("key")), members.contains(QStringLiteral("content")),
+                          members.contains(QStringLiteral("name")));
+}
+
+bool SchemaValidator::check(Schema schema, JsonDiagnostics& diagnostics)
+{
+    json instance;
+    return parseInstance(diagnostics, instance) && validateInstance(schema, instance, diagnostics);
+}
+
+JsonContentChecker SchemaValidator::checker()
+{
+    return [](JsonDiagnostics& diagnostics) {
+        json instance;
+        if (!parseInstance(diagnostics, instance)) {
+            return;
+        }
+        // Sniff template formats on the parsed document, not the raw bytes
+        std::optional<Schema> schema = schemaForPath(QString::fromStdString(diagnostics.filename()));
+        if (!schema) {
+            const auto has = [&instance](const char* key) {
+                return instance.is_object() && instance.find(key) != instance.end();
+            };
+            schema = templateSchema(has("key"), has("content"), has("name"));
+        }
+        validateInstance(*schema, instance, diagnostics);
+    };
+}
+
+JsonContentChecker SchemaValidator::checker(Schema schema)
+{
+    return [schema](JsonDiagnostics& diagnostics) {
+        check(schema, diagnostics);
+    };
+}
+
+std::vector<JsonValidationResult> SchemaValidator::validateFiles(const QStringList& filePaths,
+                                                                 int maxConcurrency)
+{
+    std::vector<std::string> paths;
+    paths.reserve(size_t(filePaths.size()));
+    for (const QString& path : filePaths) {
+        paths.push_back(path.toStdString());
+    }
+    return JsonReader::validateContentMany(paths, checker(), maxConcurrency);
+}
+
+QStringList SchemaValidator::resourceFiles(const platformInfo::ResourceLocation& location)
+{
+    QStringList files;
+    const QDir root(location.path());
+
+    // Templates are flat, color schemes sit in editor/ and render/
+    QDirIterator templates(root.filePath(TemplateScanner::templateSubfolder()), {QStringLiteral("*.json")},
+                           QDir::Files | QDir::Readable);
+    while (templates.hasNext()) {
+        files.append(templates.next());
+    }
+    QDirIterator schemes(root.filePath(QStringLiteral("color-schemes")), {QStringLiteral("*.json")},
+                         QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+    while (schemes.hasNext()) {
+        files.append(schemes.next());
+    }
+    for (const QString& folder : {QStringLiteral("examples"), QStringLiteral("tests")}) {
+        QDirIterator manifests(root.filePath(folder), {ExampleDirManifest::fileName},
+                               QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+        while (manifests.hasNext()) {
+            files.append(manifests.next());
+        }
+    }
+    return files;
+}
+
+QByteArray SchemaValidator::schemaText(Schema schema)
+{
+    switch (schema) {
+    case Schema::LegacyTemplate:
+        return QByteArray(kLegacyTemplateSchema);
+    case Schema::SnippetTemplate:
+        return QByteArray(kSnippetTemplateSchema);
+    case Schema::ScannerTemplate:
+        return QByteArray(kScannerTemplateSchema);
+    case Schema::ColorScheme:
+        return QByteArray(kColorSchemeSchema);
+    case Schema::ExampleManifest:
+        return QByteArray(kExampleManifestSchema);
+    }
+    return QByteArray();
+}
+
+QString SchemaValidator::schemaName(Schema schema)
+{
+    switch (schema) {
+    case Schema::LegacyTemplate:
+        return QStringLiteral("legacy template");
+    case Schema::SnippetTemplate:
+        return QStringLiteral("snippet template");
+    case Schema::ScannerTemplate:
+        return QStringLiteral("template");
+    case Schema::ColorScheme:
+        return QStringLiteral("color scheme");
+    case Schema::ExampleManifest:
+        return QStringLiteral("example manifest");
+    }
+    return QString();
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,96 @@
+#ifndef SCHEMAVALIDATOR_HPP
+#define SCHEMAVALIDATOR_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+#include "../resourceScanning/export.hpp"
+#include "../platformInfo/ResourceLocation.hpp"
+#include "../jsonreader/JsonReader.hpp"
+
+namespace resourceInventory {
+
+/**
+ * @brief JSON-schema validation of resource files
+ *
+ * The structural checks of TemplateScanner only look at the few members
+ * needed for listing. SchemaValidator validates complete files against
+ * draft-07 schemas (json-schema-validator) for every JSON resource kind:
+ *
+ * - LegacyTemplate:  { "key": "...", "content": "..." }
+ * - SnippetTemplate: { "<name>": { "prefix", "body", ... }, ... }
+ * - ScannerTemplate: { "name", "category", "parameters", "body" }
+ * - ColorScheme:     editor and render color schemes
+ * - ExampleManifest: example-dir.json (see ExampleDirManifest)
+ *
+ * Each schema is compiled once per process, on first use, and shared by
+ * all threads. Files are parsed once, straight into nlohmann::json (the
+ * schema library's document type), without a QJsonDocument. Diagnostics are located at the offending value with line
+ * and column (JsonDiagnostics::pointerOffset()).
+ *
+ * Usage (e.g. as a CI gate over a template package):
+ * @code
+ *   const auto results = SchemaValidator::validateFiles(files);
+ *   for (const auto& result : results)
+ *       for (const auto& diagnostic : result.diagnostics)
+ *           std::cerr << diagnostic.formatError() << "\n";
+ * @endcode
+ */
+class RESOURCESCANNING_API SchemaValidator
+{
+public:
+    enum class Schema {
+        LegacyTemplate,
+        SnippetTemplate,
+        ScannerTemplate,
+        ColorScheme,
+        ExampleManifest
+    };
+
+    /**
+     * @brief Pick the schema of a resource file
+     * @param filePath Path of the file (manifest name, color-schemes folder)
+     * @param content Raw bytes; only top-level member names are sniffed
+     */
+    static Schema schemaFor(const QString& filePath, const QByteArray& content);
+
+    /**
+     * @brief Parse and validate the content held by a JsonDiagnostics
+     * @return false on a syntax error or any schema violation
+     *
+     * Thread-safe.
+     */
+    static bool check(Schema schema, JsonDiagnostics& diagnostics);
+
+    /// Checker for JsonReader::validateContentMany(), schema picked per file
+    static JsonContentChecker checker();
+
+    /// Checker validating every file against one schema
+    static JsonContentChecker checker(Schema schema);
+
+    /**
+     * @brief Validate files in parallel, results in input order
+     * @param maxConcurrency Files validated at the same time (0 = ideal thread count)
+     */
+    static std::vector<JsonValidationResult> validateFiles(const QStringList& filePaths,
+                                                           int maxConcurrency = 0);
+
+    /**
+     * @brief JSON resource files of a location: templates, color schemes
+     *        and example manifests
+     */
+    static QStringList resourceFiles(const platformInfo::ResourceLocation& location);
+
+    /// Source of a schema, e.g. to publish it for editors
+    static QByteArray schemaText(Schema schema);
+
+    /// Readable schema name ("snippet template", ...)
+    static QString schemaName(Schema schema);
+};
+
+} // namespace resourceInventory
+
+#endif // SCHEMAVALIDATOR_HPP
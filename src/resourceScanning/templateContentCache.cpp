@@ -0,0 +1,64 @@
+#include "templateContentCache.hpp"
+
+namespace resourceInventory {
+
+size_t qHash(const TemplateContentCache::Key& key, size_t seed)
+{
+    return qHashMulti(seed, key.path, key.size, key.modified);
+}
+
+TemplateContentCache::TemplateContentCache()
+    : m_cache(32 * 1024 * 1024)
+{
+}
+
+TemplateContentCache& TemplateContentCache::instance()
+{
+    static TemplateContentCache cache;
+    return cache;
+}
+
+std::shared_ptr<const TemplateContent> TemplateContentCache::get(const Key& key, const Loader& loader)
+{
+    if (auto cached = m_cache.find(key)) {
+        return *cached;
+    }
+    std::shared_ptr<const TemplateContent> content = loader();
+    if (!content) {
+        return content;
+    }
+    const qint64 bytes = content->byteSize();
+    return m_cache.insert(key, std::move(content), bytes);
+}
+
+void TemplateContentCache::clear()
+{
+    m_cache.clear();
+}
+
+qint64 TemplateContentCache::byteBudget() const
+{
+    return m_cache.byteBudget();
+}
+
+void TemplateContentCache::setByteBudget(qint64 bytes)
+{
+    m_cache.setByteBudget(bytes);
+}
+
+qint64 TemplateContentCache::bytesUsed() const
+{
+    return m_cache.bytesUsed();
+}
+
+qint64 TemplateContentCache::hits() const
+{
+    return m_cache.hits();
+}
+
+qint64 TemplateContentCache::misses() const
+{
+    return m_cache.misses();
+}
+
+} // namespace resourceInventory
@@ -0,0 +1,73 @@
+#ifndef TEMPLATECONTENTCACHE_HPP
+#define TEMPLATECONTENTCACHE_HPP
+
+#include <QHash>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+#include "../platformInfo/export.hpp"
+#include "../resourceInventory/resourceItem.hpp"
+#include "lruByteCache.hpp"
+
+namespace resourceInventory {
+
+/**
+ * @brief Process-wide cache of materialized template content
+ *
+ * Lazy templates (ResourceTemplate::isLazy()) load their body through
+ * this cache. Entries are keyed by source path plus the fingerprint
+ * (size, mtime) seen while listing, so an edited file is never served
+ * from an old entry. The least recently used entries are dropped once
+ * the contents exceed the byte budget; templates holding an entry keep
+ * it alive.
+ *
+ * Thread-safe. Loading happens outside the lock, so two threads asking
+ * for the same missing entry may both load it.
+ */
+class PLATFORMINFO_API TemplateContentCache
+{
+public:
+    struct Key {
+        QString path;               ///< Template file or pack entry path
+        qint64 size = -1;           ///< Size of the file when listed
+        qint64 modified = 0;        ///< mtime in ms since epoch when listed
+
+        bool operator==(const Key& other) const
+        {
+            return size == other.size && modified == other.modified && path == other.path;
+        }
+    };
+
+    using Loader = std::function<std::shared_ptr<const TemplateContent>()>;
+
+    static TemplateContentCache& instance();
+
+    /**
+     * @brief Cached content for key, loading it on a miss
+     * @return nullptr if the loader fails (failures are not cached)
+     */
+    std::shared_ptr<const TemplateContent> get(const Key& key, const Loader& loader);
+
+    /// Drop every entry (e.g. after files were rewritten in place)
+    void clear();
+
+    qint64 byteBudget() const;
+    void setByteBudget(qint64 bytes);   // Default 32 MiB
+
+    qint64 bytesUsed() const;
+    qint64 hits() const;
+    qint64 misses() const;
+
+private:
+    TemplateContentCache();
+
+    LruByteCache<Key, std::shared_ptr<const TemplateContent>> m_cache;
+};
+
+PLATFORMINFO_API size_t qHash(const TemplateContentCache::Key& key, size_t seed = 0);
+
+} // namespace resourceInventory
+
+#endif // TEMPLATECONTENTCACHE_HPP
@@ -1,4 +1,8 @@
 #include "templateScanner.hpp"
+#include "../jsonreader/JsonReader.hpp"
+#include "../resourceInventory/templatePack.hpp"
+#include "parsedTemplateCache.hpp"
+#include "templateContentCache.hpp"
 
 #include <QDir>
 #include <QDirIterator>
@@ -10,21 +14,173 @@
 #include <QJsonValue>
 #include <QDebug>
 #include <QDateTime>
+#include <QThread>
+#include <QThreadPool>
 
-QList<ResourceTemplate> TemplateScanner::scanLocation(const platformInfo::ResourceLocation& location)
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <optional>
+
+namespace {
+
+using resourceInventory::ParsedTemplateCache;
+using resourceInventory::TemplateContent;
+using resourceInventory::TemplateContentCache;
+
+// Files read at the same time by scanLocations() unless the caller says otherwise
+constexpr int kDefaultIoDepth = 4;
+
+// Body, description and scopes of a template file or pack entry.
+// fingerprint: size and mtime of a file seen while listing, if known
+std::shared_ptr<const TemplateContent> readTemplateContent(const QString& path,
+                                                           const TemplateContentCache::Key* fingerprint = nullptr)
 {
-    QList<ResourceTemplate> templates;
+    auto content = std::make_shared<TemplateContent>();
+    
+    // Entry of a compiled pack: read in place from the mapped pack
+    QString packPath;
+    QString prefix;
+    if (resourceInventory::TemplatePack::splitEntryPath(path, packPath, prefix)) {
+        resourceInventory::TemplatePack pack;
+        QString error;
+        if (!pack.open(packPath, &error)) {
+            qWarning() << "TemplateScanner: Cannot load template" << error;
+            return nullptr;
+        }
+        const int index = pack.find(prefix);
+        if (index < 0) {
+            qWarning() << "TemplateScanner: Template" << prefix << "no longer in" << packPath;
+            return nullptr;
+        }
+        content->body = pack.body(index);
+        content->description = pack.description(index);
+        content->scopes = pack.scopes(index);
+        return content;
+    }
+    
+    // Parsed once per change; the editor shares the document
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    const auto parsed = fingerprint ? cache.get(*fingerprint) : cache.get(path);
+    if (!parsed->ok()) {
+        qWarning() << "TemplateScanner: Cannot load template" << QString::fromStdString(parsed->error.formatError());
+        return nullptr;
+    }
+    
+    const QJsonDocument& json = parsed->document;
+    if (!TemplateScanner::validateTemplateJson(json)) {
+        qWarning() << "TemplateScanner: Invalid template structure in" << path;
+        return nullptr;
+    }
+    
+    const ResourceTemplate full = TemplateScanner::extractMetadata(json, path, platformInfo::ResourceLocation());
+    content->body = full.body();
+    content->description = full.description();
+    return content;
+}
+
+// Content reference of a listed template: path plus the fingerprint of
+// the file (or pack) when it was listed
+class TemplateFileSource : public resourceInventory::TemplateContentSource {
+public:
+    // path is the template (or pack entry) path, filePath the file on disk
+    TemplateFileSource(const QString& path, const QString& filePath, qint64 size, qint64 modified)
+        : m_key{path, size, modified}
+        , m_filePath(filePath)
+    {
+    }
+    
+    std::shared_ptr<const TemplateContent> load() const override
+    {
+        TemplateContentCache& cache = TemplateContentCache::instance();
+        std::optional<TemplateContentCache::Key> current;
+        std::shared_ptr<const TemplateContent> content =
+            cache.get(m_key, [this, &current]() -> std::shared_ptr<const TemplateContent> {
+                const QFileInfo info(m_filePath);
+                const TemplateContentCache::Key key{m_key.path, info.size(),
+                                                    info.lastModified().toMSecsSinceEpoch()};
+                if (!info.exists() || !(key == m_key)) {
+                    // Never cache newer content under the listed fingerprint
+                    current = key;
+                    return nullptr;
+                }
+                return readTemplateContent(m_key.path, &m_key);
+            });
+        if (content || !current) {
+            return content;
+        }
+        
+        if (!QFileInfo::exists(m_filePath)) {
+            if (!m_warned.exchange(true)) {
+                qWarning() << "TemplateScanner:" << m_filePath << "was removed since it was listed";
+            }
+            return nullptr;
+        }
+        // Edited since it was listed: the current file, cached under its own fingerprint
+        const TemplateContentCache::Key key = *current;
+        return cache.get(key, [&key]() { return readTemplateContent(key.path, &key); });
+    }
+    
+    bool isAvailable() const override
+    {
+        return QFileInfo::exists(m_filePath);
+    }
+    
+private:
+    TemplateContentCache::Key m_key;
+    QString m_filePath;
+    mutable std::atomic_bool m_warned{false};
+};
+
+// Lazy template from the listing members of a file
+bool makeListedTemplate(const TemplateContentCache::Key& key,
+                        const ParsedTemplateCache::Listing& listing,
+                        const platformInfo::ResourceLocation& location,
+                        ResourceTemplate& tmpl)
+{
+    if (!listing.ok()) {
+        qWarning() << "TemplateScanner: Cannot read template" << QString::fromStdString(listing.error.formatError());
+        return false;
+    }
+    
+    const QJsonDocument members(listing.members);
+    if (!TemplateScanner::validateTemplateJson(members)) {
+        qWarning() << "TemplateScanner: Invalid template structure in" << key.path;
+        return false;
+    }
+    tmpl = TemplateScanner::extractMetadata(members, key.path, location);
+    
+    // Set filesystem metadata
+    tmpl.setExists(true);
+    tmpl.setLastModified(QDateTime::fromMSecsSinceEpoch(key.modified));
+    
+    // Body and parameters are materialized on first access
+    tmpl.setContentSource(std::make_shared<TemplateFileSource>(key.path, key.path, key.size, key.modified));
+    return true;
+}
+
+TemplateContentCache::Key fileKey(const QString& filePath)
+{
+    const QFileInfo info(filePath);
+    return {filePath, info.exists() ? info.size() : -1, info.lastModified().toMSecsSinceEpoch()};
+}
+
+} // namespace
+
+QStringList TemplateScanner::listTemplateFiles(const platformInfo::ResourceLocation& location)
+{
+    QStringList files;
     
     // Build path to templates subfolder
     QString templatesPath = location.path() + "/" + templateSubfolder();
     
-    qDebug() << "TemplateScanner: Scanning" << templatesPath;
-    
     // Check if templates folder exists
     QDir templatesDir(templatesPath);
     if (!templatesDir.exists()) {
         qDebug() << "TemplateScanner: Templates folder does not exist:" << templatesPath;
-        return templates;
+        return files;
     }
     
     // Iterate through .json files in templates folder (flat scan, no recursion)
@@ -33,49 +189,56 @@ QList<ResourceTemplate> TemplateScanner::scanLocation(const platformInfo::Resour
                     QDir::Files | QDir::Readable | QDir::NoDotAndDotDot,
                     QDirIterator::NoIteratorFlags);  // No recursion - templates are flat
     
-    int filesScanned = 0;
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+    return files;
+}
+
+bool TemplateScanner::scanTemplateFile(const QString& filePath,
+                                       const platformInfo::ResourceLocation& location,
+                                       ResourceTemplate& tmpl)
+{
+    // Listing reads only the listing members, through the shared cache the
+    // tree model's repaints hit as well; the body and parameters are parsed
+    // (and validated) when the template is opened
+    const TemplateContentCache::Key key = fileKey(filePath);
+    return makeListedTemplate(key, *ParsedTemplateCache::instance().listing(key), location, tmpl);
+}
+
+bool TemplateScanner::loadContent(ResourceTemplate& tmpl)
+{
+    const std::shared_ptr<const TemplateContent> content =
+        tmpl.isLazy() ? tmpl.contentSource()->load() : readTemplateContent(tmpl.path());
+    if (!content) {
+        return false;
+    }
+    
+    // Shares the cached content; the template now owns it
+    tmpl.setContent(content);
+    if (!content->description.isEmpty()) {
+        tmpl.setDescription(content->description);
+    }
+    return true;
+}
+
+QList<ResourceTemplate> TemplateScanner::scanLocation(const platformInfo::ResourceLocation& location)
+{
+    QList<ResourceTemplate> templates;
+    
+    qDebug() << "TemplateScanner: Scanning" << location.path() + "/" + templateSubfolder();
+    
+    const QStringList files = listTemplateFiles(location);
     int filesValid = 0;
     
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        filesScanned++;
-        
+    for (const QString& filePath : files) {
         qDebug() << "TemplateScanner: Processing" << filePath;
         
-        // Read file contents
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qWarning() << "TemplateScanner: Cannot open file:" << filePath << file.errorString();
-            continue;
-        }
-        
-        QByteArray fileData = file.readAll();
-        file.close();
-        
-        // Parse JSON
-        QJsonParseError parseError;
-        QJsonDocument json = QJsonDocument::fromJson(fileData, &parseError);
-        
-        if (parseError.error != QJsonParseError::NoError) {
-            qWarning() << "TemplateScanner: JSON parse error in" << filePath 
-                      << ":" << parseError.errorString() << "at offset" << parseError.offset;
+        ResourceTemplate tmpl;
+        if (!scanTemplateFile(filePath, location, tmpl)) {
             continue;
         }
         
-        // Validate template structure
-        if (!validateTemplateJson(json)) {
-            qWarning() << "TemplateScanner: Invalid template structure in" << filePath;
-            continue;
-        }
-        
-        // Extract metadata into ResourceTemplate
-        ResourceTemplate tmpl = extractMetadata(json, filePath, location);
-        
-        // Set filesystem metadata
-        QFileInfo fileInfo(filePath);
-        tmpl.setExists(true);
-        tmpl.setLastModified(fileInfo.lastModified());
-        
         templates.append(tmpl);
         filesValid++;
         
@@ -83,86 +246,255 @@ QList<ResourceTemplate> TemplateScanner::scanLocation(const platformInfo::Resour
                 << "category:" << tmpl.category();
     }
     
-    qDebug() << "TemplateScanner: Scanned" << filesScanned << "files," 
+    qDebug() << "TemplateScanner: Scanned" << files.size() << "files," 
             << filesValid << "valid templates found";
     
+    templates.append(scanTemplatePacks(location));
     return templates;
 }
 
-QList<ResourceTemplate> TemplateScanner::scanLocations(const QList<platformInfo::ResourceLocation>& locations)
+QList<ResourceTemplate> TemplateScanner::scanTemplatePacks(const platformInfo::ResourceLocation& location)
 {
-    QList<ResourceTemplate> allTemplates;
+    QList<ResourceTemplate> templates;
+    
+    const QString templatesPath = location.path() + "/" + templateSubfolder();
+    if (!QDir(templatesPath).exists()) {
+        return templates;
+    }
     
-    for (const auto& location : locations) {
-        QString templatesPath = location.path() + "/templates";
-        if (!QDir(templatesPath).exists()) {
-            qDebug() << "TemplateScanner: Skipping non-existent templates folder:" 
-                    << location.getDisplayName();
+    QDirIterator it(templatesPath,
+                    QStringList() << "*" + resourceInventory::TemplatePack::fileExtension,
+                    QDir::Files | QDir::Readable | QDir::NoDotAndDotDot,
+                    QDirIterator::NoIteratorFlags);
+    while (it.hasNext()) {
+        const QString packPath = it.next();
+        
+        resourceInventory::TemplatePack pack;
+        QString error;
+        if (!pack.open(packPath, &error)) {
+            qWarning() << "TemplateScanner:" << error;
             continue;
         }
         
-        QList<ResourceTemplate> locationTemplates = scanLocation(location);
-        allTemplates.append(locationTemplates);
+        const QDateTime lastModified = it.fileInfo().lastModified();
+        const qint64 packSize = it.fileInfo().size();
+        for (int i = 0; i < pack.count(); ++i) {
+            const QString name = pack.name(i).trimmed();
+            if (name.isEmpty()) {
+                continue;  // Same rule as a .json template without a name
+            }
+            
+            // Listing fields only; the body stays in the pack until accessed
+            ResourceTemplate tmpl;
+            const QString prefix = pack.prefix(i);
+            const QString entryPath = resourceInventory::TemplatePack::entryPath(packPath, prefix);
+            tmpl.setName(name);
+            tmpl.setDisplayName(name);
+            tmpl.setCategory(pack.category(i).trimmed());
+            tmpl.setPrefix(prefix);
+            tmpl.setPath(entryPath);
+            tmpl.setTier(location.tier());
+            tmpl.setSourcePath(location.path());
+            tmpl.setSourceLocationKey(location.path());
+            tmpl.setAccess(ResourceAccess::ReadOnly);
+            tmpl.setType(ResourceType::Templates);
+            tmpl.setExists(true);
+            tmpl.setLastModified(lastModified);
+            tmpl.setContentSource(std::make_shared<TemplateFileSource>(entryPath, packPath, packSize,
+                                                                   lastModified.toMSecsSinceEpoch()));
+            templates.append(tmpl);
+        }
+        
+        qDebug() << "TemplateScanner: Pack" << packPath << "listed" << pack.count() << "templates";
+    }
+    
+    return templates;
+}
+
+
+QList<ResourceTemplate> TemplateScanner::scanLocations(
+    const QList<platformInfo::ResourceLocation>& locations,
+    int maxConcurrency,
+    int ioDepth)
+{
+    // Stage 1: list every location (cheap) so the work spans all of them
+    struct Job {
+        QString filePath;
+        int location = 0;
+    };
+    QList<Job> jobs;
+    // Packs are read in place while listing; their entries follow the
+    // files of the same location, as in scanLocation()
+    QList<QList<ResourceTemplate>> packTemplates(locations.size());
+    int packTemplateCount = 0;
+    for (int i = 0; i < locations.size(); ++i) {
+        for (const QString& filePath : listTemplateFiles(locations[i])) {
+            jobs.append({filePath, i});
+        }
+        packTemplates[i] = scanTemplatePacks(locations[i]);
+        packTemplateCount += packTemplates[i].size();
+    }
+    if (jobs.isEmpty() && packTemplateCount == 0) {
+        return {};
+    }
+    
+    // A file between the reader and parser stages: its cached listing, or
+    // the bytes to scan (null if it could not be read)
+    struct ReadFile {
+        int index = 0;
+        TemplateContentCache::Key key;
+        std::shared_ptr<const ParsedTemplateCache::Listing> listing;
+        std::shared_ptr<const JsonFileContent> file;
+    };
+    
+    const int jobCount = int(jobs.size());
+    const int parsers = qBound(1, maxConcurrency > 0 ? maxConcurrency : QThread::idealThreadCount(),
+                               qMax(1, jobCount));
+    const int readers = qBound(1, ioDepth > 0 ? ioDepth : kDefaultIoDepth, qMax(1, jobCount));
+    const size_t queueDepth = size_t(2 * parsers);
+    
+    QList<ResourceTemplate> results(jobs.size());
+    QList<char> valid(jobs.size(), 0);
+    // Detached once here; parsers only touch the elements of their files
+    ResourceTemplate* resultData = results.data();
+    char* validData = valid.data();
+    
+    std::atomic<int> next{0};
+    QMutex mutex;
+    QWaitCondition readable;    // Queue not empty, or every reader finished
+    QWaitCondition writable;    // Queue below queueDepth
+    std::deque<ReadFile> queue;
+    int readersLeft = readers;
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    
+    QThreadPool pool;
+    pool.setMaxThreadCount(readers + parsers);  // All stages run at once
+    
+    // Stage 2 (I/O): at most `readers` files are read at a time, and at
+    // most queueDepth read files wait for a parser, which bounds memory
+    for (int r = 0; r < readers; ++r) {
+        pool.start([&]() {
+            for (int index = next.fetch_add(1); index < jobCount; index = next.fetch_add(1)) {
+                ReadFile read;
+                read.index = index;
+                read.key = fileKey(jobs[index].filePath);
+                read.listing = cache.findListing(read.key);
+                if (!read.listing) {
+                    // Installed files are not edited in place, so large ones may be mapped
+                    const bool installed = locations[jobs[index].location].tier()
+                                           == resourceInventory::ResourceTier::Installation;
+                    JsonErrorInfo error;
+                    read.file = JsonFileContent::open(read.key.path.toStdString(), error,
+                                                      installed ? JsonFileContent::Access::MapLarge
+                                                                : JsonFileContent::Access::Read);
+                }
+                
+                QMutexLocker lock(&mutex);
+                while (queue.size() >= queueDepth) {
+                    writable.wait(&mutex);
+                }
+                queue.push_back(std::move(read));
+                readable.wakeOne();
+            }
+            QMutexLocker lock(&mutex);
+            if (--readersLeft == 0) {
+                readable.wakeAll();
+            }
+        });
+    }
+    
+    // Stage 3 (CPU): scan the listing members, validate and extract; the
+    // result lands at the file's index
+    for (int p = 0; p < parsers; ++p) {
+        pool.start([&]() {
+            while (true) {
+                ReadFile read;
+                {
+                    QMutexLocker lock(&mutex);
+                    while (queue.empty() && readersLeft > 0) {
+                        readable.wait(&mutex);
+                    }
+                    if (queue.empty()) {
+                        return;
+                    }
+                    read = std::move(queue.front());
+                    queue.pop_front();
+                    writable.wakeOne();
+                }
+                
+                // An unreadable file goes through listing(key) for its error
+                const auto listing = read.listing ? read.listing
+                                   : read.file    ? cache.listing(read.key, read.file->data())
+                                                  : cache.listing(read.key);
+                read.file.reset();
+                const Job& job = jobs[read.index];
+                validData[read.index] = makeListedTemplate(read.key, *listing, locations[job.location],
+                                                           resultData[read.index]) ? 1 : 0;
+            }
+        });
+    }
+    pool.waitForDone();
+    
+    // Compact in listing order (deterministic)
+    QList<ResourceTemplate> allTemplates;
+    allTemplates.reserve(jobs.size() + packTemplateCount);
+    int job = 0;
+    for (int location = 0; location < locations.size(); ++location) {
+        for (; job < jobs.size() && jobs[job].location == location; ++job) {
+            if (valid[job]) {
+                allTemplates.append(std::move(results[job]));
+            }
+        }
+        allTemplates.append(packTemplates[location]);
     }
     
-    qDebug() << "TemplateScanner: Total templates across all locations:" << allTemplates.size();
+    qDebug() << "TemplateScanner: Scanned" << jobs.size() << "files with" << readers << "readers and"
+             << parsers << "parsers, found" << allTemplates.size() << "templates";
     
     return allTemplates;
 }
 
 bool TemplateScanner::validateTemplateJson(const QJsonDocument& json)
+{
+    std::vector<JsonErrorInfo> errors;
+    JsonDiagnostics diagnostics(std::string(), QByteArray(), errors);
+    checkTemplateJson(json, diagnostics);
+    for (const JsonErrorInfo& error : errors) {
+        qWarning() << "TemplateScanner:" << QString::fromStdString(error.message);
+    }
+    return errors.empty();
+}
+
+void TemplateScanner::checkTemplateJson(const QJsonDocument& json, JsonDiagnostics& diagnostics)
 {
     // Must be an object
     if (!json.isObject()) {
-        qWarning() << "TemplateScanner: JSON is not an object";
-        return false;
+        diagnostics.add("JSON is not an object");
+        return;
     }
     
     QJsonObject obj = json.object();
     
     // REQUIRED: "name" field must exist and be a non-empty string
+    const QJsonValue nameValue = obj.value("name");
     if (!obj.contains("name")) {
-        qWarning() << "TemplateScanner: Missing required 'name' field";
-        return false;
+        diagnostics.add("Missing required 'name' field");
+    } else if (!nameValue.isString()) {
+        diagnostics.add("'name' field is not a string", diagnostics.memberOffset("name"));
+    } else if (nameValue.toString().trimmed().isEmpty()) {
+        diagnostics.add("'name' field is empty", diagnostics.memberOffset("name"));
     }
     
-    QJsonValue nameValue = obj.value("name");
-    if (!nameValue.isString()) {
-        qWarning() << "TemplateScanner: 'name' field is not a string";
-        return false;
+    // OPTIONAL: "category" (string), "parameters" (array), "body" (string)
+    if (obj.contains("category") && !obj.value("category").isString()) {
+        diagnostics.add("'category' field is not a string", diagnostics.memberOffset("category"));
     }
-    
-    QString name = nameValue.toString().trimmed();
-    if (name.isEmpty()) {
-        qWarning() << "TemplateScanner: 'name' field is empty";
-        return false;
+    if (obj.contains("parameters") && !obj.value("parameters").isArray()) {
+        diagnostics.add("'parameters' field is not an array", diagnostics.memberOffset("parameters"));
     }
-    
-    // OPTIONAL: "category" field - if present, must be string
-    if (obj.contains("category")) {
-        if (!obj.value("category").isString()) {
-            qWarning() << "TemplateScanner: 'category' field is not a string";
-            return false;
-        }
+    if (obj.contains("body") && !obj.value("body").isString()) {
+        diagnostics.add("'body' field is not a string", diagnostics.memberOffset("body"));
     }
-    
-    // OPTIONAL: "parameters" field - if present, must be array
-    if (obj.contains("parameters")) {
-        if (!obj.value("parameters").isArray()) {
-            qWarning() << "TemplateScanner: 'parameters' field is not an array";
-            return false;
-        }
-    }
-    
-    // OPTIONAL: "body" field - if present, must be string
-    if (obj.contains("body")) {
-        if (!obj.value("body").isString()) {
-            qWarning() << "TemplateScanner: 'body' field is not a string";
-            return false;
-        }
-    }
-    
-    return true;
 }
 
 ResourceTemplate TemplateScanner::extractMetadata(const QJsonDocument& json,
@@ -222,9 +554,6 @@ ResourceTemplate TemplateScanner::extractMetadata(const QJsonDocument& json,
     // Set resource type
     tmpl.setType(ResourceType::Templates);
     
-    // Store raw JSON text for potential future use
-    tmpl.setRawText(json.toJson(QJsonDocument::Compact));
-    
     return tmpl;
 }
 
@@ -15,6 +15,8 @@ using resourceInventory::ResourceTemplate;
 using resourceInventory::ResourceType;
 using resourceInventory::ResourceAccess;
 
+class JsonDiagnostics;
+
 /**
  * @brief Scanner for OpenSCAD template resources (.json files)
  * 
@@ -43,16 +45,61 @@ public:
      * 
      * Scans the "templates" subfolder within the location for .json files.
      * Each valid template file is parsed, validated, and converted to a ResourceTemplate.
-     * Invalid files are logged but do not abort the scan.
+     * Invalid files are logged but do not abort the scan. Templates of
+     * compiled packs in the same folder follow the .json templates.
      */
     static QList<ResourceTemplate> scanLocation(const platformInfo::ResourceLocation& location);
     
     /**
      * @brief Scan multiple locations for template resources
      * @param locations List of resource locations to scan
-     * @return Combined list of all discovered templates
+     * @param maxConcurrency Files scanned at the same time
+     *                       (0 = QThread::idealThreadCount())
+     * @param ioDepth Files read at the same time (0 = default of 4)
+     * @return Combined list of all discovered templates, in the order of
+     *         scanLocation() over each location
+     * 
+     * The template folders are listed first; the files of all locations
+     * then go through a bounded pipeline: ioDepth readers stat and read
+     * them (skipping files whose listing is cached), at most twice
+     * maxConcurrency read files wait in between, and maxConcurrency
+     * workers scan, validate and extract them. Results are stored by file
+     * position, so the output order does not depend on thread scheduling.
+     */
+    static QList<ResourceTemplate> scanLocations(const QList<platformInfo::ResourceLocation>& locations,
+                                                 int maxConcurrency = 0,
+                                                 int ioDepth = 0);
+    
+    /**
+     * @brief Read, validate and extract the listing metadata of a template file
+     * @param filePath Full path to the .json file
+     * @param location Source location (for tier tracking)
+     * @param tmpl Receives the template on success
+     * @return false if the file cannot be read or is not a valid template
+     * 
+     * Only "name" and "category" are read and validated, through the
+     * listing cache of ParsedTemplateCache (shared with the tree model);
+     * no document of the whole file is built. The template is lazy: its
+     * body and parameters are parsed and validated through
+     * TemplateContentCache on first access (or by loadContent()), so a
+     * file whose body is broken is listed but fails to open. Thread-safe;
+     * scanLocation() lists each file through here.
+     */
+    static bool scanTemplateFile(const QString& filePath,
+                                 const platformInfo::ResourceLocation& location,
+                                 ResourceTemplate& tmpl);
+    
+    /**
+     * @brief Load the body and parameters of a listed template
+     * @param tmpl Template from a scan; body and description are filled in
+     * @return false if the file can no longer be read or is invalid
+     * 
+     * Listing only extracts name and category (see scanTemplateFile());
+     * the file is parsed through ParsedTemplateCache here, when the
+     * template is opened. Lazy templates share the cached content, so this is also
+     * the way to pick up the description.
      */
-    static QList<ResourceTemplate> scanLocations(const QList<platformInfo::ResourceLocation>& locations);
+    static bool loadContent(ResourceTemplate& tmpl);
     
     /**
      * @brief Validate template JSON structure
@@ -66,6 +113,17 @@ public:
      */
     static bool validateTemplateJson(const QJsonDocument& json);
     
+    /**
+     * @brief Report every template structure violation of a document
+     * @param json Parsed JSON document to check
+     * @param diagnostics Receives one entry per violation, located at the
+     *        offending member when the source bytes are known
+     * 
+     * Same rules as validateTemplateJson(), but does not stop at the first
+     * problem; usable as a JsonChecker for JsonReader::validateMany().
+     */
+    static void checkTemplateJson(const QJsonDocument& json, JsonDiagnostics& diagnostics);
+    
     /**
      * @brief Extract metadata from valid JSON into ResourceTemplate
      * @param json Validated JSON document
@@ -93,6 +151,20 @@ public:
      * @return Subfolder name (e.g., "templates")
      */
     static QString templateSubfolder();
+    
+    /**
+     * @brief List the templates of the compiled packs (.stpack) of a location
+     * @param location The resource location to scan
+     * @return Listing metadata (name, category, prefix) of every pack entry
+     * 
+     * Packs are mapped and read in place; the templates are lazy and
+     * read their bodies from the pack on first access.
+     */
+    static QList<ResourceTemplate> scanTemplatePacks(const platformInfo::ResourceLocation& location);
+    
+private:
+    // Template files of a location in directory order (empty if no folder)
+    static QStringList listTemplateFiles(const platformInfo::ResourceLocation& location);
 };
 
 #endif // TEMPLATESCANNER_HPP
@@ -0,0 +1,147 @@
+/**
+ * @file conversion_manifest.cpp
+ * @brief Implementation of ConversionManifest
+ */
+
+#include "conversion_manifest.hpp"
+#include "jsonreader/JsonReader.hpp"
+#include "jsonreader/JsonWriter.hpp"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace scadtemplates {
+
+namespace {
+
+constexpr qint64 kManifestVersion = 1;
+
+} // namespace
+
+const QString ConversionManifest::fileName = QStringLiteral(".legacy-conversion.json");
+
+bool ConversionManifest::load(const QString& outputDir)
+{
+    m_entries.clear();
+
+    const QString path = QDir(outputDir).filePath(fileName);
+    if (!QFileInfo::exists(path)) {
+        return false;
+    }
+
+    QJsonObject root;
+    JsonErrorInfo error;
+    if (!JsonReader::readObject(path.toStdString(), root, error)) {
+        qWarning() << "ConversionManifest: Ignoring unreadable manifest"
+                   << QString::fromStdString(error.formatError());
+        return false;
+    }
+    if (root.value(QStringLiteral("_version")).toInteger() != kManifestVersion) {
+        qDebug() << "ConversionManifest: Ignoring manifest of another version" << path;
+        return false;
+    }
+
+    const QJsonObject sources = root.value(QStringLiteral("sources")).toObject();
+    m_entries.reserve(sources.size());
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+        const QJsonObject obj = it.value().toObject();
+        Entry entry;
+        entry.size = obj.value(QStringLiteral("size")).toInteger(-1);
+        entry.modified = obj.value(QStringLiteral("modified")).toInteger();
+        entry.outputPath = obj.value(QStringLiteral("output")).toString();
+        entry.prefix = obj.value(QStringLiteral("prefix")).toString();
+        entry.legacy = obj.value(QStringLiteral("legacy")).toBool(true);
+        if (entry.size >= 0 && (!entry.legacy || !entry.outputPath.isEmpty())) {
+            m_entries.insert(it.key(), entry);
+        }
+    }
+    return true;
+}
+
+bool ConversionManifest::save(const QString& outputDir, QString* errorMessage) const
+{
+    const QString path = QDir(outputDir).filePath(fileName);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot write %1: %2").arg(path, file.errorString());
+        }
+        return false;
+    }
+
+    // Sorted, so reruns produce the same file
+    QList<QString> sourcePaths = m_entries.keys();
+    std::sort(sourcePaths.begin(), sourcePaths.end());
+
+    JsonWriter writer(&file);
+    writer.beginObject();
+    writer.member(u"_version", kManifestVersion);
+    writer.key(u"sources");
+    writer.beginObject();
+    for (const QString& sourcePath : std::as_const(sourcePaths)) {
+        const Entry& entry = m_entries[sourcePath];
+        writer.key(sourcePath);
+        writer.beginObject();
+        writer.member(u"size", entry.size);
+        writer.member(u"modified", entry.modified);
+        if (entry.legacy) {
+            writer.member(u"output", entry.outputPath);
+            writer.member(u"prefix", entry.prefix);
+        } else {
+            writer.key(u"legacy");
+            writer.value(false);
+        }
+        writer.endObject();
+    }
+    writer.endObject();
+    writer.endObject();
+
+    if (!writer.finish() || !file.commit()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Cannot write %1: %2").arg(path, file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
+
+bool ConversionManifest::isCurrent(const QFileInfo& source, const QString& outputPath,
+                                   const QString& outputDir) const
+{
+    const Entry* entry = find(source.filePath());
+    return entry
+        && entry->legacy
+        && isUnchanged(source)
+        && entry->outputPath == outputPath
+        && QFileInfo::exists(QDir(outputDir).filePath(outputPath));
+}
+
+bool ConversionManifest::isUnchanged(const QFileInfo& source) const
+{
+    const Entry* entry = find(source.filePath());
+    return entry
+        && entry->size == source.size()
+        && entry->modified == source.lastModified().toMSecsSinceEpoch();
+}
+
+const ConversionManifest::Entry* ConversionManifest::find(const QString& sourcePath) const
+{
+    const auto it = m_entries.constFind(sourcePath);
+    return it == m_entries.constEnd() ? nullptr : &it.value();
+}
+
+void ConversionManifest::insert(const QString& sourcePath, const Entry& entry)
+{
+    m_entries.insert(sourcePath, entry);
+}
+
+void ConversionManifest::remove(const QString& sourcePath)
+{
+    m_entries.remove(sourcePath);
+}
+
+} // namespace scadtemplates
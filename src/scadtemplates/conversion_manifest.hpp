@@ -0,0 +1,92 @@
+/**
+ * @file conversion_manifest.hpp
+ * @brief Record of converted legacy templates for incremental migration
+ */
+
+#pragma once
+
+#include "export.hpp"
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class QFileInfo;
+
+namespace scadtemplates {
+
+/**
+ * @brief Source fingerprints and outputs of previous legacy conversions
+ *
+ * Stored as JSON next to the converted templates:
+ * {
+ *   "_version": 1,
+ *   "sources": {
+ *     "/usr/share/openscad/templates/for.json": {
+ *       "size": 83, "modified": 1700000000000,
+ *       "output": "installation/usr-share-openscad-for.json", "prefix": "for"
+ *     },
+ *     "/usr/share/openscad/templates/modern.json": {
+ *       "size": 412, "modified": 1700000000000, "legacy": false
+ *     }
+ *   }
+ * }
+ *
+ * A source whose size and mtime match its entry, and whose output still
+ * exists, does not have to be converted again. Sources that were not
+ * legacy templates are recorded without an output, so they are not read
+ * again until they change. Output paths are relative to the manifest's
+ * folder.
+ */
+class SCADTEMPLATES_API ConversionManifest {
+public:
+    struct Entry {
+        qint64 size = -1;       // Source size when converted
+        qint64 modified = 0;    // Source mtime (ms since epoch) when converted
+        QString outputPath;     // Relative to the manifest folder
+        QString prefix;         // Key of the converted template
+        bool legacy = true;     // false: not a legacy template, nothing was written
+    };
+
+    static const QString fileName;  // ".legacy-conversion.json"
+
+    /**
+     * @brief Read the manifest of a conversion output folder
+     * @return false if there is none or it is unreadable; the manifest is
+     *         then empty and every source is converted
+     */
+    bool load(const QString& outputDir);
+
+    /**
+     * @brief Write the manifest atomically into the output folder
+     * @param errorMessage Receives a description on failure (optional)
+     */
+    bool save(const QString& outputDir, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Whether a source was converted to outputPath in its current state
+     * @param source Current state of the source file
+     * @param outputPath Output path relative to the manifest folder
+     * @param outputDir Manifest folder, to check that the output still exists
+     */
+    bool isCurrent(const QFileInfo& source, const QString& outputPath, const QString& outputDir) const;
+
+    /// Whether a source has the size and mtime of its entry
+    bool isUnchanged(const QFileInfo& source) const;
+
+    /// Entry of a source, or nullptr
+    const Entry* find(const QString& sourcePath) const;
+
+    /// Record a finished conversion
+    void insert(const QString& sourcePath, const Entry& entry);
+
+    /// Forget a source (e.g. it no longer exists)
+    void remove(const QString& sourcePath);
+
+    QList<QString> sources() const { return m_entries.keys(); }
+    int size() const { return int(m_entries.size()); }
+
+private:
+    QHash<QString, Entry> m_entries;
+};
+
+} // namespace scadtemplates
@@ -4,19 +4,257 @@
  */
 
 #include "legacy_template_converter.hpp"
+#include "conversion_manifest.hpp"
 #include "platformInfo/resourceLocationManager.hpp"
 #include "jsonreader/JsonReader.hpp"
+#include "jsonreader/JsonWriter.hpp"
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QJsonDocument>
 #include <QDebug>
 #include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
 
 namespace scadtemplates {
 
+namespace {
+
+QString legacyDescription(const QString& sourceFilePath)
+{
+    QString desc = QStringLiteral("Converted from legacy template");
+    if (!sourceFilePath.isEmpty()) {
+        desc += QStringLiteral(" (") + QFileInfo(sourceFilePath).fileName() + QStringLiteral(")");
+    }
+    return desc;
+}
+
+// Metadata of a template converted from a file; the body is in the output
+void setConvertedMetadata(ResourceTemplate& tmpl, const QString& prefix, const QString& sourceFilePath)
+{
+    tmpl.setPrefix(prefix);
+    tmpl.setName(prefix);
+    tmpl.setDescription(legacyDescription(sourceFilePath));
+    tmpl.setFormat(QStringLiteral("text/scad.template"));
+    tmpl.setSource(QStringLiteral("legacy-converted"));
+}
+
+/**
+ * @brief Split legacy content into snippet body lines in a single pass
+ * 
+ * "^~^" becomes "$0" and both escaped ("\n") and real newlines end a
+ * line - the result of convertCursorMarker() + unescapeNewlines() +
+ * split('\n'). Lines without a marker are passed as views into content;
+ * the others are assembled in `line`, whose capacity is reused.
+ */
+template <typename OnLine>
+void forEachBodyLine(QStringView content, QString& line, OnLine onLine)
+{
+    line.clear();
+    qsizetype runStart = 0;
+    const auto endLine = [&](qsizetype end) {
+        if (line.isEmpty()) {
+            onLine(content.mid(runStart, end - runStart));
+        } else {
+            line.append(content.mid(runStart, end - runStart));
+            onLine(QStringView(line));
+            line.clear();
+        }
+    };
+    
+    const qsizetype size = content.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const QChar c = content[i];
+        if (c == u'^' && i + 2 < size && content[i + 1] == u'~' && content[i + 2] == u'^') {
+            line.append(content.mid(runStart, i - runStart));
+            line.append(u"$0");
+            i += 3;
+            runStart = i;
+        } else if (c == u'\\' && i + 1 < size && content[i + 1] == u'n') {
+            endLine(i);
+            i += 2;
+            runStart = i;
+        } else if (c == u'\n') {
+            endLine(i);
+            i += 1;
+            runStart = i;
+        } else {
+            ++i;
+        }
+    }
+    endLine(size);
+}
+
+/**
+ * @brief Write one modern "prefix": { ... } entry; writeBody writes the lines
+ */
+template <typename WriteBody>
+void writeModernEntry(JsonWriter& writer, const QString& prefix, const QString& description,
+                      WriteBody writeBody)
+{
+    writer.key(prefix);
+    writer.beginObject();
+    writer.member(u"_format", u"vscode-snippet");
+    writer.member(u"_source", u"legacy-converted");
+    writer.member(u"_version", qint64(1));
+    writer.member(u"prefix", prefix);
+    writer.member(u"description", description);
+    writer.key(u"body");
+    writer.beginArray();
+    writeBody();
+    writer.endArray();
+    writer.endObject();
+}
+
+const QString kNotLegacyMessage = QStringLiteral("Not a legacy format (missing 'key' or 'content')");
+
+// How reading or transcoding a legacy source ended
+enum class Outcome { Done, NotLegacy, Failed };
+
+Outcome fail(Outcome outcome, const QString& message, QString* errorMessage)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return outcome;
+}
+
+// Decode the two members of a legacy template from its raw bytes. The
+// whole document is checked, so a truncated or malformed source is not
+// converted; a repeated member takes its last value, as in a full parse.
+Outcome readLegacyMembers(const QByteArray& legacyJson, const QString& sourceFilePath,
+                          QString& key, QString& content, QString* errorMessage)
+{
+    using Token = JsonEventReader::Token;
+    
+    JsonEventReader reader(legacyJson);
+    const auto syntaxError = [&]() {
+        JsonErrorInfo error = reader.error();
+        error.filename = sourceFilePath.toStdString();
+        return fail(Outcome::Failed, QString::fromStdString(error.formatError()), errorMessage);
+    };
+    
+    if (reader.next() != Token::BeginObject) {
+        if (reader.hasError()) return syntaxError();
+        return fail(Outcome::Failed, QStringLiteral("JSON root must be an object"), errorMessage);
+    }
+    
+    QJsonObject members;
+    while (reader.next() == Token::Key) {
+        QString* target = nullptr;
+        QString name;
+        if (reader.textEquals("key")) {
+            target = &key;
+            name = QStringLiteral("key");
+        } else if (reader.textEquals("content")) {
+            target = &content;
+            name = QStringLiteral("content");
+        } else {
+            if (!reader.skipValue()) return syntaxError();
+            continue;
+        }
+        
+        // Values that are not strings read as empty, as QJsonValue::toString() does
+        const Token token = reader.next();
+        if (token == Token::String) {
+            *target = reader.text();
+        } else {
+            target->clear();
+            if ((token == Token::BeginObject || token == Token::BeginArray) && !reader.skipRest()) {
+                return syntaxError();
+            }
+        }
+        if (reader.hasError()) return syntaxError();
+        members.insert(name, QJsonValue());
+    }
+    if (reader.token() != Token::EndObject || reader.next() != Token::End) {
+        return syntaxError();
+    }
+    
+    if (!LegacyTemplateConverter::isLegacyFormat(members)) {
+        return fail(Outcome::NotLegacy, kNotLegacyMessage, errorMessage);
+    }
+    if (key.isEmpty()) {
+        return fail(Outcome::Failed, QStringLiteral("Empty 'key' field"), errorMessage);
+    }
+    return Outcome::Done;
+}
+
+Outcome readLegacyFile(const QString& filePath, QString& key, QString& content, QString* errorMessage)
+{
+    JsonErrorInfo error;
+    const auto input = JsonFileContent::open(filePath.toStdString(), error);
+    if (!input) {
+        return fail(Outcome::Failed, QString::fromStdString(error.formatError()), errorMessage);
+    }
+    return readLegacyMembers(input->data(), filePath, key, content, errorMessage);
+}
+
+// The saveAsModernJson() layout of a decoded legacy template
+bool writeLegacyTemplate(QIODevice* output, const QString& key, const QString& content,
+                         const QString& sourceFilePath, QString* errorMessage)
+{
+    // Small buffer: legacy templates are a few hundred bytes
+    JsonWriter writer(output, 4, qBound<qsizetype>(4096, 2 * (key.size() + content.size()), 64 * 1024));
+    writer.beginObject();
+    QString line;
+    writeModernEntry(writer, key, legacyDescription(sourceFilePath), [&]() {
+        forEachBodyLine(content, line, [&](QStringView bodyLine) { writer.value(bodyLine); });
+    });
+    writer.endObject();
+    if (!writer.finish()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Failed to write output");
+        }
+        return false;
+    }
+    return true;
+}
+
+// transcodeLegacyFile(), telling sources that are not legacy templates apart
+Outcome transcodeFile(const QString& inputPath, const QString& outputPath,
+                      QString& key, QString& content, QString* errorMessage)
+{
+    const Outcome read = readLegacyFile(inputPath, key, content, errorMessage);
+    if (read != Outcome::Done) {
+        return read;
+    }
+    
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(Outcome::Failed, QStringLiteral("Failed to open file for writing: ") + outputPath,
+                    errorMessage);
+    }
+    if (!writeLegacyTemplate(&file, key, content, inputPath, errorMessage)) {
+        file.cancelWriting();
+        return Outcome::Failed;
+    }
+    if (!file.commit()) {
+        return fail(Outcome::Failed, QStringLiteral("Failed to write output file: ") + outputPath,
+                    errorMessage);
+    }
+    return Outcome::Done;
+}
+
+// Template of a converted source, as convertFromLegacyJson() builds it
+void setConvertedTemplate(LegacyTemplateConverter::ConversionResult& result,
+                          const QString& key, const QString& content)
+{
+    setConvertedMetadata(result.convertedTemplate, key, result.sourceFilePath);
+    result.convertedTemplate.setBody(
+        LegacyTemplateConverter::convertContentToBody(content).join(QLatin1Char('\n')));
+    result.rawContent = content;
+}
+
+} // namespace
+
 LegacyTemplateConverter::ConversionResult 
 LegacyTemplateConverter::convertFromLegacyJson(const QJsonObject& legacyJson, const QString& sourceFilePath)
 {
@@ -25,7 +263,7 @@ LegacyTemplateConverter::convertFromLegacyJson(const QJsonObject& legacyJson, co
     
     // Validate legacy format
     if (!isLegacyFormat(legacyJson)) {
-        result.errorMessage = QStringLiteral("Not a legacy format (missing 'key' or 'content')");
+        result.errorMessage = kNotLegacyMessage;
         return result;
     }
     
@@ -52,11 +290,7 @@ LegacyTemplateConverter::convertFromLegacyJson(const QJsonObject& legacyJson, co
     tmpl.setBody(bodyJoined);
     
     // Set description
-    QString desc = QStringLiteral("Converted from legacy template");
-    if (!sourceFilePath.isEmpty()) {
-        desc += QStringLiteral(" (") + QFileInfo(sourceFilePath).fileName() + QStringLiteral(")");
-    }
-    tmpl.setDescription(desc);
+    tmpl.setDescription(legacyDescription(sourceFilePath));
     
     // Set metadata
     tmpl.setFormat(QStringLiteral("text/scad.template"));
@@ -87,16 +321,43 @@ LegacyTemplateConverter::convertFromLegacyFile(const QString& filePath)
     return convertFromLegacyJson(jsonObj, filePath);
 }
 
+bool LegacyTemplateConverter::transcodeLegacyJson(const QByteArray& legacyJson, QIODevice* output,
+                                                  const QString& sourceFilePath,
+                                                  QString* prefix, QString* errorMessage)
+{
+    QString key;
+    QString content;
+    if (readLegacyMembers(legacyJson, sourceFilePath, key, content, errorMessage) != Outcome::Done
+        || !writeLegacyTemplate(output, key, content, sourceFilePath, errorMessage)) {
+        return false;
+    }
+    if (prefix) {
+        *prefix = key;
+    }
+    return true;
+}
+
+bool LegacyTemplateConverter::transcodeLegacyFile(const QString& inputPath, const QString& outputPath,
+                                                  QString* prefix, QString* errorMessage)
+{
+    QString key;
+    QString content;
+    if (transcodeFile(inputPath, outputPath, key, content, errorMessage) != Outcome::Done) {
+        return false;
+    }
+    if (prefix) {
+        *prefix = key;
+    }
+    return true;
+}
+
 QStringList LegacyTemplateConverter::convertContentToBody(const QString& content)
 {
-    // First, convert cursor marker
-    QString processed = convertCursorMarker(content);
-    
-    // Then unescape newlines
-    processed = unescapeNewlines(processed);
-    
-    // Split into lines
-    return processed.split('\n');
+    // Cursor marker and newline rewrites plus the split, in one pass
+    QStringList lines;
+    QString line;
+    forEachBodyLine(content, line, [&](QStringView bodyLine) { lines.append(bodyLine.toString()); });
+    return lines;
 }
 
 QString LegacyTemplateConverter::convertCursorMarker(const QString& text)
@@ -118,10 +379,9 @@ QString LegacyTemplateConverter::unescapeNewlines(const QString& text)
 QList<LegacyTemplateConverter::ConversionResult> 
 LegacyTemplateConverter::discoverAndConvertTemplates(
     const platformInfo::ResourceLocationManager& resourceManager,
-    const QString& outputDir)
+    const QString& outputDir,
+    int maxConcurrency)
 {
-    QList<ConversionResult> results;
-    
     // Structure: outputDir/tier/mangled-filename.json
     QDir baseDir(outputDir);
     if (!baseDir.exists()) {
@@ -140,14 +400,8 @@ LegacyTemplateConverter::discoverAndConvertTemplates(
         { QStringLiteral("user"), resourceManager.enabledUserLocations() }
     };
     
+    QList<ConversionJob> jobs;
     for (const auto& tier : tiers) {
-        // Create tier subdirectory
-        QString tierPath = baseDir.filePath(tier.name);
-        QDir tierDir(tierPath);
-        if (!tierDir.exists()) {
-            tierDir.mkpath(".");
-        }
-        
         // Scan each location in this tier
         for (const auto& location : tier.locations) {
             QString basePath = location.path();
@@ -165,32 +419,159 @@ LegacyTemplateConverter::discoverAndConvertTemplates(
             );
             
             for (const QString& filename : jsonFiles) {
-                QString fullPath = templateDir.filePath(filename);
-                
-                // Convert the file
-                ConversionResult result = convertFromLegacyFile(fullPath);
-                
-                if (result.success) {
-                    // Generate output filename
-                    QString mangledName = manglePathToFilename(fullPath);
-                    QString outputPath = tierDir.filePath(mangledName);
-                    
-                    // Save the converted template
-                    bool saved = saveAsModernJson(result.convertedTemplate, outputPath);
-                    if (saved) {
-                        qDebug() << "Converted and saved:" << fullPath << "->" << outputPath;
-                    } else {
-                        qWarning() << "Failed to save:" << outputPath;
-                        result.success = false;
-                        result.errorMessage = QStringLiteral("Failed to write output file");
+                const QString fullPath = templateDir.filePath(filename);
+                jobs.append({fullPath, tier.name + QLatin1Char('/') + manglePathToFilename(fullPath)});
+            }
+        }
+    }
+    
+    return convertIncrementally(jobs, outputDir, maxConcurrency);
+}
+
+QList<LegacyTemplateConverter::ConversionResult>
+LegacyTemplateConverter::convertIncrementally(const QList<ConversionJob>& jobs,
+                                              const QString& outputDir,
+                                              int maxConcurrency,
+                                              bool withContent)
+{
+    const QDir baseDir(outputDir);
+    ConversionManifest manifest;
+    manifest.load(outputDir);
+    
+    // Stage 1: sources unchanged since the manifest was written are done
+    QList<ConversionResult> results(jobs.size());
+    QList<ConversionManifest::Entry> entries(jobs.size());
+    QList<int> pending;   // Transcoded
+    QList<int> reread;    // Converted before; read for their content only
+    QSet<QString> outputFolders;
+    for (int i = 0; i < jobs.size(); ++i) {
+        const ConversionJob& job = jobs[i];
+        const QFileInfo source(job.sourcePath);
+        ConversionResult& result = results[i];
+        result.sourceFilePath = job.sourcePath;
+        
+        const ConversionManifest::Entry* known = manifest.find(job.sourcePath);
+        if (known && !known->legacy && manifest.isUnchanged(source)) {
+            // Not a legacy template when last read
+            result.errorMessage = kNotLegacyMessage;
+            result.notLegacy = true;
+            result.skipped = true;
+            continue;
+        }
+        if (manifest.isCurrent(source, job.outputPath, outputDir)) {
+            setConvertedMetadata(result.convertedTemplate, known->prefix, job.sourcePath);
+            result.success = true;
+            result.skipped = true;
+            if (withContent) {
+                reread.append(i);
+            }
+            continue;
+        }
+        
+        // Fingerprint taken before converting: a source edited meanwhile is
+        // converted again on the next run
+        entries[i].size = source.size();
+        entries[i].modified = source.lastModified().toMSecsSinceEpoch();
+        entries[i].outputPath = job.outputPath;
+        outputFolders.insert(QFileInfo(baseDir.filePath(job.outputPath)).absolutePath());
+        pending.append(i);
+    }
+    for (const QString& folder : std::as_const(outputFolders)) {
+        QDir().mkpath(folder);
+    }
+    
+    // Stage 2: transcode the changed sources (and read the unchanged ones)
+    // on a bounded pool; each worker only touches the slots of the jobs it
+    // pulls
+    const QList<int> work = pending + reread;
+    if (!work.isEmpty()) {
+        ConversionResult* resultData = results.data();
+        ConversionManifest::Entry* entryData = entries.data();
+        std::atomic<int> next{0};
+        
+        const int workers = qBound(1, maxConcurrency > 0 ? maxConcurrency : QThread::idealThreadCount(),
+                                   int(work.size()));
+        QThreadPool pool;
+        pool.setMaxThreadCount(workers);
+        for (int w = 0; w < workers; ++w) {
+            pool.start([&]() {
+                for (int n = next.fetch_add(1); n < work.size(); n = next.fetch_add(1)) {
+                    const int index = work[n];
+                    const ConversionJob& job = jobs[index];
+                    ConversionResult& result = resultData[index];
+                    QString key;
+                    QString content;
+                    if (result.skipped) {
+                        if (readLegacyFile(job.sourcePath, key, content, nullptr) == Outcome::Done) {
+                            setConvertedTemplate(result, key, content);
+                        }
+                        continue;
+                    }
+                    switch (transcodeFile(job.sourcePath, baseDir.filePath(job.outputPath), key, content,
+                                          &result.errorMessage)) {
+                        case Outcome::Done:
+                            setConvertedTemplate(result, key, content);
+                            entryData[index].prefix = key;
+                            result.success = true;
+                            break;
+                        case Outcome::NotLegacy:
+                            entryData[index].outputPath.clear();
+                            entryData[index].legacy = false;
+                            result.notLegacy = true;
+                            break;
+                        case Outcome::Failed:
+                            break;
                     }
                 }
-                
-                results.append(result);
+            });
+        }
+        pool.waitForDone();
+    }
+    
+    // Stage 3: record the conversions and the sources that are not legacy
+    // templates; sources that are gone or failed are dropped from the manifest
+    QSet<QString> sources;
+    int converted = 0;
+    for (const int index : std::as_const(pending)) {
+        const ConversionJob& job = jobs[index];
+        const ConversionResult& result = results[index];
+        if (result.success) {
+            manifest.insert(job.sourcePath, entries[index]);
+            qDebug() << "Converted and saved:" << job.sourcePath << "->" << job.outputPath;
+            ++converted;
+        } else if (result.notLegacy) {
+            // A source rewritten in the modern format leaves no stale output
+            const ConversionManifest::Entry* previous = manifest.find(job.sourcePath);
+            if (previous && previous->legacy) {
+                QFile::remove(baseDir.filePath(previous->outputPath));
             }
+            manifest.insert(job.sourcePath, entries[index]);
+            qDebug() << "Not a legacy template, left alone:" << job.sourcePath;
+        } else {
+            manifest.remove(job.sourcePath);
+            qWarning() << "Failed to convert:" << job.sourcePath << result.errorMessage;
+        }
+    }
+    for (const ConversionJob& job : jobs) {
+        sources.insert(job.sourcePath);
+    }
+    bool dropped = false;
+    for (const QString& source : manifest.sources()) {
+        if (!sources.contains(source)) {
+            manifest.remove(source);
+            dropped = true;
+        }
+    }
+    
+    if (!pending.isEmpty() || dropped) {
+        QString error;
+        if (!manifest.save(outputDir, &error)) {
+            qWarning() << "LegacyTemplateConverter:" << error;
         }
     }
     
+    qDebug() << "LegacyTemplateConverter: Converted" << converted << "of" << jobs.size() << "files,"
+             << jobs.size() - pending.size() << "unchanged";
     return results;
 }
 
@@ -272,23 +653,28 @@ QJsonObject LegacyTemplateConverter::templateToModernJson(const ResourceTemplate
 
 bool LegacyTemplateConverter::saveAsModernJson(const ResourceTemplate& tmpl, const QString& outputPath)
 {
-    // Convert to JSON
-    QJsonObject json = templateToModernJson(tmpl);
-    
-    // Write to file
-    QFile file(outputPath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << "Failed to open file for writing:" << outputPath;
         return false;
     }
     
-    QJsonDocument doc(json);
-    QByteArray jsonData = doc.toJson(QJsonDocument::Indented);
-    
-    qint64 written = file.write(jsonData);
-    file.close();
+    // Streamed in the templateToModernJson() layout, without a document
+    QString desc = tmpl.description();
+    if (desc.isEmpty()) {
+        desc = QStringLiteral("Converted from legacy OpenSCAD template");
+    }
+    const QString body = tmpl.body();
+    JsonWriter writer(&file, 4);
+    writer.beginObject();
+    writeModernEntry(writer, tmpl.prefix(), desc, [&]() {
+        for (const QStringView line : QStringView(body).tokenize(u'\n')) {
+            writer.value(line);
+        }
+    });
+    writer.endObject();
     
-    if (written == -1) {
+    if (!writer.finish() || !file.commit()) {
         qWarning() << "Failed to write JSON to file:" << outputPath;
         return false;
     }
@@ -12,6 +12,8 @@
 #include <QList>
 #include <optional>
 
+class QIODevice;
+
 using resourceInventory::ResourceTemplate;
 
 namespace platformInfo {
@@ -51,6 +53,16 @@ public:
         ResourceTemplate convertedTemplate;
         QString rawContent;  // Original content for re-conversion
         QString sourceFilePath;  // Where it came from
+        bool skipped = false;  // Unchanged since the last conversion; output not rewritten
+        bool notLegacy = false;  // Source is not a legacy template; nothing was written
+    };
+
+    /**
+     * @brief One legacy file to convert
+     */
+    struct ConversionJob {
+        QString sourcePath;  // Legacy template file
+        QString outputPath;  // Modern file, relative to the output folder
     };
 
     /**
@@ -69,6 +81,33 @@ public:
      */
     static ConversionResult convertFromLegacyFile(const QString& filePath);
 
+    /**
+     * @brief Transcode a legacy template straight to modern snippet JSON
+     * @param legacyJson Raw bytes of a legacy { "key", "content" } file
+     * @param output Device receiving the saveAsModernJson() layout
+     * @param sourceFilePath Original file path, for the description and errors
+     * @param prefix Receives the template key (optional)
+     * @param errorMessage Receives the reason on failure (optional)
+     * @return false if the input is not a valid legacy template or writing failed
+     * 
+     * No document is built: the whole input is syntax-checked token by
+     * token but only the two members are decoded (a repeated member takes
+     * its last value), the cursor marker and newline rewrites run as one
+     * pass over the content, and each body line is written as soon as it
+     * ends. Nothing is written for a truncated or malformed input.
+     */
+    static bool transcodeLegacyJson(const QByteArray& legacyJson, QIODevice* output,
+                                    const QString& sourceFilePath = QString(),
+                                    QString* prefix = nullptr, QString* errorMessage = nullptr);
+
+    /**
+     * @brief transcodeLegacyJson() from one file to another
+     * @param inputPath Legacy template file
+     * @param outputPath Modern snippet file, replaced atomically
+     */
+    static bool transcodeLegacyFile(const QString& inputPath, const QString& outputPath,
+                                    QString* prefix = nullptr, QString* errorMessage = nullptr);
+
     /**
      * @brief Convert content string from legacy format to snippet body
      * @param content Legacy content with \n escapes and ^~^ cursor marker
@@ -95,10 +134,37 @@ public:
      * @param resourceManager Resource location manager with tier locations
      * @param outputDir Base directory for converted templates (e.g., "templates/")
      * @return List of conversion results
+     * 
+     * Collects the .json files of every tier and runs convertIncrementally().
      */
     static QList<ConversionResult> discoverAndConvertTemplates(
         const platformInfo::ResourceLocationManager& resourceManager,
-        const QString& outputDir);
+        const QString& outputDir,
+        int maxConcurrency = 0);
+
+    /**
+     * @brief Convert legacy files, skipping those converted before
+     * @param jobs Sources and their output paths
+     * @param outputDir Folder of the outputs and of the ConversionManifest
+     * @param maxConcurrency Files converted at the same time (0 = ideal thread count)
+     * @param withContent Also read the body of skipped sources
+     * @return One result per job, in job order
+     * 
+     * Sources whose size and mtime match the manifest, and whose output
+     * still exists, are reported as skipped and not written again. The
+     * others are transcoded in parallel (transcodeLegacyFile()); every
+     * output and the manifest are replaced atomically. Sources that are
+     * not legacy templates are recorded too and, until they change, are
+     * skipped without being read (notLegacy).
+     * 
+     * Results carry the template with its body and rawContent; without
+     * withContent, those of skipped sources have only prefix, name and
+     * description.
+     */
+    static QList<ConversionResult> convertIncrementally(const QList<ConversionJob>& jobs,
+                                                        const QString& outputDir,
+                                                        int maxConcurrency = 0,
+                                                        bool withContent = true);
 
     /**
      * @brief Mangle a file path into a safe filename
@@ -5,8 +5,9 @@
 
 #include "scadtemplates/template_manager.hpp"
 #include "scadtemplates/template_parser.hpp"
-#include <algorithm>
-#include <QFile>
+#include <QDebug>
+#include <QSaveFile>
+#include <QSet>
 
 namespace scadtemplates {
 
@@ -16,15 +17,13 @@ bool TemplateManager::addTemplate(const ResourceTemplate& tmpl) {
     }
     
     // Check for duplicate prefix
-    auto it = std::find_if(m_templates.begin(), m_templates.end(),
-        [&tmpl](const ResourceTemplate& t) {
-            return t.prefix() == tmpl.prefix();
-        });
-    
-    if (it != m_templates.end()) {
+    const QString prefix = tmpl.prefix();
+    const auto it = m_index.constFind(prefix);
+    if (it != m_index.constEnd()) {
         // Update existing template
-        *it = tmpl;
+        m_templates[it.value()] = tmpl;
     } else {
+        m_index.insert(prefix, m_templates.size());
         m_templates.append(tmpl);
     }
     
@@ -32,27 +31,20 @@ bool TemplateManager::addTemplate(const ResourceTemplate& tmpl) {
 }
 
 bool TemplateManager::removeTemplate(const QString& prefix) {
-    auto it = std::find_if(m_templates.begin(), m_templates.end(),
-        [&prefix](const ResourceTemplate& t) {
-            return t.prefix() == prefix;
-        });
-    
-    if (it != m_templates.end()) {
-        m_templates.erase(it);
-        return true;
+    const auto it = m_index.constFind(prefix);
+    if (it == m_index.constEnd()) {
+        return false;
     }
     
-    return false;
+    m_templates.removeAt(it.value());
+    rebuildIndex();
+    return true;
 }
 
 std::optional<ResourceTemplate> TemplateManager::findByPrefix(const QString& prefix) const {
-    auto it = std::find_if(m_templates.begin(), m_templates.end(),
-        [&prefix](const ResourceTemplate& t) {
-            return t.prefix() == prefix;
-        });
-    
-    if (it != m_templates.end()) {
-        return *it;
+    const auto it = m_index.constFind(prefix);
+    if (it != m_index.constEnd()) {
+        return m_templates.at(it.value());
     }
     
     return std::nullopt;
@@ -94,32 +86,127 @@ size_t TemplateManager::count() const {
 
 void TemplateManager::clear() {
     m_templates.clear();
+    m_index.clear();
+    m_loadedFiles.clear();
+}
+
+void TemplateManager::rebuildIndex() {
+    m_index.clear();
+    m_index.reserve(m_templates.size());
+    for (qsizetype i = 0; i < m_templates.size(); ++i) {
+        m_index.insert(m_templates.at(i).prefix(), i);
+    }
 }
 
 bool TemplateManager::loadFromFile(const QString& filePath) {
+    return readFile(filePath, false).success;
+}
+
+ReloadResult TemplateManager::reloadFromFile(const QString& filePath) {
+    return readFile(filePath, true);
+}
+
+ReloadResult TemplateManager::readFile(const QString& filePath, bool incremental) {
+    // Entries are applied once the whole file parsed: a file with a
+    // syntax error changes nothing
+    ReloadResult result;
+    QHash<QString, LoadedEntry>& loaded = m_loadedFiles[filePath];
+    
+    // An entry is decoded unless its bytes are unchanged and its template
+    // is still here (it may have been removed or replaced meanwhile)
+    EntryFilter wanted;
+    if (incremental) {
+        wanted = [this, &loaded](const TemplateEntry& entry) {
+            const auto it = loaded.constFind(entry.name);
+            return it == loaded.constEnd() || it->hash != entry.hash
+                || !m_index.contains(it->prefix);
+        };
+    }
+    
+    struct Parsed {
+        TemplateEntry entry;
+        std::optional<ResourceTemplate> tmpl;  // Unset: unchanged
+    };
+    QList<Parsed> entries;
     TemplateParser parser;
-    auto result = parser.parseFile(filePath);
+    const StreamParseResult parsed = parser.parseEntries(filePath, wanted,
+        [&entries](const TemplateEntry& entry, ResourceTemplate* tmpl) {
+            entries.append({entry, tmpl ? std::optional<ResourceTemplate>(std::move(*tmpl)) : std::nullopt});
+            return true;
+        });
+    
+    result.success = parsed.success;
+    result.errorMessage = parsed.errorMessage;
+    if (!parsed.success) {
+        return result;
+    }
     
-    if (result.success) {
-        for (const auto& tmpl : result.templates) {
-            addTemplate(tmpl);
+    QHash<QString, LoadedEntry> seen;
+    for (Parsed& item : entries) {
+        if (!item.tmpl) {
+            seen.insert(item.entry.name, loaded.value(item.entry.name));
+            ++result.unchanged;
+            continue;
+        }
+        // Parsed entries carry no origin; without one they are not valid
+        ResourceTemplate& tmpl = *item.tmpl;
+        tmpl.setPath(filePath);
+        tmpl.setType(resourceInventory::ResourceType::Templates);
+        const bool existed = m_index.contains(tmpl.prefix());
+        if (addTemplate(tmpl)) {
+            seen.insert(item.entry.name, LoadedEntry{item.entry.hash, tmpl.prefix()});
+            (existed ? result.changed : result.added).append(tmpl.prefix());
         }
     }
     
-    return result.success;
+    if (incremental) {
+        // Entries gone from the file (or renamed to another prefix), unless
+        // the prefix now belongs to another entry or file
+        QSet<QString> stillUsed;
+        for (const LoadedEntry& entry : std::as_const(seen)) {
+            stillUsed.insert(entry.prefix);
+        }
+        QSet<QString> gone;
+        for (const LoadedEntry& entry : std::as_const(loaded)) {
+            const auto it = m_index.constFind(entry.prefix);
+            if (!stillUsed.contains(entry.prefix) && it != m_index.constEnd()
+                && m_templates.at(it.value()).path() == filePath) {
+                gone.insert(entry.prefix);
+            }
+        }
+        if (!gone.isEmpty()) {
+            m_templates.removeIf([&gone](const ResourceTemplate& tmpl) {
+                return gone.contains(tmpl.prefix());
+            });
+            rebuildIndex();
+            result.removed = QStringList(gone.cbegin(), gone.cend());
+            result.removed.sort();
+        }
+    }
+    loaded = std::move(seen);
+    return result;
 }
 
 bool TemplateManager::saveToFile(const QString& filePath) const {
-    TemplateParser parser;
-    QString json = parser.toJson(m_templates);
+    // A stale template would be written with an empty body
+    for (const ResourceTemplate& tmpl : m_templates) {
+        if (tmpl.isStale()) {
+            qWarning() << "TemplateManager: Not saving" << filePath << "- cannot read template" << tmpl.prefix();
+            return false;
+        }
+    }
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    // Streamed straight to the file; replaced atomically on commit
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
     
-    file.write(json.toUtf8());
-    return file.error() == QFile::NoError;
+    if (!TemplateParser::writeJson(&file, m_templates)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
 }
 
 } // namespace scadtemplates
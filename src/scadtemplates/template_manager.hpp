@@ -7,7 +7,9 @@
 
 #include "export.hpp"
 #include "../resourceInventory/resourceItem.hpp"
+#include <QHash>
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <optional>
 
@@ -15,6 +17,18 @@ using resourceInventory::ResourceTemplate;
 
 namespace scadtemplates {
 
+/**
+ * @brief What TemplateManager::reloadFromFile() changed
+ */
+struct SCADTEMPLATES_API ReloadResult {
+    bool success = false;
+    QString errorMessage;
+    QStringList added;          // Prefixes of new templates
+    QStringList changed;        // Prefixes of templates replaced in place
+    QStringList removed;        // Prefixes of templates no longer in the file
+    qsizetype unchanged = 0;    // Entries skipped by their hash
+};
+
 /**
  * @brief Manages a collection of templates
  * 
@@ -84,9 +98,25 @@ public:
      * @brief Load templates from a file
      * @param filePath Path to the template file
      * @return true if loading was successful
+     * 
+     * Templates are streamed in (TemplateParser's callback overload), so
+     * no document of a large snippet collection is built. They are added
+     * once the whole file parsed: after a syntax error nothing is added.
      */
     bool loadFromFile(const QString& filePath);
 
+    /**
+     * @brief Bring the templates of a loaded file up to date
+     * @param filePath Path to a file loaded before (or not yet loaded)
+     * @return Success status and the prefixes that were touched
+     *
+     * The hash of every entry is kept from the previous load, so only
+     * entries whose bytes changed are decoded and replaced; unchanged
+     * templates keep their position and are not touched. Templates whose
+     * entry is gone are removed. After a syntax error nothing changes.
+     */
+    ReloadResult reloadFromFile(const QString& filePath);
+
     /**
      * @brief Save templates to a file
      * @param filePath Path to save the templates
@@ -95,7 +125,18 @@ public:
     bool saveToFile(const QString& filePath) const;
 
 private:
+    void rebuildIndex();
+    ReloadResult readFile(const QString& filePath, bool incremental);
+
     QList<ResourceTemplate> m_templates;
+    QHash<QString, qsizetype> m_index;  // Prefix -> position in m_templates
+
+    // Hash and prefix of each entry of a loaded file, by entry name
+    struct LoadedEntry {
+        quint64 hash = 0;
+        QString prefix;
+    };
+    QHash<QString, QHash<QString, LoadedEntry>> m_loadedFiles;
 };
 
 } // namespace scadtemplates
@@ -5,61 +5,60 @@
 
 #include "scadtemplates/template_parser.hpp"
 #include "jsonreader/JsonReader.hpp"
+#include "jsonreader/JsonWriter.hpp"
+#include "resourceInventory/fnvHash.hpp"
+#include "resourceScanning/parsedTemplateCache.hpp"
+#include <QBuffer>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QString>
 
+#include <utility>
+
 namespace scadtemplates {
 
+namespace {
+
+enum class SniffedFormat {
+    Legacy,   ///< { "key": ..., "content": ... }
+    Modern,   ///< Root "_format": "vscode-snippet"
+    Unmarked, ///< No marker: modern if entries have prefix + body
+    Unknown   ///< Root "_format" names another format
+};
+
 /**
- * @brief Check if JSON is in legacy format (has "key" and "content" fields)
+ * @brief Identify the template format from the root's markers
  */
-static bool isLegacyFormat(const QJsonObject& json) {
-    return json.contains("key") && json.contains("content");
+SniffedFormat sniffFormat(const QJsonObject& members)
+{
+    if (members.contains("_format")) {
+        return members.value("_format").toString() == QLatin1String("vscode-snippet")
+                   ? SniffedFormat::Modern : SniffedFormat::Unknown;
+    }
+    if (members.contains("key") && members.contains("content")) {
+        return SniffedFormat::Legacy;
+    }
+    return SniffedFormat::Unmarked;
 }
 
 /**
- * @brief Check if JSON is in modern VS Code snippet format
+ * @brief Identify the template format from the raw bytes
+ *
+ * Only the top-level member names are scanned (values are skipped without
+ * decoding), so streaming can start without a document.
  */
-static bool isModernFormat(const QJsonObject& json) {
-    // Check for format marker first - this is the definitive check
-    if (json.contains("_format")) {
-        QString format = json["_format"].toString();
-        if (format == "vscode-snippet") {
-            return true;
-        }
-        // If _format exists but isn't vscode-snippet, definitely not a template
-        return false;
-    }
-    
-    // Fallback for templates without _format marker (old converted files)
-    // Must have VS Code snippet structure: nested objects with prefix + body array
-    // Be strict to avoid matching unrelated JSON
-    bool hasValidStructure = false;
-    for (auto it = json.begin(); it != json.end(); ++it) {
-        // Skip any top-level fields starting with underscore
-        if (it.key().startsWith('_')) {
-            continue;
-        }
-        
-        if (it.value().isObject()) {
-            QJsonObject inner = it.value().toObject();
-            // Must have "prefix" (string) and "body" (array or string)
-            if (inner.contains("prefix") && inner.contains("body")) {
-                // Additional validation: body should be array for modern format
-                if (inner["body"].isArray() || inner["body"].isString()) {
-                    hasValidStructure = true;
-                    break;
-                }
-            }
-        }
-    }
-    
-    return hasValidStructure;
+SniffedFormat sniffFormat(const QByteArray& content)
+{
+    QJsonObject members;
+    JsonErrorInfo error;
+    JsonReader::readMembers(content, {QStringLiteral("_format"), QStringLiteral("key"),
+                                      QStringLiteral("content")}, members, error);
+    return sniffFormat(members);
 }
-static ResourceTemplate parseLegacyTemplate(const QJsonObject& json) {
+
+ResourceTemplate parseLegacyTemplate(const QJsonObject& json) {
     QString key = json["key"].toString();
     QString content = json["content"].toString();
     
@@ -81,9 +80,12 @@ static ResourceTemplate parseLegacyTemplate(const QJsonObject& json) {
 /**
  * @brief Parse modern template format
  * Modern format: { "template_name": { "prefix": "...", "body": [...], "description": "..." } }
+ * @param hasSnippetShape Set when an entry has both "prefix" and "body",
+ *        which identifies unmarked files in the same walk
  */
-static QList<ResourceTemplate> parseModernTemplate(const QJsonObject& root) {
+QList<ResourceTemplate> parseModernTemplate(const QJsonObject& root, bool& hasSnippetShape) {
     QList<ResourceTemplate> results;
+    hasSnippetShape = false;
     
     // Each key in root is a template name
     for (auto it = root.begin(); it != root.end(); ++it) {
@@ -95,18 +97,26 @@ static QList<ResourceTemplate> parseModernTemplate(const QJsonObject& root) {
         }
         
         QJsonObject templateObj = it.value().toObject();
+        const QJsonValue bodyValue = templateObj["body"];
+        if (templateObj.contains("prefix") && (bodyValue.isArray() || bodyValue.isString())) {
+            hasSnippetShape = true;
+        }
         
         // Extract fields
         QString prefix = templateObj["prefix"].toString(templateName);
         QString description = templateObj["description"].toString(QStringLiteral("Converted from template"));
-        QJsonArray bodyArray = templateObj["body"].toArray();
         
-        // Join body lines
-        QStringList bodyLines;
-        for (const QJsonValue& line : bodyArray) {
-            bodyLines.append(line.toString());
+        // Join body lines; a body given as a single string is one line
+        QString body;
+        if (bodyValue.isString()) {
+            body = bodyValue.toString();
+        } else {
+            QStringList bodyLines;
+            for (const QJsonValue& line : bodyValue.toArray()) {
+                bodyLines.append(line.toString());
+            }
+            body = bodyLines.join('\n');
         }
-        QString body = bodyLines.join('\n');
         
         ResourceTemplate tmpl;
         tmpl.setPrefix(prefix);
@@ -128,97 +138,346 @@ static QList<ResourceTemplate> parseModernTemplate(const QJsonObject& root) {
     return results;
 }
 
-ParseResult TemplateParser::parseJson(const QString& jsonContent) {
+/**
+ * @brief Dispatch a parsed document to the legacy or modern parser
+ */
+ParseResult parseDocument(const QJsonDocument& doc)
+{
     ParseResult result;
     result.success = false;
     
-    if (jsonContent.isEmpty()) {
-        result.errorMessage = QStringLiteral("Empty JSON content");
-        return result;
-    }
-    
-    // Parse JSON
-    QJsonDocument doc = QJsonDocument::fromJson(jsonContent.toUtf8());
     if (!doc.isObject()) {
         result.errorMessage = QStringLiteral("Invalid JSON: not an object");
         return result;
     }
+    const QJsonObject root = doc.object();
+    const SniffedFormat format = sniffFormat(root);
     
-    QJsonObject root = doc.object();
-    
-    // Check format marker first for explicit identification
-    // Supports formats: vscode-snippet (with _source indicating provenance)
-    if (root.contains("_format")) {
-        QString format = root["_format"].toString();
-        if (format == "vscode-snippet") {
-            // Parse as modern format (regardless of _source)
-            auto templates = parseModernTemplate(root);
-            if (!templates.empty()) {
-                result.templates = templates;
-                result.success = true;
-                return result;
-            }
-        }
-    }
-    
-    // Check if it's legacy format
-    if (isLegacyFormat(root)) {
-        // Parse as legacy template
-        ResourceTemplate tmpl = parseLegacyTemplate(root);
-        result.templates.append(tmpl);
+    switch (format) {
+    case SniffedFormat::Legacy:
+        result.templates.append(parseLegacyTemplate(root));
         result.success = true;
         return result;
-    }
-    
-    // Try modern format (even without marker)
-    if (isModernFormat(root)) {
-        auto templates = parseModernTemplate(root);
-        if (!templates.empty()) {
-            result.templates = templates;
+    case SniffedFormat::Modern:
+    case SniffedFormat::Unmarked: {
+        bool hasSnippetShape = false;
+        QList<ResourceTemplate> templates = parseModernTemplate(root, hasSnippetShape);
+        // Unmarked files must look like snippets, to avoid matching unrelated JSON
+        if (!templates.isEmpty() && (format == SniffedFormat::Modern || hasSnippetShape)) {
+            result.templates = std::move(templates);
             result.success = true;
             return result;
         }
+        break;
+    }
+    case SniffedFormat::Unknown:
+        break;
     }
     
     result.errorMessage = QStringLiteral("Failed to identify JSON format (not legacy or modern template)");
     return result;
 }
 
-ParseResult TemplateParser::parseFile(const QString& filePath) {
-    ParseResult result;
-    result.success = false;
-    
-    // Try using JsonReader first (expects std::string)
-    QJsonObject jsonObj;
-    JsonErrorInfo error;
-    if (JsonReader::readObject(filePath.toStdString(), jsonObj, error)) {
-        // Successfully read JSON object, check format
-        if (isLegacyFormat(jsonObj)) {
-            // Legacy format with single template
-            ResourceTemplate tmpl = parseLegacyTemplate(jsonObj);
-            result.templates.append(tmpl);
-            result.success = true;
-            return result;
+/**
+ * @brief Parse once and dispatch to the legacy or modern parser
+ * @param content Raw UTF-8 JSON
+ * @param error Read/parse error of the file, reported as-is when set
+ */
+ParseResult parseContent(const QByteArray& content, JsonErrorInfo& error)
+{
+    QJsonDocument doc;
+    if (!JsonReader::parseContent(content, doc, error)) {
+        ParseResult result;
+        result.success = false;
+        result.errorMessage = QString::fromStdString(error.formatError());
+        return result;
+    }
+    return parseDocument(doc);
+}
+
+/**
+ * @brief Read one modern entry object, its BeginObject already consumed
+ * @param hasSnippetShape Set when the entry has both "prefix" and "body"
+ *
+ * Same fields and defaults as parseModernTemplate(), string bodies included.
+ */
+bool readModernEntry(JsonEventReader& reader, const QString& templateName,
+                     ResourceTemplate& tmpl, bool& hasSnippetShape)
+{
+    using Token = JsonEventReader::Token;
+
+    QString prefix = templateName;
+    QString description = QStringLiteral("Converted from template");
+    QString source = QStringLiteral("vscode-snippet");
+    QString body;
+    bool hasPrefix = false;
+    bool hasBody = false;
+
+    while (reader.next() == Token::Key) {
+        if (reader.textEquals("prefix")) {
+            hasPrefix = true;
+            if (reader.next() == Token::String) {
+                prefix = reader.text();
+            } else if (reader.token() == Token::BeginObject || reader.token() == Token::BeginArray) {
+                if (!reader.skipRest()) return false;
+            }
+        } else if (reader.textEquals("body")) {
+            const Token token = reader.next();
+            if (token == Token::String) {
+                hasBody = true;
+                body = reader.text();
+            } else if (token == Token::BeginArray) {
+                hasBody = true;
+                bool first = true;
+                for (Token line = reader.next(); line != Token::EndArray; line = reader.next()) {
+                    if (line == Token::Error || line == Token::End) return false;
+                    if (!first) body += QLatin1Char('\n');
+                    first = false;
+                    if (line == Token::String) {
+                        body += reader.text();
+                    } else if ((line == Token::BeginObject || line == Token::BeginArray) && !reader.skipRest()) {
+                        return false;
+                    }
+                }
+            } else if (token == Token::BeginObject) {
+                if (!reader.skipRest()) return false;
+            }
+        } else if (reader.textEquals("description")) {
+            if (reader.next() == Token::String) {
+                description = reader.text();
+            } else if (reader.token() == Token::BeginObject || reader.token() == Token::BeginArray) {
+                if (!reader.skipRest()) return false;
+            }
+        } else if (reader.textEquals("_source")) {
+            if (reader.next() == Token::String) {
+                source = reader.text();
+            } else if (reader.token() == Token::BeginObject || reader.token() == Token::BeginArray) {
+                if (!reader.skipRest()) return false;
+            }
+        } else if (!reader.skipValue()) {
+            return false;
         }
-        
-        // Try as modern format (might have multiple templates)
-        auto templates = parseModernTemplate(jsonObj);
-        if (!templates.empty()) {
-            result.templates = templates;
+        if (reader.hasError()) return false;
+    }
+    if (reader.token() != Token::EndObject) return false;
+
+    hasSnippetShape = hasPrefix && hasBody;
+    tmpl = ResourceTemplate();
+    tmpl.setPrefix(prefix);
+    tmpl.setBody(body);
+    tmpl.setDescription(description);
+    tmpl.setName(templateName);
+    tmpl.setFormat(QStringLiteral("text/scad.template"));
+    tmpl.setSource(source);
+    return true;
+}
+
+// Equal bytes mean an unchanged entry
+quint64 entryHash(const char* data, qsizetype size)
+{
+    return resourceInventory::fnv::hash64(data, size_t(size));
+}
+
+void setDefaultEntry(ResourceTemplate& tmpl, const QString& templateName)
+{
+    // Not an entry object: defaults only, as parseModernTemplate() does
+    tmpl.setPrefix(templateName);
+    tmpl.setDescription(QStringLiteral("Converted from template"));
+    tmpl.setName(templateName);
+    tmpl.setFormat(QStringLiteral("text/scad.template"));
+    tmpl.setSource(QStringLiteral("vscode-snippet"));
+}
+
+/**
+ * @brief Stream the entries of a modern or unmarked snippet collection
+ *
+ * Every entry is located and hashed; with a filter, object entries are
+ * first skipped over and only decoded (from their byte range) if the
+ * filter wants them. Skipped entries count as snippet-shaped: a filter
+ * only skips entries it has seen in an accepted file.
+ *
+ * Unmarked files are only accepted once an entry has the snippet shape;
+ * entries before it are held back until then, so unrelated JSON never
+ * reaches the callback. Entries arrive in file order (the DOM path yields
+ * them sorted by name).
+ */
+StreamParseResult streamModernTemplates(const QByteArray& content, SniffedFormat format,
+                                        const EntryFilter& wanted,
+                                        const TemplateEntryCallback& onEntry)
+{
+    using Token = JsonEventReader::Token;
+
+    StreamParseResult result;
+    JsonEventReader reader(content);
+    const auto syntaxError = [&]() {
+        result.errorMessage = QString::fromStdString(reader.error().formatError());
+        return result;
+    };
+
+    if (reader.next() != Token::BeginObject) {
+        if (reader.hasError()) return syntaxError();
+        result.errorMessage = QStringLiteral("Invalid JSON: not an object");
+        return result;
+    }
+
+    struct Pending {
+        TemplateEntry entry;
+        std::optional<ResourceTemplate> tmpl;
+    };
+    bool accepted = format == SniffedFormat::Modern;
+    QList<Pending> pending;
+    while (reader.next() == Token::Key) {
+        const QString templateName = reader.text();
+        if (templateName.startsWith(QLatin1Char('_'))) {
+            if (!reader.skipValue()) return syntaxError();
+            continue;
+        }
+
+        Pending item;
+        item.entry.name = templateName;
+        bool hasSnippetShape = false;
+        const Token token = reader.next();
+        item.entry.offset = reader.offset();
+        if (token == Token::BeginObject && wanted) {
+            // Locate the entry without decoding it
+            if (!reader.skipRest()) return syntaxError();
+            item.entry.length = reader.endOffset() - item.entry.offset;
+            item.entry.hash = entryHash(content.constData() + item.entry.offset, item.entry.length);
+            if (wanted(item.entry)) {
+                JsonEventReader slice(QByteArray::fromRawData(content.constData() + item.entry.offset,
+                                                              item.entry.length));
+                slice.next();
+                ResourceTemplate tmpl;
+                if (!readModernEntry(slice, templateName, tmpl, hasSnippetShape)) return syntaxError();
+                item.tmpl = std::move(tmpl);
+            } else {
+                hasSnippetShape = true;
+            }
+        } else {
+            ResourceTemplate tmpl;
+            if (token == Token::BeginObject) {
+                if (!readModernEntry(reader, templateName, tmpl, hasSnippetShape)) return syntaxError();
+            } else {
+                if ((token == Token::BeginArray && !reader.skipRest()) || reader.hasError()) {
+                    return syntaxError();
+                }
+                setDefaultEntry(tmpl, templateName);
+            }
+            item.entry.length = reader.endOffset() - item.entry.offset;
+            item.entry.hash = entryHash(content.constData() + item.entry.offset, item.entry.length);
+            if (!wanted || wanted(item.entry)) {
+                item.tmpl = std::move(tmpl);
+            }
+        }
+
+        if (!accepted) {
+            pending.append(std::move(item));
+            if (!hasSnippetShape) continue;
+            accepted = true;
+            for (Pending& held : pending) {
+                ++result.count;
+                if (!onEntry(held.entry, held.tmpl ? &*held.tmpl : nullptr)) {
+                    result.success = true;
+                    return result;
+                }
+            }
+            pending.clear();
+            continue;
+        }
+        ++result.count;
+        if (!onEntry(item.entry, item.tmpl ? &*item.tmpl : nullptr)) {
+            // Stopped by the caller; the rest is not read
             result.success = true;
             return result;
         }
     }
+    if (reader.token() != Token::EndObject || reader.next() != Token::End) {
+        return syntaxError();
+    }
+
+    if (!accepted || result.count == 0) {
+        result.errorMessage = QStringLiteral("Failed to identify JSON format (not legacy or modern template)");
+        return result;
+    }
+    result.success = true;
+    return result;
+}
+
+} // namespace
+
+ParseResult TemplateParser::parseJson(const QString& jsonContent) {
+    if (jsonContent.isEmpty()) {
+        ParseResult result;
+        result.success = false;
+        result.errorMessage = QStringLiteral("Empty JSON content");
+        return result;
+    }
+    
+    JsonErrorInfo error;
+    return parseContent(jsonContent.toUtf8(), error);
+}
+
+ParseResult TemplateParser::parseDocument(const QJsonDocument& doc) {
+    return scadtemplates::parseDocument(doc);
+}
+
+ParseResult TemplateParser::parseFile(const QString& filePath) {
+    // Shared with the scanner and the UI: parsed once per change of the file
+    const auto parsed = resourceInventory::ParsedTemplateCache::instance().get(filePath);
+    if (!parsed->ok()) {
+        ParseResult result;
+        result.success = false;
+        result.errorMessage = parsed->read ? QString::fromStdString(parsed->error.formatError())
+                                           : QStringLiteral("Failed to open file: ") + filePath;
+        return result;
+    }
     
-    // Fallback: try reading as text and parsing JSON manually
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    return parseDocument(parsed->document);
+}
+
+StreamParseResult TemplateParser::parseFile(const QString& filePath,
+                                            const TemplateCallback& onTemplate)
+{
+    return parseEntries(filePath, {}, [&onTemplate](const TemplateEntry&, ResourceTemplate* tmpl) {
+        return onTemplate(std::move(*tmpl));
+    });
+}
+
+StreamParseResult TemplateParser::parseEntries(const QString& filePath, const EntryFilter& wanted,
+                                               const TemplateEntryCallback& onEntry)
+{
+    JsonErrorInfo error;
+    const auto file = JsonFileContent::open(filePath.toStdString(), error);
+    if (!file) {
+        StreamParseResult result;
         result.errorMessage = QStringLiteral("Failed to open file: ") + filePath;
         return result;
     }
     
-    QString content = QString::fromUtf8(file.readAll());
-    return parseJson(content);
+    const QByteArray& content = file->data();
+    const SniffedFormat format = sniffFormat(content);
+    if (format == SniffedFormat::Modern || format == SniffedFormat::Unmarked) {
+        return streamModernTemplates(content, format, wanted, onEntry);
+    }
+    
+    // Legacy (a single template, the whole file is its entry) or an error
+    // from the regular path
+    ParseResult parsed = parseContent(content, error);
+    StreamParseResult result;
+    result.success = parsed.success;
+    result.errorMessage = parsed.errorMessage;
+    for (ResourceTemplate& tmpl : parsed.templates) {
+        TemplateEntry entry;
+        entry.name = tmpl.prefix();
+        entry.length = content.size();
+        entry.hash = entryHash(content.constData(), content.size());
+        ++result.count;
+        ResourceTemplate* delivered = !wanted || wanted(entry) ? &tmpl : nullptr;
+        if (!onEntry(entry, delivered)) {
+            break;
+        }
+    }
+    return result;
 }
 
 QJsonObject TemplateParser::templateToJson(const ResourceTemplate& tmpl, const QString& source)
@@ -264,40 +523,89 @@ QJsonObject TemplateParser::templateToJson(const ResourceTemplate& tmpl, const Q
     return rootObj;
 }
 
-QString TemplateParser::toJson(const ResourceTemplate& tmpl) {
-    QString json;
-    json += "{\n";
-    json += "  \"" + tmpl.prefix() + "\": {\n";
-    json += "    \"_format\": \"vscode-snippet\",\n";
-    json += "    \"_source\": \"cppsnippet-made\",\n";
-    json += "    \"_version\": 1,\n";
-    json += "    \"prefix\": \"" + tmpl.prefix() + "\",\n";
-    json += "    \"body\": \"" + tmpl.body() + "\",\n";
-    json += "    \"description\": \"" + tmpl.description() + "\"\n";
-    json += "  }\n";
-    json += "}";
-    return json;
+namespace {
+
+QString descriptionForJson(const ResourceTemplate& tmpl)
+{
+    const QString desc = tmpl.description();
+    return desc.isEmpty() ? QStringLiteral("Created in cppsnippets") : desc;
 }
 
-QString TemplateParser::toJson(const QList<ResourceTemplate>& templates) {
-    QString json;
-    json += "{\n";
+/**
+ * @brief Write one "prefix": { ... } entry in the templateToJson() layout
+ */
+void writeTemplateEntry(JsonWriter& writer, const ResourceTemplate& tmpl, const QString& source)
+{
+    const QString prefix = tmpl.prefix();
+    const QString body = tmpl.body();
     
-    for (int i = 0; i < templates.size(); ++i) {
-        const auto& tmpl = templates[i];
-        json += "  \"" + tmpl.prefix() + "\": {\n";
-        json += "    \"prefix\": \"" + tmpl.prefix() + "\",\n";
-        json += "    \"body\": \"" + tmpl.body() + "\",\n";
-        json += "    \"description\": \"" + tmpl.description() + "\"\n";
-        json += "  }";
-        if (i < templates.size() - 1) {
-            json += ",";
-        }
-        json += "\n";
+    writer.key(prefix);
+    writer.beginObject();
+    writer.member(u"_format", u"vscode-snippet");
+    writer.member(u"_source", source);
+    writer.member(u"_version", qint64(1));
+    writer.member(u"prefix", prefix);
+    writer.member(u"description", descriptionForJson(tmpl));
+    writer.key(u"body");
+    writer.beginArray();
+    for (const QStringView line : QStringView(body).tokenize(u'\n')) {
+        writer.value(line);
     }
-    
-    json += "}";
-    return json;
+    writer.endArray();
+    writer.endObject();
+}
+
+/**
+ * @brief Upper bound of the writeJson() output size, to allocate once
+ */
+qsizetype estimatedJsonSize(const QList<ResourceTemplate>& templates, const QString& source)
+{
+    // Field names, markers, punctuation and indentation of one entry
+    constexpr qsizetype kEntryOverhead = 160;
+    qsizetype size = 4;
+    for (const ResourceTemplate& tmpl : templates) {
+        const QString body = tmpl.body();
+        const qsizetype lines = body.count(QLatin1Char('\n')) + 1;
+        size += kEntryOverhead + 2 * JsonWriter::escapedSize(tmpl.prefix())
+                + JsonWriter::escapedSize(source)
+                + JsonWriter::escapedSize(descriptionForJson(tmpl))
+                + JsonWriter::escapedSize(body) + lines * 12;
+    }
+    return size;
+}
+
+QString templatesToJson(const QList<ResourceTemplate>& templates)
+{
+    const QString source = QStringLiteral("cppsnippet-made");
+    QByteArray json;
+    json.reserve(estimatedJsonSize(templates, source));
+    QBuffer buffer(&json);
+    buffer.open(QIODevice::WriteOnly);
+    TemplateParser::writeJson(&buffer, templates, source);
+    buffer.close();
+    return QString::fromUtf8(json);
+}
+
+} // namespace
+
+bool TemplateParser::writeJson(QIODevice* device, const QList<ResourceTemplate>& templates,
+                               const QString& source)
+{
+    JsonWriter writer(device);
+    writer.beginObject();
+    for (const ResourceTemplate& tmpl : templates) {
+        writeTemplateEntry(writer, tmpl, source);
+    }
+    writer.endObject();
+    return writer.finish();
+}
+
+QString TemplateParser::toJson(const ResourceTemplate& tmpl) {
+    return templatesToJson({tmpl});
+}
+
+QString TemplateParser::toJson(const QList<ResourceTemplate>& templates) {
+    return templatesToJson(templates);
 }
 
 } // namespace scadtemplates
@@ -11,6 +11,9 @@
 #include <QList>
 #include <optional>
 #include <QJsonObject>
+#include <functional>
+
+class QIODevice;
 
 using resourceInventory::ResourceTemplate;
 
@@ -25,6 +28,44 @@ struct SCADTEMPLATES_API ParseResult {
     QList<ResourceTemplate> templates;
 };
 
+/**
+ * @brief Result of a streaming parse operation
+ */
+struct SCADTEMPLATES_API StreamParseResult {
+    bool success = false;
+    QString errorMessage;
+    qsizetype count = 0;  // Templates delivered to the callback
+};
+
+/**
+ * @brief Receives each template of a streaming parse
+ * @return false to stop parsing (the result is still successful)
+ */
+using TemplateCallback = std::function<bool(ResourceTemplate&&)>;
+
+/**
+ * @brief Location and content hash of one entry of a template file
+ */
+struct SCADTEMPLATES_API TemplateEntry {
+    QString name;           // Key of the entry in the collection
+    qsizetype offset = 0;   // Byte range of the entry's value in the file
+    qsizetype length = 0;
+    quint64 hash = 0;       // FNV-1a of those bytes
+};
+
+/**
+ * @brief Decides whether an entry is decoded
+ * @return false to skip decoding (e.g. the hash is unchanged)
+ */
+using EntryFilter = std::function<bool(const TemplateEntry&)>;
+
+/**
+ * @brief Receives each entry of a streaming parse
+ * @param tmpl The decoded template, or nullptr if the filter skipped it
+ * @return false to stop parsing (the result is still successful)
+ */
+using TemplateEntryCallback = std::function<bool(const TemplateEntry& entry, ResourceTemplate* tmpl)>;
+
 /**
  * @brief Parses template files in various formats
  * 
@@ -45,6 +86,13 @@ public:
      */
     ParseResult parseJson(const QString& jsonContent);
 
+    /**
+     * @brief Parse templates from a document the caller already read
+     * @param doc Parsed JSON, e.g. a result of JsonReader::readMany()
+     * @return ParseResult containing success status and parsed templates
+     */
+    ParseResult parseDocument(const QJsonDocument& doc);
+
     /**
      * @brief Parse templates from a file
      * @param filePath Path to the template file
@@ -52,6 +100,35 @@ public:
      */
     ParseResult parseFile(const QString& filePath);
 
+    /**
+     * @brief Parse templates from a file, one at a time
+     * @param filePath Path to the template file
+     * @param onTemplate Called for each template, in file order
+     * @return Success status and the number of templates delivered
+     *
+     * Snippet collections are read with JsonEventReader over the file's
+     * bytes, so no document of the whole collection is built and each
+     * template is handed over as soon as its entry ends. Templates before
+     * a syntax error have already been delivered when the error is
+     * returned. Legacy files are small and go through parseFile().
+     */
+    StreamParseResult parseFile(const QString& filePath, const TemplateCallback& onTemplate);
+
+    /**
+     * @brief Parse templates from a file, decoding only wanted entries
+     * @param filePath Path to the template file
+     * @param wanted Consulted per entry with its hash; empty decodes all
+     * @param onEntry Called for every entry, in file order
+     * @return Success status and the number of entries delivered
+     *
+     * Entries of a snippet collection are located and hashed without
+     * being decoded; only those the filter wants are decoded, from their
+     * own byte range. Re-reading an edited collection then costs one scan
+     * plus the changed entries. A legacy file is a single entry.
+     */
+    StreamParseResult parseEntries(const QString& filePath, const EntryFilter& wanted,
+                                   const TemplateEntryCallback& onEntry);
+
     /**
      * @brief Convert a template to JSON format with source provenance
      * @param tmpl The template to convert
@@ -64,7 +141,7 @@ public:
     /**
      * @brief Convert a template to JSON format
      * @param tmpl The template to convert
-     * @return JSON string representation
+     * @return JSON string representation (same layout as templateToJson())
      */
     QString toJson(const ResourceTemplate& tmpl);
 
@@ -74,6 +151,20 @@ public:
      * @return JSON string representation
      */
     QString toJson(const QList<ResourceTemplate>& templates);
+
+    /**
+     * @brief Stream templates as one modern-format JSON document
+     * @param device Open, writable device
+     * @param templates Templates to write, one entry per template keyed by prefix
+     * @param source The provenance source written as _source
+     * @return false if the device reported a write error
+     *
+     * Output goes through JsonWriter's fixed buffer, so memory use does not
+     * depend on the number of templates. Strings are escaped and bodies
+     * are written as arrays of lines, as templateToJson() produces.
+     */
+    static bool writeJson(QIODevice* device, const QList<ResourceTemplate>& templates,
+                          const QString& source = QStringLiteral("cppsnippet-made"));
 };
 
 } // namespace scadtemplates
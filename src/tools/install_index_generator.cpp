@@ -0,0 +1,71 @@
+/**
+ * @file install_index_generator.cpp
+ * @brief Packaging utility that writes the prebuilt install-tier index
+ *
+ * Run after the resources have been staged into their final layout (e.g. as
+ * the last packaging step). Each given resource root is scanned once and its
+ * inventory is written to <root>/.scadtemplates-index, which the application
+ * loads at startup instead of scanning the Installation tier.
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QStringList>
+#include <QString>
+#include <iostream>
+
+#include "platformInfo/ResourceLocation.hpp"
+#include "resourceInventory/installIndex.hpp"
+#include "resourceScanning/resourceScanner.hpp"
+
+using resourceInventory::ResourceItem;
+using resourceMetadata::ResourceTier;
+
+void printUsage() {
+    std::cout << "\n=== Install Index Generator ===\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  install-index-generator <resource-root> [<resource-root> ...]\n\n";
+    std::cout << "Scans each Installation-tier resource root (the folder containing\n";
+    std::cout << "templates/, examples/, ...) and writes its prebuilt index.\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  install-index-generator stage/share/openscad\n\n";
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QStringList roots = app.arguments().mid(1);
+    if (roots.isEmpty() || roots.contains(QStringLiteral("--help")) || roots.contains(QStringLiteral("-h"))) {
+        printUsage();
+        return roots.isEmpty() ? 1 : 0;
+    }
+
+    resourceInventory::ResourceScanner scanner;
+    int failures = 0;
+
+    for (const QString& root : roots) {
+        const QString rootPath = QDir(root).absolutePath();
+        if (!QDir(rootPath).exists()) {
+            std::cerr << "✗ Not a directory: " << rootPath.toStdString() << "\n";
+            ++failures;
+            continue;
+        }
+
+        const platformInfo::ResourceLocation location(rootPath, ResourceTier::Installation);
+        QList<ResourceItem> items;
+        scanner.scanLocations({location}, [&items](const ResourceItem& item) {
+            items.append(item);
+        });
+
+        QString error;
+        if (!resourceInventory::InstallIndex::write(location, items, &error)) {
+            std::cerr << "✗ " << error.toStdString() << "\n";
+            ++failures;
+            continue;
+        }
+
+        std::cout << "✓ Indexed " << items.size() << " item(s) in " << rootPath.toStdString() << "\n";
+    }
+
+    return failures == 0 ? 0 : 1;
+}
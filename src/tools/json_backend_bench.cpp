@@ -0,0 +1,279 @@
+/**
+ * @file json_backend_bench.cpp
+ * @brief Parse/serialize throughput of every JsonBackend on a JSON corpus
+ *
+ * All given files - or every .json file below a given folder - are read
+ * into memory once, then measured several times over, per backend:
+ *
+ *   native parse  bytes to the backend's own representation
+ *                 (QJsonDocument, nlohmann::json, JsonEventReader tokens)
+ *   native write  that representation back to text (toJson, dump,
+ *                 JsonWriter replaying the tokens)
+ *   to Qt         bytes to QJsonDocument, what JsonReader uses
+ *
+ * Documents are checked against the Qt backend so a fast but wrong
+ * backend stands out. The numbers are meant for choosing JSON_BACKEND at
+ * build time.
+ */
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QString>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "jsonreader/JsonBackend.hpp"
+#include "jsonreader/JsonReader.hpp"
+#include "jsonreader/JsonWriter.hpp"
+
+void printUsage() {
+    std::cout << "\n=== JSON Backend Benchmark ===\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  json-backend-bench [-n <iterations>] <file-or-folder> [...]\n\n";
+    std::cout << "Parses and serializes the JSON files with every compiled-in\n";
+    std::cout << "backend, in its own representation and into Qt documents, and\n";
+    std::cout << "prints the throughput of each. Folders are searched recursively\n";
+    std::cout << "for .json files.\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  json-backend-bench templates\n";
+    std::cout << "  json-backend-bench -n 20 stage/share/openscad/templates\n\n";
+}
+
+double megabytesPerSecond(qint64 bytes, qint64 nanoseconds) {
+    return nanoseconds > 0 ? (double(bytes) / (1024.0 * 1024.0)) / (double(nanoseconds) / 1e9) : 0.0;
+}
+
+// One JsonEventReader token, as JsonWriter takes it back
+struct Event {
+    JsonEventReader::Token token;
+    QString text;
+    double number = 0.0;
+    bool flag = false;
+};
+
+// Token pass over content; events are recorded when `events` is given
+bool readEvents(const QByteArray& content, std::vector<Event>* events) {
+    using Token = JsonEventReader::Token;
+    JsonEventReader reader(content);
+    for (Token token = reader.next(); token != Token::End; token = reader.next()) {
+        if (token == Token::Error) {
+            return false;
+        }
+        if (!events) {
+            continue;
+        }
+        Event event{token, QString(), 0.0, false};
+        if (token == Token::Key || token == Token::String) {
+            event.text = reader.text();
+        } else if (token == Token::Number) {
+            event.number = reader.number();
+        } else if (token == Token::Bool) {
+            event.flag = reader.boolean();
+        }
+        events->push_back(std::move(event));
+    }
+    return true;
+}
+
+void writeEvents(const std::vector<Event>& events, QIODevice* device) {
+    using Token = JsonEventReader::Token;
+    JsonWriter writer(device, 4);
+    for (const Event& event : events) {
+        switch (event.token) {
+        case Token::BeginObject: writer.beginObject(); break;
+        case Token::EndObject:   writer.endObject(); break;
+        case Token::BeginArray:  writer.beginArray(); break;
+        case Token::EndArray:    writer.endArray(); break;
+        case Token::Key:         writer.key(event.text); break;
+        case Token::String:      writer.value(event.text); break;
+        case Token::Bool:        writer.value(event.flag); break;
+        case Token::Null:        writer.nullValue(); break;
+        case Token::Number:
+            if (std::trunc(event.number) == event.number && std::abs(event.number) < 9.0e15) {
+                writer.value(qint64(event.number));
+            } else {
+                writer.realValue(event.number);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    writer.finish();
+}
+
+// Native parse and write of one backend over the corpus
+struct NativeTimes {
+    qint64 parseNs = 0;
+    qint64 writeNs = 0;
+    int failures = 0;
+};
+
+NativeTimes measureNative(const char* backend, const std::vector<QByteArray>& corpus, int iterations) {
+    NativeTimes times;
+    QElapsedTimer timer;
+    QByteArray output;
+    const std::string name = backend;
+
+    if (name == "qt") {
+        std::vector<QJsonDocument> docs(corpus.size());
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t f = 0; f < corpus.size(); ++f) {
+                QJsonParseError error;
+                docs[f] = QJsonDocument::fromJson(corpus[f], &error);
+                if (i == 0 && error.error != QJsonParseError::NoError) ++times.failures;
+            }
+        }
+        times.parseNs = timer.nsecsElapsed();
+        timer.restart();
+        for (int i = 0; i < iterations; ++i) {
+            for (const QJsonDocument& doc : docs) {
+                output = doc.toJson(QJsonDocument::Indented);
+            }
+        }
+        times.writeNs = timer.nsecsElapsed();
+    } else if (name == "nlohmann") {
+        std::vector<nlohmann::json> docs(corpus.size());
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t f = 0; f < corpus.size(); ++f) {
+                docs[f] = nlohmann::json::parse(corpus[f].cbegin(), corpus[f].cend(), nullptr, false);
+                if (i == 0 && docs[f].is_discarded()) ++times.failures;
+            }
+        }
+        times.parseNs = timer.nsecsElapsed();
+        timer.restart();
+        std::string text;
+        for (int i = 0; i < iterations; ++i) {
+            for (const nlohmann::json& doc : docs) {
+                text = doc.dump(4);
+            }
+        }
+        times.writeNs = timer.nsecsElapsed();
+    } else if (name == "event") {
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            for (const QByteArray& content : corpus) {
+                if (!readEvents(content, nullptr) && i == 0) ++times.failures;
+            }
+        }
+        times.parseNs = timer.nsecsElapsed();
+        // Tokens recorded outside the timing; the writer replays them
+        std::vector<std::vector<Event>> events(corpus.size());
+        for (size_t f = 0; f < corpus.size(); ++f) {
+            readEvents(corpus[f], &events[f]);
+        }
+        timer.restart();
+        for (int i = 0; i < iterations; ++i) {
+            for (const std::vector<Event>& file : events) {
+                output.clear();
+                QBuffer buffer(&output);
+                buffer.open(QIODevice::WriteOnly);
+                writeEvents(file, &buffer);
+            }
+        }
+        times.writeNs = timer.nsecsElapsed();
+    }
+    return times;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments().mid(1);
+    if (args.isEmpty() || args.contains(QStringLiteral("--help")) || args.contains(QStringLiteral("-h"))) {
+        printUsage();
+        return args.isEmpty() ? 1 : 0;
+    }
+
+    int iterations = 50;
+    const int iterationsOption = args.indexOf(QStringLiteral("-n"));
+    if (iterationsOption >= 0 && iterationsOption + 1 < args.size()) {
+        iterations = qMax(1, args[iterationsOption + 1].toInt());
+        args.remove(iterationsOption, 2);
+    }
+
+    QStringList files;
+    for (const QString& arg : std::as_const(args)) {
+        if (QFileInfo(arg).isDir()) {
+            QDirIterator it(arg, {QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                files.append(it.next());
+            }
+        } else {
+            files.append(arg);
+        }
+    }
+
+    // Corpus in memory, so only parsing and writing are measured
+    std::vector<QByteArray> corpus;
+    std::vector<QJsonDocument> reference;
+    qint64 corpusBytes = 0;
+    const JsonBackend* qt = JsonBackend::find("qt");
+    for (const QString& path : std::as_const(files)) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << "Cannot read " << path.toStdString() << "\n";
+            continue;
+        }
+        QByteArray content = file.readAll();
+        QJsonDocument doc;
+        JsonErrorInfo error;
+        if (!qt->parse(content, doc, error)) {
+            std::cerr << "Skipping invalid JSON " << path.toStdString() << ": " << error.message << "\n";
+            continue;
+        }
+        corpusBytes += content.size();
+        corpus.push_back(std::move(content));
+        reference.push_back(std::move(doc));
+    }
+    if (corpus.empty()) {
+        std::cerr << "No JSON files to measure\n";
+        return 1;
+    }
+
+    std::cout << "Corpus: " << corpus.size() << " file(s), " << corpusBytes << " bytes, "
+              << iterations << " iteration(s)\n";
+    std::cout << "Build backend: " << JsonBackend::active().name() << "\n\n";
+    // Written bytes differ per backend (formatting), so rates use the corpus size
+    const qint64 totalBytes = corpusBytes * iterations;
+    std::printf("%-10s %12s %12s %12s %9s\n", "backend", "native parse", "native write", "to Qt", "mismatch");
+
+    for (const JsonBackend* backend : JsonBackend::all()) {
+        const NativeTimes native = measureNative(backend->name(), corpus, iterations);
+
+        int mismatches = native.failures;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t f = 0; f < corpus.size(); ++f) {
+                QJsonDocument doc;
+                JsonErrorInfo error;
+                const bool ok = backend->parse(corpus[f], doc, error);
+                if (i == 0 && (!ok || doc != reference[f])) {
+                    ++mismatches;
+                }
+            }
+        }
+        const qint64 toQtNs = timer.nsecsElapsed();
+
+        std::printf("%-10s %12.1f %12.1f %12.1f %9d\n", backend->name(),
+                    megabytesPerSecond(totalBytes, native.parseNs),
+                    megabytesPerSecond(totalBytes, native.writeNs),
+                    megabytesPerSecond(totalBytes, toQtNs), mismatches);
+    }
+
+    std::printf("\nRates in MB/s of the input corpus.\n");
+    return 0;
+}
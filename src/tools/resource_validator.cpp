@@ -0,0 +1,85 @@
+/**
+ * @file resource_validator.cpp
+ * @brief Bulk JSON-schema validation of resource files, e.g. as a CI gate
+ *
+ * Every given file - or every JSON resource file below a given resource
+ * root (templates, color schemes, example manifests) - is validated in
+ * parallel against its schema. Diagnostics are printed as
+ * file:line:column: message, and the exit code is non-zero when any file
+ * has one.
+ */
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QStringList>
+#include <QString>
+#include <iostream>
+
+#include "platformInfo/ResourceLocation.hpp"
+#include "resourceScanning/schemaValidator.hpp"
+
+using resourceInventory::SchemaValidator;
+using resourceMetadata::ResourceTier;
+
+void printUsage() {
+    std::cout << "\n=== Resource Validator ===\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  resource-validator [-j <threads>] <file-or-resource-root> [...]\n\n";
+    std::cout << "Validates JSON resource files against their schemas (legacy and\n";
+    std::cout << "snippet templates, color schemes, example-dir.json manifests).\n";
+    std::cout << "Directories are treated as resource roots (the folder containing\n";
+    std::cout << "templates/, color-schemes/, examples/, ...).\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  resource-validator stage/share/openscad\n";
+    std::cout << "  resource-validator -j 8 templates/*.json\n\n";
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments().mid(1);
+    if (args.isEmpty() || args.contains(QStringLiteral("--help")) || args.contains(QStringLiteral("-h"))) {
+        printUsage();
+        return args.isEmpty() ? 1 : 0;
+    }
+
+    int threads = 0;
+    const int threadsOption = args.indexOf(QStringLiteral("-j"));
+    if (threadsOption >= 0 && threadsOption + 1 < args.size()) {
+        threads = args[threadsOption + 1].toInt();
+        args.remove(threadsOption, 2);
+    }
+
+    QStringList files;
+    for (const QString& arg : std::as_const(args)) {
+        const QFileInfo info(arg);
+        if (info.isDir()) {
+            const platformInfo::ResourceLocation location(info.absoluteFilePath(), ResourceTier::Installation);
+            files.append(SchemaValidator::resourceFiles(location));
+        } else {
+            files.append(arg);
+        }
+    }
+
+    const auto results = SchemaValidator::validateFiles(files, threads);
+    int failedFiles = 0;
+    size_t diagnostics = 0;
+    for (const auto& result : results) {
+        if (result.ok()) {
+            continue;
+        }
+        ++failedFiles;
+        diagnostics += result.diagnostics.size();
+        for (const auto& diagnostic : result.diagnostics) {
+            std::cerr << diagnostic.formatError() << "\n";
+        }
+    }
+
+    if (failedFiles == 0) {
+        std::cout << "✓ " << results.size() << " file(s) valid\n";
+        return 0;
+    }
+    std::cout << "✗ " << diagnostics << " problem(s) in " << failedFiles << " of "
+              << results.size() << " file(s)\n";
+    return 1;
+}
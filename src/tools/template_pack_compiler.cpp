@@ -0,0 +1,128 @@
+/**
+ * @file template_pack_compiler.cpp
+ * @brief Compiles a folder of template JSON files into a .stpack pack
+ *
+ * Every *.json file of the folder is parsed once here, in parallel
+ * through JsonReader::readMany() - snippet files (modern or legacy,
+ * possibly several templates per file) and scanner templates
+ * ({"name", "category", "body"}) alike - and the templates are written
+ * into a single pack that TemplateScanner maps and queries in place
+ * instead of opening and parsing each file.
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+#include <QString>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "jsonreader/JsonReader.hpp"
+#include "platformInfo/ResourceLocation.hpp"
+#include "resourceInventory/templatePack.hpp"
+#include "resourceScanning/templateScanner.hpp"
+#include "scadtemplates/template_parser.hpp"
+
+using resourceInventory::ResourceTemplate;
+using resourceInventory::TemplatePack;
+
+void printUsage() {
+    std::cout << "\n=== Template Pack Compiler ===\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  template-pack-compiler <template-folder> <output" << TemplatePack::fileExtension.toStdString() << ">\n\n";
+    std::cout << "Parses every *.json template in the folder and writes them into one\n";
+    std::cout << "memory-mappable pack. Templates are indexed by prefix; when several\n";
+    std::cout << "share a prefix, only the first one (in file name order) is packed.\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  template-pack-compiler scadtemplates/user templates/user" << TemplatePack::fileExtension.toStdString() << "\n\n";
+}
+
+// Templates of one read file: snippet formats first, then the scanner format
+bool readTemplates(const QString& filePath, const JsonReadResult& read, QList<ResourceTemplate>& templates) {
+    if (!read.ok()) {
+        std::cerr << "✗ " << read.error.formatError() << "\n";
+        return false;
+    }
+
+    scadtemplates::TemplateParser parser;
+    const scadtemplates::ParseResult parsed = parser.parseDocument(read.doc);
+    if (parsed.success) {
+        templates = parsed.templates;
+        return true;
+    }
+
+    if (!TemplateScanner::validateTemplateJson(read.doc)) {
+        std::cerr << "✗ Not a template: " << filePath.toStdString() << "\n";
+        return false;
+    }
+    ResourceTemplate tmpl = TemplateScanner::extractMetadata(read.doc, filePath, platformInfo::ResourceLocation());
+    tmpl.setPrefix(tmpl.name());
+    templates = {tmpl};
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments().mid(1);
+    if (args.contains(QStringLiteral("--help")) || args.contains(QStringLiteral("-h"))) {
+        printUsage();
+        return 0;
+    }
+    if (args.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    const QDir folder(args[0]);
+    if (!folder.exists()) {
+        std::cerr << "✗ Not a directory: " << args[0].toStdString() << "\n";
+        return 1;
+    }
+
+    QList<ResourceTemplate> templates;
+    QSet<QString> prefixes;
+    int failures = 0;
+    const QStringList files = folder.entryList({QStringLiteral("*.json")}, QDir::Files | QDir::Readable, QDir::Name);
+
+    // Files are read and parsed in parallel on pooled buffers; results
+    // arrive here in file name order, so the pack is deterministic
+    std::vector<std::string> paths;
+    paths.reserve(size_t(files.size()));
+    for (const QString& fileName : files) {
+        paths.push_back(folder.filePath(fileName).toStdString());
+    }
+    JsonReader::readMany(paths, [&](size_t index, JsonReadResult& read) {
+        const QString& fileName = files[qsizetype(index)];
+        QList<ResourceTemplate> fileTemplates;
+        if (!readTemplates(folder.filePath(fileName), read, fileTemplates)) {
+            ++failures;
+            return;
+        }
+        for (const ResourceTemplate& tmpl : std::as_const(fileTemplates)) {
+            // Entries are addressed by prefix: only the first one is packed
+            if (prefixes.contains(tmpl.prefix())) {
+                std::cerr << "! Duplicate prefix \"" << tmpl.prefix().toStdString() << "\" in "
+                          << fileName.toStdString() << " skipped (first one wins)\n";
+                continue;
+            }
+            prefixes.insert(tmpl.prefix());
+            templates.append(tmpl);
+        }
+    });
+
+    QString error;
+    if (!TemplatePack::write(args[1], templates, &error)) {
+        std::cerr << "✗ " << error.toStdString() << "\n";
+        return 1;
+    }
+
+    std::cout << "✓ Packed " << templates.size() << " template(s) from " << files.size()
+              << " file(s) into " << QFileInfo(args[1]).absoluteFilePath().toStdString() << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file tempTree.hpp
+ * @brief Temporary directory tree for tests that need files on disk
+ *
+ * Wraps QTemporaryDir with helpers to create folders and write files by
+ * relative path; the tree is removed when the object goes out of scope.
+ */
+
+#ifndef TEMPTREE_H
+#define TEMPTREE_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+
+namespace testSupport {
+
+class TempTree {
+public:
+    bool isValid() const { return m_dir.isValid(); }
+
+    /// Absolute path of the tree's root folder
+    QString root() const { return m_dir.path(); }
+
+    /// Absolute path of a file or folder inside the tree
+    QString path(const QString& relative) const { return m_dir.filePath(relative); }
+
+    /// Create a folder and its parents; true if it exists afterwards
+    bool mkdir(const QString& relative) const { return QDir(m_dir.path()).mkpath(relative); }
+
+    /**
+     * @brief Write (or overwrite) a file, creating its parent folders
+     * @return Absolute path of the file, or an empty string on failure
+     */
+    QString write(const QString& relative, const QByteArray& content) const
+    {
+        const QString filePath = path(relative);
+        if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+            return QString();
+        }
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || file.write(content) != content.size()) {
+            return QString();
+        }
+        return filePath;
+    }
+
+private:
+    QTemporaryDir m_dir;
+};
+
+} // namespace testSupport
+
+#endif // TEMPTREE_H
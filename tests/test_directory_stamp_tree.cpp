@@ -0,0 +1,129 @@
+/**
+ * @file test_directory_stamp_tree.cpp
+ * @brief Unit tests for DirectoryStampTree incremental change detection
+ */
+
+#include <resourceScanning/directoryStampTree.hpp>
+#include <gtest/gtest.h>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+
+#include "tempTree.hpp"
+
+using namespace resourceInventory;
+
+class DirectoryStampTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_temp.isValid());
+        m_root = QDir::cleanPath(m_temp.root());
+        ASSERT_TRUE(m_temp.mkdir("Basics"));
+        ASSERT_TRUE(m_temp.mkdir("Advanced/deep"));
+    }
+
+    QString path(const QString& rel) const { return m_root + QLatin1Char('/') + rel; }
+
+    // Directory mtimes may have coarse resolution
+    static void waitForClockTick() { QThread::msleep(20); }
+
+    testSupport::TempTree m_temp;
+    QString m_root;
+    DirectoryStampTree m_tree;
+};
+
+TEST_F(DirectoryStampTreeTest, FirstUpdateReportsAllDirectories) {
+    const auto changes = m_tree.update(m_root);
+    EXPECT_EQ(changes.changed.size(), 4);
+    EXPECT_TRUE(changes.changed.contains(path("Advanced/deep")));
+    EXPECT_TRUE(changes.removed.isEmpty());
+}
+
+TEST_F(DirectoryStampTreeTest, UnchangedTreeReportsNothing) {
+    m_tree.update(m_root);
+    const qint64 mtime = m_tree.stamp(path("Basics")).mtime;
+
+    EXPECT_TRUE(m_tree.update(m_root).isEmpty());
+    EXPECT_EQ(m_tree.stamp(path("Basics")).mtime, mtime);
+}
+
+TEST_F(DirectoryStampTreeTest, OnlyChangedDirectoryIsRelisted) {
+    m_tree.update(m_root);
+    waitForClockTick();
+
+    // Root mtime is unchanged; Basics is found by its own stat
+    ASSERT_FALSE(m_temp.write("Basics/cube.scad", "cube();").isEmpty());
+    auto changes = m_tree.update(m_root);
+    EXPECT_EQ(changes.changed, QStringList{path("Basics")});
+
+    // Three levels down, below unchanged ancestors
+    waitForClockTick();
+    ASSERT_FALSE(m_temp.write("Advanced/deep/sphere.scad", "sphere();").isEmpty());
+    changes = m_tree.update(m_root);
+    EXPECT_EQ(changes.changed, QStringList{path("Advanced/deep")});
+}
+
+TEST_F(DirectoryStampTreeTest, InPlaceEditsNeedMarkDirtyOrFullUpdate) {
+    ASSERT_FALSE(m_temp.write("Basics/cube.scad", "cube();").isEmpty());
+    m_tree.update(m_root);
+    waitForClockTick();
+
+    // Rewriting a file leaves its directory's mtime alone
+    ASSERT_FALSE(m_temp.write("Basics/cube.scad", "cube(10);").isEmpty());
+    EXPECT_TRUE(m_tree.update(m_root).isEmpty());
+
+    m_tree.markDirty(path("Basics"));
+    EXPECT_EQ(m_tree.update(m_root).changed, QStringList{path("Basics")});
+
+    const auto changes = m_tree.update(m_root, DirectoryStampTree::UpdateMode::Full);
+    EXPECT_EQ(changes.changed.size(), 4);
+    EXPECT_TRUE(changes.removed.isEmpty());
+}
+
+TEST_F(DirectoryStampTreeTest, RemovedSubtreeIsReported) {
+    m_tree.update(m_root);
+    waitForClockTick();
+
+    ASSERT_TRUE(QDir(path("Advanced")).removeRecursively());
+
+    const auto changes = m_tree.update(m_root);
+    EXPECT_EQ(changes.changed, QStringList{m_root});
+    EXPECT_TRUE(changes.removed.contains(path("Advanced")));
+    EXPECT_TRUE(changes.removed.contains(path("Advanced/deep")));
+    EXPECT_FALSE(m_tree.contains(path("Advanced")));
+}
+
+TEST_F(DirectoryStampTreeTest, MarkDirtyOnUnknownDirectoryFlagsAncestor) {
+    m_tree.update(m_root);
+
+    ASSERT_TRUE(m_temp.mkdir("Advanced/deep/new"));
+    m_tree.markDirty(path("Advanced/deep/new"));
+
+    const auto changes = m_tree.update(m_root);
+    EXPECT_TRUE(changes.changed.contains(path("Advanced/deep")));
+    EXPECT_TRUE(changes.changed.contains(path("Advanced/deep/new")));
+    EXPECT_FALSE(changes.changed.contains(path("Basics")));
+}
+
+TEST_F(DirectoryStampTreeTest, SkippedNamesAreNotDescended) {
+    ASSERT_TRUE(m_temp.mkdir(".git/objects"));
+    m_tree.setSkippedNames({QStringLiteral(".git")});
+
+    m_tree.update(m_root);
+    EXPECT_FALSE(m_tree.contains(path(".git")));
+    EXPECT_FALSE(m_tree.contains(path(".git/objects")));
+}
+
+TEST_F(DirectoryStampTreeTest, SymlinkLoopsAreNotFollowed) {
+    if (!QFile::link(m_root, path("Basics/loop"))) {
+        GTEST_SKIP() << "Cannot create symbolic links here";
+    }
+    ASSERT_TRUE(QFile::link(path("Advanced/deep"), path("Basics/deep")));
+
+    const auto changes = m_tree.update(m_root);
+    EXPECT_FALSE(m_tree.contains(path("Basics/loop")));
+    // A link to a directory elsewhere is still followed
+    EXPECT_TRUE(m_tree.contains(path("Basics/deep")));
+    EXPECT_EQ(changes.changed.size(), 5);
+    EXPECT_TRUE(m_tree.update(m_root).isEmpty());
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_example_dir_manifest.cpp
+ * @brief Unit tests for example-dir.json manifest loading
+ */
+
+#include <resourceScanning/exampleDirManifest.hpp>
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+using namespace resourceInventory;
+
+class ExampleDirManifestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_temp.isValid());
+        m_dir = m_temp.path();
+    }
+
+    void writeManifest(const QByteArray& content) {
+        QFile file(QDir(m_dir).filePath(ExampleDirManifest::fileName));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    void setManifestTime(const QDateTime& time) {
+        QFile file(QDir(m_dir).filePath(ExampleDirManifest::fileName));
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.setFileTime(time, QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir m_temp;
+    QString m_dir;
+};
+
+TEST_F(ExampleDirManifestTest, ParsesScriptsAndCategories) {
+    writeManifest(R"({
+        "sort": 900,
+        "name": "Examples",
+        "tooltip": "Top Level",
+        "categories": ["Basics"],
+        "scripts": ["logo.scad", {"file": "cube.scad", "attachments": ["cube.png"]}]
+    })");
+
+    ExampleDirManifest manifest;
+    ASSERT_TRUE(ExampleDirManifest::load(m_dir, manifest));
+    EXPECT_EQ(manifest.sort, 900);
+    EXPECT_EQ(manifest.name, "Examples");
+    EXPECT_TRUE(manifest.hasCategories);
+    EXPECT_EQ(manifest.categories, QStringList{"Basics"});
+    ASSERT_TRUE(manifest.hasScripts);
+    ASSERT_EQ(manifest.scripts.size(), 2);
+    EXPECT_EQ(manifest.scripts[0].file, "logo.scad");
+    EXPECT_TRUE(manifest.scripts[0].attachments.isEmpty());
+    EXPECT_EQ(manifest.scripts[1].file, "cube.scad");
+    EXPECT_EQ(manifest.scripts[1].attachments, QStringList{"cube.png"});
+}
+
+TEST_F(ExampleDirManifestTest, DescriptiveManifestIsNotTrusted) {
+    // Existing manifests only describe the folder - directory must still be listed
+    writeManifest(R"({"sort": 1200, "name": "Tests", "tooltip": "Testing Scripts"})");
+    setManifestTime(QDateTime::currentDateTime().addSecs(60));
+
+    ExampleDirManifest manifest;
+    EXPECT_TRUE(ExampleDirManifest::load(m_dir, manifest));
+    EXPECT_FALSE(ExampleDirManifest::loadTrusted(m_dir, manifest));
+}
+
+TEST_F(ExampleDirManifestTest, StaleManifestIsNotTrusted) {
+    writeManifest(R"({"scripts": ["cube.scad"]})");
+    const QDateTime dirTime = QFileInfo(m_dir).lastModified();
+
+    setManifestTime(dirTime.addSecs(60));
+    ExampleDirManifest manifest;
+    EXPECT_TRUE(ExampleDirManifest::loadTrusted(m_dir, manifest));
+
+    setManifestTime(dirTime.addSecs(-60));
+    EXPECT_FALSE(ExampleDirManifest::isFresh(m_dir));
+    EXPECT_FALSE(ExampleDirManifest::loadTrusted(m_dir, manifest));
+}
+
+TEST_F(ExampleDirManifestTest, InvalidJsonIsRejected) {
+    writeManifest(R"({"name": "List Comprehensions", "scripts": [],})");
+
+    ExampleDirManifest manifest;
+    EXPECT_FALSE(ExampleDirManifest::load(m_dir, manifest));
+}
+
+TEST_F(ExampleDirManifestTest, MissingManifest) {
+    ExampleDirManifest manifest;
+    EXPECT_FALSE(ExampleDirManifest::load(m_dir, manifest));
+    EXPECT_FALSE(ExampleDirManifest::isFresh(m_dir));
+}
@@ -0,0 +1,228 @@
+/**
+ * @file test_inventory_snapshot.cpp
+ * @brief Unit tests for InventorySnapshot serialization and SharedInventory
+ */
+
+#include <resourceInventory/inventorySnapshot.hpp>
+#include <resourceInventory/installIndex.hpp>
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <filesystem>
+
+#include "tempTree.hpp"
+
+using namespace platformInfo;
+using namespace resourceInventory;
+
+namespace {
+
+ResourceItem makeItem(const QString& path, ResourceType type, ResourceTier tier,
+                      const QString& category)
+{
+    ResourceItem item(path, type, tier);
+    item.setCategory(category);
+    item.setSourceLocationKey(QStringLiteral("Test Location"));
+    item.setDescription(QStringLiteral("Description of ") + item.name());
+    return item;
+}
+
+} // namespace
+
+// ============================================================================
+// Serialization Tests
+// ============================================================================
+
+TEST(InventorySnapshotTest, RoundTripPreservesItems) {
+    QList<ResourceItem> items;
+    items.append(makeItem("/tmp/a/templates/box.json", ResourceType::Templates, ResourceTier::User, "shapes"));
+    items.append(makeItem("/tmp/a/examples/Basics/cube.scad", ResourceType::Examples, ResourceTier::Machine, "Basics"));
+
+    const QByteArray data = InventorySnapshot::serialize(items, 7, 42);
+
+    QList<ResourceItem> decoded;
+    InventorySnapshot::Header header;
+    ASSERT_TRUE(InventorySnapshot::deserialize(data.constData(), data.size(), decoded, &header));
+
+    EXPECT_EQ(header.generation, 7u);
+    EXPECT_EQ(header.sourceStamp, 42u);
+    ASSERT_EQ(decoded.size(), items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(decoded[i].path(), items[i].path());
+        EXPECT_EQ(decoded[i].name(), items[i].name());
+        EXPECT_EQ(decoded[i].category(), items[i].category());
+        EXPECT_EQ(decoded[i].description(), items[i].description());
+        EXPECT_EQ(decoded[i].sourceLocationKey(), items[i].sourceLocationKey());
+        EXPECT_EQ(decoded[i].type(), items[i].type());
+        EXPECT_EQ(decoded[i].tier(), items[i].tier());
+    }
+}
+
+TEST(InventorySnapshotTest, RejectsBadMagic) {
+    QByteArray data = InventorySnapshot::serialize({}, 1, 1);
+    data[0] = char(data[0] ^ 0xFF);
+
+    InventorySnapshot::Header header;
+    EXPECT_FALSE(InventorySnapshot::readHeader(data.constData(), data.size(), header));
+}
+
+TEST(InventorySnapshotTest, RejectsTruncatedPayload) {
+    QList<ResourceItem> items;
+    items.append(makeItem("/tmp/a/templates/box.json", ResourceType::Templates, ResourceTier::User, "shapes"));
+    const QByteArray data = InventorySnapshot::serialize(items, 1, 1);
+
+    QList<ResourceItem> decoded;
+    EXPECT_FALSE(InventorySnapshot::deserialize(data.constData(), data.size() - 4, decoded));
+    EXPECT_TRUE(decoded.isEmpty());
+}
+
+// ============================================================================
+// Stamp and Key Tests
+// ============================================================================
+
+TEST(InventorySnapshotTest, LocationStampChangesWhenFolderAdded) {
+    QTemporaryDir temp;
+    ASSERT_TRUE(temp.isValid());
+    QDir root(temp.path());
+    ASSERT_TRUE(root.mkpath("examples"));
+
+    const QList<ResourceLocation> locations{ResourceLocation(temp.path(), ResourceTier::User)};
+    const quint64 before = InventorySnapshot::locationStamp(locations);
+    EXPECT_EQ(before, InventorySnapshot::locationStamp(locations));
+
+    ASSERT_TRUE(root.mkpath("examples/Basics"));
+    EXPECT_NE(before, InventorySnapshot::locationStamp(locations));
+}
+
+TEST(InventorySnapshotTest, LocationStampSeesNewFilesInCategories) {
+    testSupport::TempTree temp;
+    ASSERT_TRUE(temp.isValid());
+    ASSERT_FALSE(temp.write("examples/Basics/cube.scad", "cube();").isEmpty());
+
+    const QList<ResourceLocation> locations{ResourceLocation(temp.root(), ResourceTier::User)};
+    const quint64 before = InventorySnapshot::locationStamp(locations);
+
+    // Folder mtimes have millisecond resolution here; set one explicitly
+    ASSERT_FALSE(temp.write("examples/Basics/sphere.scad", "sphere();").isEmpty());
+    const std::filesystem::path basics = temp.path("examples/Basics").toStdString();
+    std::filesystem::last_write_time(basics, std::filesystem::last_write_time(basics) + std::chrono::seconds(5));
+    EXPECT_NE(before, InventorySnapshot::locationStamp(locations));
+}
+
+TEST(InventorySnapshotTest, KeyIgnoresLocationOrder) {
+    const ResourceLocation a("/opt/one", ResourceTier::Machine);
+    const ResourceLocation b("/home/user/two", ResourceTier::User);
+
+    EXPECT_EQ(SharedInventory::keyForLocations({a, b}),
+              SharedInventory::keyForLocations({b, a}));
+    EXPECT_NE(SharedInventory::keyForLocations({a}),
+              SharedInventory::keyForLocations({a, b}));
+}
+
+// ============================================================================
+// Shared Memory Tests
+// ============================================================================
+
+TEST(SharedInventoryTest, SiblingLoadsPublishedSnapshot) {
+    QTemporaryDir temp;
+    ASSERT_TRUE(temp.isValid());
+    const QList<ResourceLocation> locations{ResourceLocation(temp.path(), ResourceTier::User)};
+
+    QList<ResourceItem> items;
+    items.append(makeItem(temp.path() + "/templates/box.json", ResourceType::Templates, ResourceTier::User, "shapes"));
+
+    SharedInventory publisher(locations);
+    QList<ResourceItem> none;
+    EXPECT_FALSE(publisher.load(none));
+    if (!publisher.publish(items)) {
+        GTEST_SKIP() << "Shared memory unavailable on this system";
+    }
+    EXPECT_EQ(publisher.generation(), 1u);
+
+    SharedInventory sibling(locations);
+    QList<ResourceItem> loaded;
+    ASSERT_TRUE(sibling.load(loaded));
+    EXPECT_EQ(sibling.generation(), 1u);
+    ASSERT_EQ(loaded.size(), 1);
+    EXPECT_EQ(loaded[0].path(), items[0].path());
+
+    // Republishing bumps the generation seen by siblings
+    EXPECT_TRUE(sibling.publish(items));
+    EXPECT_EQ(sibling.generation(), 2u);
+}
+
+// ============================================================================
+// Install Index Tests
+// ============================================================================
+
+TEST(InstallIndexTest, LoadsCurrentIndexWithAbsolutePaths) {
+    QTemporaryDir temp;
+    ASSERT_TRUE(temp.isValid());
+    ASSERT_TRUE(QDir(temp.path()).mkpath("templates"));
+    const ResourceLocation location(temp.path(), ResourceTier::Installation);
+
+    QList<ResourceItem> items;
+    ResourceItem item = makeItem(temp.path() + "/templates/box.json", ResourceType::Templates,
+                                 ResourceTier::Installation, "shapes");
+    item.setSourcePath(item.path());
+    items.append(item);
+
+    QString error;
+    ASSERT_TRUE(InstallIndex::write(location, items, &error)) << error.toStdString();
+
+    QList<ResourceItem> loaded;
+    ASSERT_TRUE(InstallIndex::load(location, loaded));
+    ASSERT_EQ(loaded.size(), 1);
+    EXPECT_EQ(loaded[0].path(), QDir::cleanPath(item.path()));
+    EXPECT_EQ(loaded[0].sourcePath(), QDir::cleanPath(item.sourcePath()));
+    EXPECT_EQ(loaded[0].sourceLocationKey(), location.getDisplayName());
+}
+
+TEST(InstallIndexTest, StaleIndexIsRejected) {
+    QTemporaryDir temp;
+    ASSERT_TRUE(temp.isValid());
+    ASSERT_TRUE(QDir(temp.path()).mkpath("templates"));
+    const ResourceLocation location(temp.path(), ResourceTier::Installation);
+
+    ASSERT_TRUE(InstallIndex::write(location, {}));
+    QList<ResourceItem> loaded;
+    ASSERT_TRUE(InstallIndex::load(location, loaded));
+
+    // Touching the marker invalidates the index
+    QFile marker(QDir(temp.path()).filePath(InstallIndex::markerFileName));
+    ASSERT_TRUE(marker.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(marker.setFileTime(QDateTime::currentDateTime().addDays(1), QFileDevice::FileModificationTime));
+    marker.close();
+    EXPECT_FALSE(InstallIndex::load(location, loaded));
+
+    ASSERT_TRUE(marker.remove());
+    EXPECT_FALSE(InstallIndex::load(location, loaded));
+}
+
+TEST(InstallIndexTest, StampDoesNotWalkTheTree) {
+    testSupport::TempTree temp;
+    ASSERT_TRUE(temp.isValid());
+    ASSERT_FALSE(temp.write("templates/box.json", R"({"name": "Box", "body": "cube();"})").isEmpty());
+    const ResourceLocation location(temp.root(), ResourceTier::Installation);
+    ASSERT_TRUE(InstallIndex::write(location, {}));
+    const quint64 stamp = InstallIndex::packageStamp(temp.root());
+    EXPECT_NE(stamp, 0u);
+
+    // Installed trees are replaced by upgrades, not edited in place
+    ASSERT_FALSE(temp.write("templates/more/sphere.json", R"({"name": "Sphere"})").isEmpty());
+    EXPECT_EQ(InstallIndex::packageStamp(temp.root()), stamp);
+    QList<ResourceItem> loaded;
+    EXPECT_TRUE(InstallIndex::load(location, loaded));
+}
+
+TEST(InstallIndexTest, MissingIndex) {
+    QTemporaryDir temp;
+    ASSERT_TRUE(temp.isValid());
+
+    QList<ResourceItem> loaded;
+    EXPECT_FALSE(InstallIndex::load(ResourceLocation(temp.path(), ResourceTier::Installation), loaded));
+}
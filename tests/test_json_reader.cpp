@@ -0,0 +1,360 @@
+/**
+ * @file test_json_reader.cpp
+ * @brief Unit tests for JsonReader file loading, member extraction and diagnostics
+ */
+
+#include <jsonreader/JsonBackend.hpp>
+#include <jsonreader/JsonReader.hpp>
+#include <resourceScanning/templateScanner.hpp>
+#include <QFile>
+#include <gtest/gtest.h>
+
+#include "tempTree.hpp"
+
+TEST(JsonReaderMembersTest, ExtractsRequestedStringMembers) {
+    const QByteArray json = R"({"body": "cube(1);\n", "name": "Box", "category": "Shapes", "x": [1, {"y": "}"}]})";
+
+    QJsonObject members;
+    JsonErrorInfo error;
+    ASSERT_TRUE(JsonReader::readMembers(json, {"name", "category"}, members, error));
+    EXPECT_EQ(members.value("name").toString(), QString("Box"));
+    EXPECT_EQ(members.value("category").toString(), QString("Shapes"));
+    EXPECT_FALSE(members.contains("body"));
+}
+
+TEST(JsonReaderMembersTest, MissingKeyIsAbsent) {
+    QJsonObject members;
+    JsonErrorInfo error;
+    ASSERT_TRUE(JsonReader::readMembers(QByteArray(R"({"name": "Box"})"), {"name", "category"}, members, error));
+    EXPECT_TRUE(members.contains("name"));
+    EXPECT_FALSE(members.contains("category"));
+}
+
+TEST(JsonReaderMembersTest, DecodesEscapes) {
+    QJsonObject members;
+    JsonErrorInfo error;
+    ASSERT_TRUE(JsonReader::readMembers(QByteArray(R"({"name": "a\"bé"})"), {"name"}, members, error));
+    EXPECT_EQ(members.value("name").toString(), QString::fromUtf8("a\"b\xc3\xa9"));
+}
+
+TEST(JsonReaderMembersTest, NonStringValuesAreParsed) {
+    QJsonObject members;
+    JsonErrorInfo error;
+    ASSERT_TRUE(JsonReader::readMembers(QByteArray(R"({"parameters": ["a", "b"], "n": 3})"),
+                                        {"parameters", "n"}, members, error));
+    EXPECT_TRUE(members.value("parameters").isArray());
+    EXPECT_EQ(members.value("n").toInt(), 3);
+}
+
+TEST(JsonReaderMembersTest, StopsOnceKeysAreFound) {
+    // Garbage after the last requested key is not looked at
+    QJsonObject members;
+    JsonErrorInfo error;
+    EXPECT_TRUE(JsonReader::readMembers(QByteArray(R"({"name": "Box", oops)"), {"name"}, members, error));
+}
+
+TEST(JsonReaderMembersTest, ReportsErrorsBeforeKeys) {
+    QJsonObject members;
+    JsonErrorInfo error;
+    EXPECT_FALSE(JsonReader::readMembers(QByteArray("{ invalid json ]["), {"name"}, members, error));
+    EXPECT_TRUE(error.hasError());
+    EXPECT_EQ(error.line, 1);
+
+    EXPECT_FALSE(JsonReader::readMembers(QByteArray("[1, 2]"), {"name"}, members, error));
+}
+
+namespace {
+
+std::string writeTempFile(const testSupport::TempTree& dir, const QString& name, const QByteArray& content)
+{
+    return dir.write(name, content).toStdString();
+}
+
+// Restores the default map threshold when a test changes it
+struct MapThresholdGuard {
+    qint64 saved = JsonReader::mapThreshold();
+    ~MapThresholdGuard() { JsonReader::setMapThreshold(saved); }
+};
+
+} // namespace
+
+TEST(JsonReaderFileTest, SmallFilesAreRead) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const std::string path = writeTempFile(dir, "small.json", R"({"name": "Box"})");
+
+    JsonErrorInfo error;
+    const auto content = JsonFileContent::open(path, error);
+    ASSERT_TRUE(content);
+    EXPECT_FALSE(content->isMapped());
+    EXPECT_EQ(content->data(), QByteArray(R"({"name": "Box"})"));
+}
+
+TEST(JsonReaderFileTest, LargeFilesAreMapped) {
+    MapThresholdGuard guard;
+    JsonReader::setMapThreshold(0);
+
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QByteArray json = "{\r\n  \"name\": \"Box\",\r\n  \"body\": \"" + QByteArray(4096, 'x') + "\"\r\n}\r\n";
+    const std::string path = writeTempFile(dir, "large.json", json);
+
+    // Mapped only where the caller allows it
+    JsonErrorInfo error;
+    EXPECT_FALSE(JsonFileContent::open(path, error)->isMapped());
+    const auto content = JsonFileContent::open(path, error, JsonFileContent::Access::MapLarge);
+    ASSERT_TRUE(content);
+    EXPECT_TRUE(content->isMapped());
+    EXPECT_EQ(content->data(), json);
+
+    QJsonObject obj;
+    ASSERT_TRUE(JsonReader::readObject(path, obj, error));
+    EXPECT_EQ(obj.value("name").toString(), QString("Box"));
+    EXPECT_EQ(obj.value("body").toString().size(), 4096);
+
+    QJsonObject members;
+    ASSERT_TRUE(JsonReader::readMembers(path, {"name"}, members, error));
+    EXPECT_EQ(members.value("name").toString(), QString("Box"));
+}
+
+TEST(JsonReaderFileTest, MappedFileErrorsHaveLineNumbers) {
+    MapThresholdGuard guard;
+    JsonReader::setMapThreshold(0);
+
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const std::string path = writeTempFile(dir, "bad.json", "{\n  \"name\": \"Box\",\n  oops\n}\n");
+
+    JsonErrorInfo error;
+    const auto content = JsonFileContent::open(path, error, JsonFileContent::Access::MapLarge);
+    ASSERT_TRUE(content);
+    ASSERT_TRUE(content->isMapped());
+    QJsonDocument doc;
+    EXPECT_FALSE(JsonReader::parseContent(content->data(), doc, error));
+    EXPECT_EQ(error.line, 3);
+    EXPECT_EQ(error.filename, path);
+}
+
+TEST(JsonReaderFileTest, MissingFileReportsError) {
+    JsonErrorInfo error;
+    EXPECT_FALSE(JsonFileContent::open("/nonexistent/file.json", error));
+    EXPECT_TRUE(error.hasError());
+}
+
+TEST(JsonLineIndexTest, LocatesOffsets) {
+    const JsonLineIndex index(QByteArray("ab\ncd\n\nef"));
+    EXPECT_EQ(index.lineCount(), 4);
+
+    int line = 0;
+    int column = 0;
+    index.locate(0, line, column);
+    EXPECT_EQ(line, 1);
+    EXPECT_EQ(column, 1);
+    index.locate(4, line, column);  // 'd'
+    EXPECT_EQ(line, 2);
+    EXPECT_EQ(column, 2);
+    index.locate(6, line, column);  // empty line
+    EXPECT_EQ(line, 3);
+    EXPECT_EQ(column, 1);
+    index.locate(8, line, column);  // 'f'
+    EXPECT_EQ(line, 4);
+    EXPECT_EQ(column, 2);
+}
+
+TEST(JsonReaderValidateTest, ReportsAllSchemaErrorsWithLocations) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const std::string bad = writeTempFile(dir, "bad.json",
+                                          "{\n  \"name\": 3,\n  \"category\": [],\n  \"body\": \"x\"\n}\n");
+    const std::string good = writeTempFile(dir, "good.json", R"({"name": "Box"})");
+    const std::string broken = writeTempFile(dir, "broken.json", "{\n  \"name\": \"Box\"\n  \"x\": 1\n}\n");
+
+    const auto results = JsonReader::validateMany({bad, good, broken}, &TemplateScanner::checkTemplateJson);
+    ASSERT_EQ(results.size(), 3u);
+
+    ASSERT_EQ(results[0].diagnostics.size(), 2u);
+    EXPECT_EQ(results[0].filename, bad);
+    EXPECT_EQ(results[0].diagnostics[0].line, 2);
+    EXPECT_EQ(results[0].diagnostics[0].column, 3);
+    EXPECT_EQ(results[0].diagnostics[1].line, 3);
+
+    EXPECT_TRUE(results[1].ok());
+
+    ASSERT_EQ(results[2].diagnostics.size(), 1u);
+    EXPECT_EQ(results[2].diagnostics[0].line, 3);
+}
+
+TEST(JsonReaderValidateTest, MissingFileIsADiagnostic) {
+    const auto result = JsonReader::validate("/nonexistent/file.json");
+    ASSERT_EQ(result.diagnostics.size(), 1u);
+    EXPECT_FALSE(result.ok());
+}
+
+TEST(JsonReaderReadManyTest, ResultsAreInInputOrder) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    std::vector<std::string> paths;
+    for (int i = 0; i < 40; ++i) {
+        const QByteArray json = "{\"n\": " + QByteArray::number(i) + ", \"pad\": \"" + QByteArray(i * 97, 'x') + "\"}";
+        paths.push_back(writeTempFile(dir, QString("f%1.json").arg(i), json));
+    }
+    paths.push_back(writeTempFile(dir, "bad.json", "{\n oops"));
+    paths.push_back("/nonexistent/file.json");
+
+    const auto results = JsonReader::readMany(paths, 3);
+    ASSERT_EQ(results.size(), paths.size());
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(results[size_t(i)].ok());
+        EXPECT_EQ(results[size_t(i)].doc.object().value("n").toInt(), i);
+    }
+    EXPECT_FALSE(results[40].ok());
+    EXPECT_EQ(results[40].error.line, 2);
+    EXPECT_FALSE(results[41].ok());
+}
+
+TEST(JsonReaderReadManyTest, StreamingCallbackIsOrdered) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    std::vector<std::string> paths;
+    for (int i = 0; i < 100; ++i) {
+        paths.push_back(writeTempFile(dir, QString("f%1.json").arg(i), "[" + QByteArray::number(i) + "]"));
+    }
+
+    std::vector<size_t> order;
+    JsonReader::readMany(paths, [&](size_t index, JsonReadResult& result) {
+        ASSERT_TRUE(result.ok());
+        EXPECT_EQ(result.doc.array().at(0).toInt(), int(index));
+        order.push_back(index);
+    }, 4);
+
+    ASSERT_EQ(order.size(), paths.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(JsonEventReaderTest, ReportsTokensInOrder) {
+    using Token = JsonEventReader::Token;
+    JsonEventReader reader(QByteArray(R"({"a": [1, "x\n", true, null], "b": {}, "c": -2.5e1})"));
+
+    EXPECT_EQ(reader.next(), Token::BeginObject);
+    EXPECT_EQ(reader.next(), Token::Key);
+    EXPECT_TRUE(reader.textEquals("a"));
+    EXPECT_EQ(reader.next(), Token::BeginArray);
+    EXPECT_EQ(reader.depth(), 2);
+    EXPECT_EQ(reader.next(), Token::Number);
+    EXPECT_EQ(reader.number(), 1.0);
+    EXPECT_EQ(reader.next(), Token::String);
+    EXPECT_EQ(reader.text(), QString("x\n"));
+    EXPECT_EQ(reader.next(), Token::Bool);
+    EXPECT_TRUE(reader.boolean());
+    EXPECT_EQ(reader.next(), Token::Null);
+    EXPECT_EQ(reader.next(), Token::EndArray);
+    EXPECT_EQ(reader.next(), Token::Key);
+    EXPECT_EQ(reader.text(), QString("b"));
+    EXPECT_EQ(reader.next(), Token::BeginObject);
+    EXPECT_EQ(reader.next(), Token::EndObject);
+    EXPECT_EQ(reader.next(), Token::Key);
+    EXPECT_EQ(reader.next(), Token::Number);
+    EXPECT_EQ(reader.number(), -25.0);
+    EXPECT_EQ(reader.next(), Token::EndObject);
+    EXPECT_EQ(reader.next(), Token::End);
+    EXPECT_FALSE(reader.hasError());
+}
+
+TEST(JsonEventReaderTest, SkipsValues) {
+    using Token = JsonEventReader::Token;
+    JsonEventReader reader(QByteArray(R"({"skip": {"x": [1, {"y": "]"}]}, "keep": "v"})"));
+
+    ASSERT_EQ(reader.next(), Token::BeginObject);
+    ASSERT_EQ(reader.next(), Token::Key);
+    ASSERT_TRUE(reader.skipValue());
+    ASSERT_EQ(reader.next(), Token::Key);
+    EXPECT_TRUE(reader.textEquals("keep"));
+    ASSERT_EQ(reader.next(), Token::String);
+    EXPECT_EQ(reader.text(), QString("v"));
+    EXPECT_EQ(reader.next(), Token::EndObject);
+    EXPECT_EQ(reader.next(), Token::End);
+}
+
+TEST(JsonEventReaderTest, ErrorsAreLocatedAndSticky) {
+    using Token = JsonEventReader::Token;
+    JsonEventReader reader(QByteArray("{\n  \"a\": 1\n  \"b\": 2\n}"));
+
+    EXPECT_EQ(reader.next(), Token::BeginObject);
+    EXPECT_EQ(reader.next(), Token::Key);
+    EXPECT_EQ(reader.next(), Token::Number);
+    EXPECT_EQ(reader.next(), Token::Error);
+    EXPECT_EQ(reader.error().line, 3);
+    EXPECT_EQ(reader.error().column, 3);
+    EXPECT_EQ(reader.next(), Token::Error);
+
+    JsonEventReader trailing(QByteArray("[] x"));
+    EXPECT_EQ(trailing.next(), Token::BeginArray);
+    EXPECT_EQ(trailing.next(), Token::EndArray);
+    EXPECT_EQ(trailing.next(), Token::Error);
+
+    JsonEventReader truncated(QByteArray(R"({"a": [1, 2)"));
+    truncated.next();
+    truncated.next();
+    EXPECT_FALSE(truncated.skipValue());
+    EXPECT_TRUE(truncated.hasError());
+}
+
+TEST(JsonEventReaderTest, RejectsInvalidNumbersAndStrings) {
+    using Token = JsonEventReader::Token;
+    const auto lastToken = [](const QByteArray& json) {
+        JsonEventReader reader(json);
+        Token token = Token::None;
+        do {
+            token = reader.next();
+        } while (token != Token::End && token != Token::Error);
+        return token;
+    };
+
+    EXPECT_EQ(lastToken(R"([0, -0.5e+3, 1E2, "\u00e9\/"])"), Token::End);
+    for (const QByteArray json : {QByteArray("[1-2]"), QByteArray("[1e]"), QByteArray("[-]"),
+                                  QByteArray("[01]"), QByteArray("[1.]"), QByteArray("[.5]"),
+                                  QByteArray("[\"a\tb\"]"), QByteArray(R"(["\x"])"),
+                                  QByteArray(R"(["\u12G4"])"), QByteArray(R"({"k\q": 1})")}) {
+        SCOPED_TRACE(json.constData());
+        EXPECT_EQ(lastToken(json), Token::Error);
+        QJsonDocument doc;
+        JsonErrorInfo error;
+        EXPECT_FALSE(JsonBackend::find("event")->parse(json, doc, error));
+    }
+}
+
+TEST(JsonBackendTest, BackendsAgreeWithQt) {
+    const QByteArray json = R"({"for": {"prefix": "for", "body": ["for (i = [0:$1]) {", "\t$0", "}"],
+        "n": 3, "x": -0.25, "big": 1e300, "ok": true, "none": null, "u": "\u00e9\ud83d\ude00"}})";
+
+    QJsonDocument expected;
+    JsonErrorInfo error;
+    ASSERT_TRUE(JsonBackend::find("qt")->parse(json, expected, error));
+
+    ASSERT_EQ(JsonBackend::all().size(), 3u);
+    for (const JsonBackend* backend : JsonBackend::all()) {
+        SCOPED_TRACE(backend->name());
+        QJsonDocument doc;
+        ASSERT_TRUE(backend->parse(json, doc, error)) << error.message;
+        EXPECT_EQ(doc, expected);
+    }
+    EXPECT_NE(JsonBackend::find(JsonBackend::active().name()), nullptr);
+    EXPECT_EQ(JsonBackend::find("yaml"), nullptr);
+}
+
+TEST(JsonBackendTest, ErrorsHaveOffsets) {
+    for (const JsonBackend* backend : JsonBackend::all()) {
+        SCOPED_TRACE(backend->name());
+        QJsonDocument doc;
+        JsonErrorInfo error;
+        EXPECT_FALSE(backend->parse(QByteArray("{\"a\": [1, }"), doc, error));
+        EXPECT_TRUE(error.hasError());
+        EXPECT_GE(error.offset, 8);
+
+        // QJsonDocument holds only objects and arrays
+        error.clear();
+        EXPECT_FALSE(backend->parse(QByteArray("42"), doc, error));
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_json_writer.cpp
+ * @brief Unit tests for the streaming JsonWriter, template export and streaming import
+ */
+
+#include <jsonreader/JsonWriter.hpp>
+#include <scadtemplates/template_manager.hpp>
+#include <scadtemplates/template_parser.hpp>
+#include <gtest/gtest.h>
+
+#include "tempTree.hpp"
+
+#include <QBuffer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <functional>
+
+namespace {
+
+QByteArray writeDocument(const std::function<void(JsonWriter&)>& body, int indent = 2,
+                         qsizetype bufferSize = 64 * 1024)
+{
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    JsonWriter writer(&buffer, indent, bufferSize);
+    body(writer);
+    EXPECT_TRUE(writer.finish());
+    return out;
+}
+
+} // namespace
+
+TEST(JsonWriterTest, EscapesStrings) {
+    const QString tricky = QString::fromUtf8("a\"b\\c\nd\te\x01 \xc3\xa9 \xf0\x9f\x98\x80");
+    const QByteArray json = writeDocument([&](JsonWriter& writer) {
+        writer.beginObject();
+        writer.member(u"text", tricky);
+        writer.endObject();
+    });
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    ASSERT_EQ(error.error, QJsonParseError::NoError) << json.constData();
+    EXPECT_EQ(doc.object().value("text").toString(), tricky);
+    EXPECT_TRUE(json.contains("\\u0001"));
+}
+
+TEST(JsonWriterTest, EscapedSizeMatchesOutput) {
+    const QString text = QString::fromUtf8("x\"\n\x02\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    const QByteArray json = writeDocument([&](JsonWriter& writer) { writer.value(text); }, 0);
+    EXPECT_EQ(json.size() - 1, JsonWriter::escapedSize(text));  // Without the final newline
+}
+
+TEST(JsonWriterTest, WritesNestedContainersAndScalars) {
+    const QByteArray json = writeDocument([](JsonWriter& writer) {
+        writer.beginObject();
+        writer.member(u"n", qint64(-42));
+        writer.key(u"flags");
+        writer.beginArray();
+        writer.value(true);
+        writer.value(false);
+        writer.nullValue();
+        writer.endArray();
+        writer.key(u"empty");
+        writer.beginObject();
+        writer.endObject();
+        writer.endObject();
+    }, 0);
+
+    EXPECT_EQ(json, QByteArray(R"({"n":-42,"flags":[true,false,null],"empty":{}})" "\n"));
+}
+
+TEST(JsonWriterTest, StringsLargerThanTheBuffer) {
+    const QString big(100000, QLatin1Char('"'));
+    const QByteArray json = writeDocument([&](JsonWriter& writer) {
+        writer.beginArray();
+        for (int i = 0; i < 3; ++i) writer.value(big);
+        writer.endArray();
+    }, 2, 256);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    ASSERT_TRUE(doc.isArray());
+    EXPECT_EQ(doc.array().size(), 3);
+    EXPECT_EQ(doc.array().at(2).toString(), big);
+}
+
+TEST(TemplateExportTest, RoundTripsBodiesWithQuotesAndNewlines) {
+    ResourceTemplate tmpl;
+    tmpl.setPrefix(QStringLiteral("say"));
+    tmpl.setName(QStringLiteral("say"));
+    tmpl.setDescription(QStringLiteral("Prints \"hello\""));
+    tmpl.setBody(QStringLiteral("echo(\"a\\\\b\");\n\n$0"));
+
+    scadtemplates::TemplateParser parser;
+    const QString json = parser.toJson(QList<ResourceTemplate>{tmpl});
+    const scadtemplates::ParseResult result = parser.parseJson(json);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    ASSERT_EQ(result.templates.size(), 1);
+    EXPECT_EQ(result.templates[0].prefix(), tmpl.prefix());
+    EXPECT_EQ(result.templates[0].description(), tmpl.description());
+    EXPECT_EQ(result.templates[0].body(), tmpl.body());
+}
+
+TEST(TemplateStreamTest, StreamsLargeCollectionsInFileOrder) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path(QStringLiteral("snippets.json"));
+
+    QList<ResourceTemplate> templates;
+    for (int i = 0; i < 5000; ++i) {
+        ResourceTemplate tmpl;
+        tmpl.setPrefix(QStringLiteral("t%1").arg(4999 - i));
+        tmpl.setDescription(QStringLiteral("Template %1").arg(i));
+        tmpl.setBody(QStringLiteral("cube(%1);\n$0").arg(i));
+        templates.append(tmpl);
+    }
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(scadtemplates::TemplateParser::writeJson(&file, templates));
+    file.close();
+
+    scadtemplates::TemplateParser parser;
+    QList<QString> prefixes;
+    const scadtemplates::StreamParseResult result = parser.parseFile(path,
+        [&](ResourceTemplate&& tmpl) {
+            if (prefixes.isEmpty()) {
+                EXPECT_EQ(tmpl.body(), templates[0].body());
+                EXPECT_EQ(tmpl.description(), templates[0].description());
+                EXPECT_EQ(tmpl.source(), QString("cppsnippet-made"));
+            }
+            prefixes.append(tmpl.prefix());
+            return true;
+        });
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(result.count, 5000);
+    ASSERT_EQ(prefixes.size(), 5000);
+    EXPECT_EQ(prefixes.first(), QString("t4999"));
+    EXPECT_EQ(prefixes.last(), QString("t0"));
+
+    scadtemplates::TemplateManager manager;
+    ASSERT_TRUE(manager.loadFromFile(path));
+    EXPECT_EQ(manager.count(), 5000u);
+    ASSERT_TRUE(manager.findByPrefix(QStringLiteral("t17")).has_value());
+    EXPECT_EQ(manager.findByPrefix(QStringLiteral("t17"))->body(), templates[4982].body());
+    EXPECT_TRUE(manager.removeTemplate(QStringLiteral("t4999")));
+    EXPECT_EQ(manager.findByPrefix(QStringLiteral("t0"))->body(), templates[4999].body());
+}
+
+TEST(TemplateStreamTest, StopsAndReportsSyntaxErrors) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write(QStringLiteral("broken.json"),
+        R"({"a": {"prefix": "a", "body": "one"}, "b": {"prefix": "b", "body": ["x", "y"]}, "c": {)");
+    ASSERT_FALSE(path.isEmpty());
+
+    scadtemplates::TemplateParser parser;
+    QList<QString> bodies;
+    scadtemplates::StreamParseResult result = parser.parseFile(path, [&](ResourceTemplate&& tmpl) {
+        bodies.append(tmpl.body());
+        return true;
+    });
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorMessage.isEmpty());
+    EXPECT_EQ(bodies, (QList<QString>{QStringLiteral("one"), QStringLiteral("x\ny")}));
+
+    // Stopping early skips the rest, errors included
+    result = parser.parseFile(path, [](ResourceTemplate&&) { return false; });
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.count, 1);
+}
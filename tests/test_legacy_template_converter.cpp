@@ -0,0 +1,216 @@
+/**
+ * @file test_legacy_template_converter.cpp
+ * @brief Unit tests for the streaming legacy-to-modern transcoder
+ */
+
+#include <scadtemplates/legacy_template_converter.hpp>
+#include <scadtemplates/conversion_manifest.hpp>
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "tempTree.hpp"
+
+using scadtemplates::LegacyTemplateConverter;
+
+namespace {
+
+// The separate passes the fused transcoder replaces
+QStringList twoPassBody(const QString& content)
+{
+    return LegacyTemplateConverter::unescapeNewlines(
+        LegacyTemplateConverter::convertCursorMarker(content)).split(QLatin1Char('\n'));
+}
+
+} // namespace
+
+TEST(LegacyTranscoderTest, FusedPassMatchesSeparateRewrites) {
+    const QStringList contents = {
+        QString(),
+        QStringLiteral("cube(1);"),
+        QStringLiteral("module m() {\\n  ^~^\\n}"),
+        QStringLiteral("^~^^~^\\n\\n"),
+        QStringLiteral("a\\\\nb ^~ ~^ \\"),
+        QStringLiteral("real\nnewline\\nand ^~^"),
+    };
+    for (const QString& content : contents) {
+        EXPECT_EQ(LegacyTemplateConverter::convertContentToBody(content), twoPassBody(content))
+            << content.toStdString();
+    }
+}
+
+TEST(LegacyTranscoderTest, WritesModernSnippet) {
+    const QByteArray legacy = R"({"key": "for", "content": "for (i = [0:10]) {\\n  ^~^\\n}"})";
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QString prefix;
+    ASSERT_TRUE(LegacyTemplateConverter::transcodeLegacyJson(legacy, &buffer, QStringLiteral("/t/for.json"),
+                                                             &prefix));
+    EXPECT_EQ(prefix, QStringLiteral("for"));
+
+    const QJsonObject entry = QJsonDocument::fromJson(out).object().value("for").toObject();
+    EXPECT_EQ(entry.value("_source").toString(), QStringLiteral("legacy-converted"));
+    EXPECT_EQ(entry.value("prefix").toString(), QStringLiteral("for"));
+    EXPECT_EQ(entry.value("description").toString(), QStringLiteral("Converted from legacy template (for.json)"));
+    EXPECT_EQ(entry.value("body").toArray(),
+              QJsonArray({QStringLiteral("for (i = [0:10]) {"), QStringLiteral("  $0"), QStringLiteral("}")}));
+}
+
+TEST(LegacyTranscoderTest, RejectsNonLegacyInput) {
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QString error;
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyJson(R"({"name": "x"})", &buffer, QString(),
+                                                              nullptr, &error));
+    EXPECT_FALSE(error.isEmpty());
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyJson(R"({"key": "", "content": "x"})", &buffer));
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyJson("{\"key\": ", &buffer));
+}
+
+TEST(LegacyTranscoderTest, RejectsTruncatedOrMalformedSource) {
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QString error;
+    // Both members are complete before the document breaks off
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyJson(
+        R"({"key": "cube", "content": "cube(1);", "extra": [1, 2)", &buffer, QString(), nullptr, &error));
+    EXPECT_FALSE(error.isEmpty());
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyJson(
+        R"({"key": "cube", "content": "cube(1);"} trailing)", &buffer));
+    EXPECT_TRUE(out.isEmpty());
+
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString inputPath = dir.write("cube.json", R"({"key": "cube", "content": "cube(^~^);", "na)");
+    ASSERT_FALSE(inputPath.isEmpty());
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyFile(inputPath, dir.path("out.json")));
+    EXPECT_FALSE(QFileInfo::exists(dir.path("out.json")));
+}
+
+TEST(LegacyTranscoderTest, RepeatedMemberTakesLastValue) {
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QString prefix;
+    ASSERT_TRUE(LegacyTemplateConverter::transcodeLegacyJson(
+        R"({"key": "old", "content": "a", "key": "new", "content": "b"})", &buffer, QString(), &prefix));
+    EXPECT_EQ(prefix, QStringLiteral("new"));
+    const QJsonObject entry = QJsonDocument::fromJson(out).object().value("new").toObject();
+    EXPECT_EQ(entry.value("body").toArray(), QJsonArray({QStringLiteral("b")}));
+}
+
+TEST(LegacyTranscoderTest, TranscodesFiles) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString inputPath = dir.write("cube.json", R"({"key": "cube", "content": "cube(^~^);"})");
+    ASSERT_FALSE(inputPath.isEmpty());
+
+    const QString outputPath = dir.path("out/cube.json");
+    QString error;
+    EXPECT_FALSE(LegacyTemplateConverter::transcodeLegacyFile(inputPath, outputPath, nullptr, &error));
+
+    ASSERT_TRUE(dir.mkdir("out"));
+    ASSERT_TRUE(LegacyTemplateConverter::transcodeLegacyFile(inputPath, outputPath, nullptr, &error))
+        << error.toStdString();
+    QFile output(outputPath);
+    ASSERT_TRUE(output.open(QIODevice::ReadOnly));
+    const QJsonObject entry = QJsonDocument::fromJson(output.readAll()).object().value("cube").toObject();
+    EXPECT_EQ(entry.value("body").toArray(), QJsonArray({QStringLiteral("cube($0);")}));
+}
+
+TEST(LegacyTranscoderTest, ConvertsIncrementallyWithManifest) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const auto writeLegacy = [&](const QString& name, const QByteArray& content) {
+        return dir.write("legacy/" + name + ".json",
+                         R"({"key": ")" + name.toUtf8() + R"(", "content": ")" + content + R"("})");
+    };
+
+    QList<LegacyTemplateConverter::ConversionJob> jobs;
+    for (const QString& name : {QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")}) {
+        jobs.append({writeLegacy(name, "cube();"), "user/" + name + ".json"});
+    }
+    jobs.append({dir.path("legacy/missing.json"), QStringLiteral("user/missing.json")});
+    const QString outputDir = dir.path("out");
+
+    auto results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir, 2);
+    ASSERT_EQ(results.size(), 4);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(results[i].success);
+        EXPECT_FALSE(results[i].skipped);
+        EXPECT_EQ(results[i].convertedTemplate.prefix(), QFileInfo(jobs[i].sourcePath).completeBaseName());
+        EXPECT_EQ(results[i].convertedTemplate.body(), QStringLiteral("cube();"));
+        EXPECT_EQ(results[i].rawContent, QStringLiteral("cube();"));
+    }
+    EXPECT_FALSE(results[3].success);
+    EXPECT_TRUE(QFileInfo::exists(QDir(outputDir).filePath(scadtemplates::ConversionManifest::fileName)));
+
+    // Nothing changed: nothing is written, and without content nothing is read
+    results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(results[i].success);
+        EXPECT_TRUE(results[i].skipped);
+        EXPECT_EQ(results[i].convertedTemplate.prefix(), QFileInfo(jobs[i].sourcePath).completeBaseName());
+        EXPECT_EQ(results[i].convertedTemplate.body(), QStringLiteral("cube();"));
+    }
+    results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir, 0, false);
+    EXPECT_TRUE(results[0].skipped);
+    EXPECT_TRUE(results[0].convertedTemplate.body().isEmpty());
+
+    // An edited source and a deleted output are converted again
+    writeLegacy(QStringLiteral("b"), "sphere(r = 2);");
+    QFile::remove(QDir(outputDir).filePath("user/c.json"));
+    results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir);
+    EXPECT_TRUE(results[0].skipped);
+    EXPECT_FALSE(results[1].skipped);
+    EXPECT_FALSE(results[2].skipped);
+    EXPECT_TRUE(results[2].success);
+
+    QFile output(QDir(outputDir).filePath("user/b.json"));
+    ASSERT_TRUE(output.open(QIODevice::ReadOnly));
+    const QJsonObject entry = QJsonDocument::fromJson(output.readAll()).object().value("b").toObject();
+    EXPECT_EQ(entry.value("body").toArray(), QJsonArray({QStringLiteral("sphere(r = 2);")}));
+}
+
+TEST(LegacyTranscoderTest, RecordsSourcesThatAreNotLegacy) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString sourcePath = dir.write("legacy/modern.json", R"({"box": {"prefix": "box", "body": "cube();"}})");
+    ASSERT_FALSE(sourcePath.isEmpty());
+    const QList<LegacyTemplateConverter::ConversionJob> jobs{{sourcePath, QStringLiteral("user/modern.json")}};
+    const QString outputDir = dir.path("out");
+
+    auto results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_FALSE(results[0].success);
+    EXPECT_TRUE(results[0].notLegacy);
+    EXPECT_FALSE(results[0].skipped);
+    EXPECT_FALSE(QFileInfo::exists(QDir(outputDir).filePath("user/modern.json")));
+
+    scadtemplates::ConversionManifest manifest;
+    ASSERT_TRUE(manifest.load(outputDir));
+    ASSERT_NE(manifest.find(sourcePath), nullptr);
+    EXPECT_FALSE(manifest.find(sourcePath)->legacy);
+
+    // Known and unchanged: not read again
+    results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir);
+    EXPECT_TRUE(results[0].notLegacy);
+    EXPECT_TRUE(results[0].skipped);
+
+    // Rewritten as a legacy template (different size): converted
+    ASSERT_FALSE(dir.write("legacy/modern.json", R"({"key": "box", "content": "cube(2);"})").isEmpty());
+    results = LegacyTemplateConverter::convertIncrementally(jobs, outputDir);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_FALSE(results[0].notLegacy);
+    EXPECT_EQ(results[0].convertedTemplate.body(), QStringLiteral("cube(2);"));
+    EXPECT_TRUE(QFileInfo::exists(QDir(outputDir).filePath("user/modern.json")));
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_parsed_template_cache.cpp
+ * @brief Unit tests for the shared cache of parsed template files
+ */
+
+#include <resourceScanning/parsedTemplateCache.hpp>
+#include <resourceScanning/templateScanner.hpp>
+#include <platformInfo/ResourceLocation.hpp>
+#include <gtest/gtest.h>
+
+#include <QJsonObject>
+
+#include "tempTree.hpp"
+
+using namespace resourceInventory;
+
+TEST(ParsedTemplateCacheTest, ParsesOncePerChange) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write("box.json", R"({"name": "Box", "body": "cube(2);"})");
+    ASSERT_FALSE(path.isEmpty());
+
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    const qint64 misses = cache.misses();
+    const auto first = cache.get(path);
+    ASSERT_TRUE(first->ok());
+    EXPECT_EQ(first->document.object().value("name").toString(), QStringLiteral("Box"));
+    EXPECT_EQ(cache.get(path), first);
+    EXPECT_EQ(cache.misses(), misses + 1);
+
+    // Edited file: new fingerprint, parsed again
+    ASSERT_FALSE(dir.write("box.json", R"({"name": "Bigger box", "body": "cube(20);"})").isEmpty());
+    const auto edited = cache.get(path);
+    EXPECT_EQ(edited->document.object().value("name").toString(), QStringLiteral("Bigger box"));
+    EXPECT_EQ(cache.misses(), misses + 2);
+
+    // Failures are cached too
+    const QString broken = dir.write("broken.json", "{ oops");
+    const auto failed = cache.get(broken);
+    EXPECT_TRUE(failed->read);
+    EXPECT_FALSE(failed->ok());
+    EXPECT_EQ(cache.get(broken), failed);
+    EXPECT_FALSE(cache.get(dir.path("missing.json"))->read);
+}
+
+TEST(ParsedTemplateCacheTest, EvictsBeyondTheBudget) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    const qint64 budget = cache.byteBudget();
+    cache.clear();
+    cache.setByteBudget(4096);
+
+    for (int i = 0; i < 20; ++i) {
+        cache.get(dir.write(QStringLiteral("t%1.json").arg(i),
+                            R"({"name": "T", "body": ")" + QByteArray(500, 'x') + R"("})"));
+        EXPECT_LE(cache.bytesUsed(), 4096);
+    }
+    const qint64 misses = cache.misses();
+    cache.get(dir.path("t0.json"));  // Evicted long ago
+    EXPECT_EQ(cache.misses(), misses + 1);
+    cache.get(dir.path("t19.json"));
+    EXPECT_EQ(cache.misses(), misses + 1);
+
+    cache.setByteBudget(budget);
+}
+
+TEST(ParsedTemplateCacheTest, ListingSkipsTheDocument) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write("templates/sphere.json",
+                                   R"({"name": "Sphere", "category": "Solids", "body": "sphere(1);", "parameters": ["r"]})");
+    ASSERT_FALSE(path.isEmpty());
+
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    const qint64 misses = cache.misses();
+    const platformInfo::ResourceLocation location(dir.root(), ResourceTier::User);
+    QList<ResourceTemplate> templates = TemplateScanner::scanLocation(location);
+    ASSERT_EQ(templates.size(), 1);
+    EXPECT_EQ(templates[0].category(), QStringLiteral("Solids"));
+    EXPECT_EQ(cache.misses(), misses + 1);
+
+    // Listing members only
+    const auto listing = cache.listing(path);
+    ASSERT_TRUE(listing->ok());
+    EXPECT_EQ(listing->members.keys(), (QStringList{"category", "name"}));
+
+    // Opening parses the file once; the editor shares that document
+    ASSERT_TRUE(TemplateScanner::loadContent(templates[0]));
+    EXPECT_EQ(templates[0].body(), QStringLiteral("sphere(1);"));
+    EXPECT_EQ(templates[0].description(), QStringLiteral("Parameters: r"));
+    EXPECT_EQ(cache.misses(), misses + 2);
+    EXPECT_TRUE(cache.get(path)->ok());
+    EXPECT_EQ(TemplateScanner::scanLocation(location).size(), 1);
+    EXPECT_EQ(cache.misses(), misses + 2);
+}
+
+TEST(ParsedTemplateCacheTest, BrokenBodyIsListedButFailsToOpen) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("templates/cut.json",
+                           R"({"name": "Cut", "category": "Ops", "body": oops})").isEmpty());
+
+    const platformInfo::ResourceLocation location(dir.root(), ResourceTier::User);
+    QList<ResourceTemplate> templates = TemplateScanner::scanLocation(location);
+    ASSERT_EQ(templates.size(), 1);
+    EXPECT_EQ(templates[0].name(), QStringLiteral("Cut"));
+    EXPECT_FALSE(TemplateScanner::loadContent(templates[0]));
+
+    // A broken listing member is still rejected while listing
+    ASSERT_FALSE(dir.write("templates/cut.json", R"({"name": 7})").isEmpty());
+    EXPECT_TRUE(TemplateScanner::scanLocation(location).isEmpty());
+}
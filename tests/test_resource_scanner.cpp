@@ -0,0 +1,136 @@
+/**
+ * @file test_resource_scanner.cpp
+ * @brief Unit tests for the ResourceScanner scan rules
+ */
+
+#include <resourceScanning/resourceScanner.hpp>
+#include <resourceScanning/exampleDirManifest.hpp>
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardItemModel>
+
+#include "tempTree.hpp"
+
+using namespace resourceInventory;
+
+namespace {
+
+// Item and attachments (file names, sorted) as streamed by the scanner
+struct Found {
+    ResourceItem item;
+    bool isScript = false;
+    QStringList attachments;
+};
+
+ResourceScanner::ItemCallback collect(QList<Found>& found)
+{
+    return [&found](const ResourceItem& item) {
+        Found entry{item, false, {}};
+        if (const auto* script = dynamic_cast<const ResourceScript*>(&item)) {
+            entry.isScript = true;
+            for (const QString& path : script->attachments()) {
+                entry.attachments << QDir(QFileInfo(script->scriptPath()).absolutePath()).relativeFilePath(path);
+            }
+            entry.attachments.sort();
+        }
+        found.append(entry);
+    };
+}
+
+} // namespace
+
+TEST(ResourceScannerTest, CategoryTemplatesAreScriptsWithAttachments) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("templates/top.json", "{}").isEmpty());
+    ASSERT_FALSE(dir.write("templates/top.png", "").isEmpty());
+    ASSERT_FALSE(dir.write("templates/shapes/box.json", "{}").isEmpty());
+    ASSERT_FALSE(dir.write("templates/shapes/box.png", "").isEmpty());
+    ASSERT_FALSE(dir.write("templates/shapes/box/data.csv", "").isEmpty());
+
+    ResourceScanner scanner;
+    QList<Found> found;
+    scanner.scanTemplates(dir.path("templates"), ResourceTier::User, QStringLiteral("user"), collect(found));
+
+    // Top-level templates stay plain items; the box data folder is also a category
+    ASSERT_EQ(found.size(), 2);
+    EXPECT_EQ(found[0].item.name(), QStringLiteral("top"));
+    EXPECT_FALSE(found[0].isScript);
+    EXPECT_EQ(found[1].item.name(), QStringLiteral("box"));
+    EXPECT_EQ(found[1].item.category(), QStringLiteral("shapes"));
+    EXPECT_EQ(found[1].item.type(), ResourceType::Templates);
+    ASSERT_TRUE(found[1].isScript);
+    EXPECT_EQ(found[1].attachments, (QStringList{"box.png", "box/data.csv"}));
+}
+
+TEST(ResourceScannerTest, ExampleTestsFolderIsAGroup) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("examples/tests/cube_test.scad", "cube();").isEmpty());
+    ASSERT_FALSE(dir.write("examples/templates/t.json", "{}").isEmpty());
+
+    ResourceScanner scanner;
+    QList<Found> found;
+    scanner.scanExamples(dir.path("examples"), ResourceTier::User, QStringLiteral("user"), collect(found));
+
+    ASSERT_EQ(found.size(), 2);
+    // examples/templates is still delegated to the template rule
+    EXPECT_EQ(found[0].item.type(), ResourceType::Templates);
+    EXPECT_EQ(found[1].item.name(), QStringLiteral("cube_test"));
+    EXPECT_EQ(found[1].item.type(), ResourceType::Examples);
+    EXPECT_EQ(found[1].item.category(), QStringLiteral("tests"));
+}
+
+TEST(ResourceScannerTest, TrustedManifestListsOnlyPrimaryFiles) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("examples/cube.scad", "cube();").isEmpty());
+    ASSERT_FALSE(dir.write("examples/notes.txt", "").isEmpty());
+    const QString manifestPath = dir.write("examples/" + ExampleDirManifest::fileName,
+                                           R"({"scripts": ["cube.scad", "notes.txt"]})");
+    ASSERT_FALSE(manifestPath.isEmpty());
+    QFile manifestFile(manifestPath);
+    ASSERT_TRUE(manifestFile.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(manifestFile.setFileTime(QDateTime::currentDateTime().addSecs(60),
+                                         QFileDevice::FileModificationTime));
+    manifestFile.close();
+
+    ResourceScanner scanner;
+    QList<Found> found;
+    scanner.scanExamples(dir.path("examples"), ResourceTier::User, QStringLiteral("user"), collect(found));
+
+    // Listed names go through the rule's name filters like a listing would
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_EQ(found[0].item.name(), QStringLiteral("cube"));
+}
+
+TEST(ResourceScannerTest, ChangesMatchRowsByPathAndLocation) {
+    // One file listed by two locations
+    const auto makeItem = [](const QString& locationKey, const QString& description) {
+        ResourceItem item;
+        item.setPath(QStringLiteral("/shared/templates/box.json"));
+        item.setName(QStringLiteral("box"));
+        item.setDescription(description);
+        item.setSourceLocationKey(locationKey);
+        item.setType(ResourceType::Templates);
+        return item;
+    };
+    QList<ResourceItem> before{makeItem("user", "old"), makeItem("machine", "old")};
+    QList<ResourceItem> after{makeItem("machine", "new")};
+    ScanDiff::sortForDiff(before);
+    ScanDiff::sortForDiff(after);
+
+    ResourceScanner scanner;
+    QStandardItemModel model;
+    scanner.addItemsToModel(&model, {makeItem("user", "old"), makeItem("machine", "old")});
+    const QList<ScanDiff::Change> changes = ScanDiff::diff(before, after);
+    scanner.applyChangesToModel(&model, before, after, changes);
+
+    const QList<ResourceItem> rows = ResourceScanner::itemsInModel(&model);
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].sourceLocationKey(), QStringLiteral("machine"));
+    EXPECT_EQ(rows[0].description(), QStringLiteral("new"));
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_resource_table.cpp
+ * @brief Unit tests for the columnar ResourceTable and the StringPool
+ */
+
+#include <resourceInventory/resourceTable.hpp>
+#include <resourceInventory/stringPool.hpp>
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+
+#include <thread>
+#include <vector>
+
+using namespace resourceInventory;
+
+namespace {
+
+ResourceItem makeItem(const QString& path, const QString& category, ResourceTier tier)
+{
+    ResourceItem item;
+    item.setPath(path);
+    item.setName(path.section('/', -1));
+    item.setDescription(QStringLiteral("About ") + path);
+    item.setCategory(category);
+    item.setSourceLocationKey(QStringLiteral("user"));
+    item.setType(ResourceType::Templates);
+    item.setTier(tier);
+    item.setExists(true);
+    item.setLastModified(QDateTime::fromMSecsSinceEpoch(1700000000000));
+    return item;
+}
+
+} // namespace
+
+TEST(ResourceTableTest, RoundTripsItems) {
+    QList<ResourceItem> items{makeItem("/t/b.json", "shapes", ResourceTier::User),
+                              makeItem("/t/a.json", QString(), ResourceTier::Installation)};
+    items[1].setDisplayName(QStringLiteral("Alpha"));
+    items[1].setEnabled(false);
+    items[0].setSourcePath(items[0].path());
+    items[1].setSourcePath(QStringLiteral("/src/a.json"));
+
+    const ResourceTable table = ResourceTable::fromItems(items);
+    ASSERT_EQ(table.size(), 2);
+    const QList<ResourceItem> back = table.toItems();
+    ASSERT_EQ(back.size(), 2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(back[i].path(), items[i].path());
+        EXPECT_EQ(back[i].name(), items[i].name());
+        EXPECT_EQ(back[i].displayName(), items[i].displayName());
+        EXPECT_EQ(back[i].description(), items[i].description());
+        EXPECT_EQ(back[i].category(), items[i].category());
+        EXPECT_EQ(back[i].sourcePath(), items[i].sourcePath());
+        EXPECT_EQ(back[i].sourceLocationKey(), items[i].sourceLocationKey());
+        EXPECT_EQ(back[i].tier(), items[i].tier());
+        EXPECT_EQ(back[i].isEnabled(), items[i].isEnabled());
+        EXPECT_EQ(back[i].exists(), items[i].exists());
+        EXPECT_EQ(back[i].lastModified(), items[i].lastModified());
+    }
+}
+
+TEST(ResourceTableTest, RowIdsStayStableAcrossRemovalAndCompaction) {
+    ResourceTable table;
+    QList<ResourceTable::RowId> rows;
+    for (int i = 0; i < 100; ++i) {
+        rows.append(table.append(makeItem(QStringLiteral("/t/%1.json").arg(i), "c", ResourceTier::User)));
+    }
+    // Removing most rows compacts the text buffer
+    for (int i = 0; i < 90; ++i) {
+        EXPECT_TRUE(table.remove(rows[i]));
+    }
+    EXPECT_FALSE(table.remove(rows[0]));
+    EXPECT_FALSE(table.contains(rows[0]));
+    EXPECT_EQ(table.size(), 10);
+    EXPECT_EQ(table.path(rows[95]), QString("/t/95.json"));
+    EXPECT_EQ(table.item(rows[99]).description(), QString("About /t/99.json"));
+
+    EXPECT_TRUE(table.update(rows[95], makeItem("/t/renamed.json", "c", ResourceTier::User)));
+    EXPECT_EQ(table.name(rows[95]), QString("renamed.json"));
+
+    // New rows never reuse removed ids
+    EXPECT_EQ(table.append(makeItem("/t/new.json", "c", ResourceTier::User)), ResourceTable::RowId(100));
+}
+
+TEST(ResourceTableTest, ItemsKeepInternedIds) {
+    ResourceTable table;
+    const ResourceItem original = makeItem("/t/c.json", "shapes", ResourceTier::User);
+    const ResourceItem item = table.item(table.append(original));
+    EXPECT_EQ(item.categoryId(), original.categoryId());
+    EXPECT_EQ(item.locationKeyId(), original.locationKeyId());
+    EXPECT_EQ(item.category(), QString("shapes"));
+}
+
+TEST(StringPoolTest, InternsOnceAcrossThreads) {
+    StringPool& pool = StringPool::instance();
+    EXPECT_EQ(pool.intern(QString()), StringPool::kEmpty);
+    EXPECT_FALSE(pool.find(QStringLiteral("pool-test-never-interned")).has_value());
+
+    std::vector<StringPool::Id> ids(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t) {
+        threads.emplace_back([&ids, &pool, t] {
+            for (int i = 0; i < 1000; ++i) {
+                pool.intern(QStringLiteral("pool-test-%1").arg(i));
+            }
+            ids[t] = pool.intern(QStringLiteral("pool-test-shared"));
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const StringPool::Id id : ids) {
+        EXPECT_EQ(id, ids.front());
+    }
+    EXPECT_EQ(pool.string(ids.front()), QString("pool-test-shared"));
+    EXPECT_EQ(pool.find(QStringLiteral("pool-test-999")), pool.intern(QStringLiteral("pool-test-999")));
+}
+
+TEST(StringPoolTest, ItemsShareInternedFields) {
+    ResourceTemplate a;
+    ResourceTemplate b;
+    a.setCategory(QStringLiteral("shapes"));
+    b.setCategory(QString::fromLatin1("sha") + QStringLiteral("pes"));
+    a.setSource(QStringLiteral("vscode-snippet"));
+    b.setSource(QStringLiteral("legacy-converted"));
+
+    EXPECT_EQ(a.categoryId(), b.categoryId());
+    EXPECT_TRUE(a.category().isSharedWith(b.category()));
+    EXPECT_NE(a.sourceId(), b.sourceId());
+    EXPECT_EQ(ResourceTemplate(QStringLiteral("/t/x.json")).formatId(),
+              StringPool::instance().intern(QStringLiteral("text/scad.template")));
+}
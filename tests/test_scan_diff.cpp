@@ -0,0 +1,89 @@
+/**
+ * @file test_scan_diff.cpp
+ * @brief Unit tests for ScanDiff sorted-merge diffing
+ */
+
+#include <resourceInventory/scanDiff.hpp>
+#include <gtest/gtest.h>
+
+using namespace resourceInventory;
+
+namespace {
+
+ResourceItem makeItem(const QString& path, const QString& category = QString())
+{
+    ResourceItem item;
+    item.setPath(path);
+    item.setName(path.section('/', -1));
+    item.setCategory(category);
+    item.setType(ResourceType::Templates);
+    item.setTier(ResourceTier::User);
+    return item;
+}
+
+int countKind(const QList<ScanDiff::Change>& changes, ScanDiff::Change::Kind kind)
+{
+    int count = 0;
+    for (const auto& change : changes) {
+        count += change.kind == kind ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(ScanDiffTest, IdenticalListsHaveNoChanges) {
+    QList<ResourceItem> items{makeItem("/t/b.json"), makeItem("/t/a.json")};
+    ScanDiff::sortForDiff(items);
+
+    EXPECT_TRUE(ScanDiff::diff(items, items).isEmpty());
+}
+
+TEST(ScanDiffTest, DetectsAddedRemovedAndModified) {
+    QList<ResourceItem> before{makeItem("/t/a.json"), makeItem("/t/b.json", "old"), makeItem("/t/c.json")};
+    QList<ResourceItem> after{makeItem("/t/b.json", "new"), makeItem("/t/c.json"), makeItem("/t/d.json")};
+    ScanDiff::sortForDiff(before);
+    ScanDiff::sortForDiff(after);
+
+    const auto changes = ScanDiff::diff(before, after);
+    ASSERT_EQ(changes.size(), 3);
+    EXPECT_EQ(countKind(changes, ScanDiff::Change::Removed), 1);
+    EXPECT_EQ(countKind(changes, ScanDiff::Change::Added), 1);
+    EXPECT_EQ(countKind(changes, ScanDiff::Change::Modified), 1);
+
+    for (const auto& change : changes) {
+        switch (change.kind) {
+        case ScanDiff::Change::Removed:
+            EXPECT_EQ(before[change.oldIndex].path(), QString("/t/a.json"));
+            break;
+        case ScanDiff::Change::Added:
+            EXPECT_EQ(after[change.newIndex].path(), QString("/t/d.json"));
+            break;
+        case ScanDiff::Change::Modified:
+            EXPECT_EQ(before[change.oldIndex].category(), QString("old"));
+            EXPECT_EQ(after[change.newIndex].category(), QString("new"));
+            break;
+        }
+    }
+}
+
+TEST(ScanDiffTest, EmptyPreviousReportsEverythingAdded) {
+    QList<ResourceItem> after{makeItem("/t/a.json"), makeItem("/t/b.json")};
+    ScanDiff::sortForDiff(after);
+
+    const auto changes = ScanDiff::diff({}, after);
+    EXPECT_EQ(countKind(changes, ScanDiff::Change::Added), 2);
+}
+
+TEST(ScanDiffTest, GenericDiffUsesAccessors) {
+    struct Entry { QString path; int version; };
+    QList<Entry> before{{"/x", 1}, {"/y", 1}};
+    QList<Entry> after{{"/x", 2}, {"/y", 1}};
+    auto pathOf = [](const Entry& e) { return e.path; };
+    auto fingerprintOf = [](const Entry& e) { return quint64(e.version); };
+
+    const auto changes = ScanDiff::diff(before, after, pathOf, fingerprintOf);
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes[0].kind, ScanDiff::Change::Modified);
+    EXPECT_EQ(changes[0].oldIndex, 0);
+}
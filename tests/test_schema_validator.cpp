@@ -0,0 +1,90 @@
+/**
+ * @file test_schema_validator.cpp
+ * @brief Unit tests for JSON-schema validation of resource files
+ */
+
+#include <resourceScanning/schemaValidator.hpp>
+#include <gtest/gtest.h>
+
+#include "tempTree.hpp"
+
+using namespace platformInfo;
+using namespace resourceInventory;
+
+TEST(SchemaValidatorTest, DetectsSchemaByPathAndShape) {
+    EXPECT_EQ(SchemaValidator::schemaFor("/r/templates/a.json", R"({"key": "a", "content": "b"})"),
+              SchemaValidator::Schema::LegacyTemplate);
+    EXPECT_EQ(SchemaValidator::schemaFor("/r/templates/a.json", R"({"name": "Box"})"),
+              SchemaValidator::Schema::ScannerTemplate);
+    EXPECT_EQ(SchemaValidator::schemaFor("/r/templates/a.json", R"({"u": {"prefix": "u", "body": []}})"),
+              SchemaValidator::Schema::SnippetTemplate);
+    EXPECT_EQ(SchemaValidator::schemaFor("/r/color-schemes/render/a.json", "{}"),
+              SchemaValidator::Schema::ColorScheme);
+    EXPECT_EQ(SchemaValidator::schemaFor("/r/examples/example-dir.json", "{}"),
+              SchemaValidator::Schema::ExampleManifest);
+}
+
+TEST(SchemaValidatorTest, ValidFilesPass) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QStringList files = {
+        dir.write("templates/legacy.json", R"({"key": "cube", "content": "cube(1);\n^~^"})"),
+        dir.write("templates/union.json",
+                  R"({"union": {"_format": "vscode-snippet", "_version": 1, "prefix": "union", "body": ["union() {", "}"]}})"),
+        dir.write("templates/box.json", R"({"name": "Box", "category": "Shapes", "body": "cube();"})"),
+        dir.write("color-schemes/render/corn.json", R"({"name": "Cornfield", "index": 1000, "colors": {"background": "#ffffe5"}})"),
+        dir.write("examples/example-dir.json", R"({"sort": 1, "scripts": ["a.scad", {"file": "b.scad"}]})"),
+    };
+
+    const auto results = SchemaValidator::validateFiles(files, 2);
+    ASSERT_EQ(results.size(), size_t(files.size()));
+    for (const auto& result : results) {
+        EXPECT_TRUE(result.ok()) << (result.diagnostics.empty() ? "" : result.diagnostics[0].formatError());
+    }
+}
+
+TEST(SchemaValidatorTest, ViolationsHaveLineAndColumn) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write("templates/bad.json",
+                                   "{\n  \"union\": {\n    \"prefix\": \"union\",\n    \"body\": 42\n  }\n}\n");
+
+    const auto results = SchemaValidator::validateFiles({path});
+    ASSERT_EQ(results.size(), 1u);
+    ASSERT_FALSE(results[0].ok());
+    EXPECT_EQ(results[0].diagnostics[0].line, 4);
+    EXPECT_EQ(results[0].diagnostics[0].column, 13);
+}
+
+TEST(SchemaValidatorTest, SyntaxErrorsAreReportedOnce) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write("templates/broken.json", "{\n  \"name\": \"Box\",\n  \"body\": \n}\n");
+
+    const auto results = SchemaValidator::validateFiles({path});
+    ASSERT_EQ(results.size(), 1u);
+    ASSERT_EQ(results[0].diagnostics.size(), 1u);
+    EXPECT_EQ(results[0].diagnostics[0].line, 4);
+}
+
+TEST(SchemaValidatorTest, FindsResourceFilesOfALocation) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    dir.write("templates/a.json", "{}");
+    dir.write("color-schemes/editor/b.json", "{}");
+    dir.write("examples/Basics/example-dir.json", "{}");
+    dir.write("examples/Basics/logo.scad", "");
+
+    const ResourceLocation location(dir.root(), ResourceTier::User);
+    EXPECT_EQ(SchemaValidator::resourceFiles(location).size(), 3);
+}
+
+TEST(JsonPointerOffsetTest, LocatesNestedValues) {
+    const QByteArray json = R"({"a": {"b/c": [10, 20, {"d": true}]}})";
+    std::vector<JsonErrorInfo> out;
+    JsonDiagnostics diagnostics("x.json", json, out);
+    EXPECT_EQ(diagnostics.pointerOffset(""), 0);
+    EXPECT_EQ(diagnostics.pointerOffset("/a/b~1c/1"), json.indexOf("20"));
+    EXPECT_EQ(diagnostics.pointerOffset("/a/b~1c/2/d"), json.indexOf("true"));
+    EXPECT_EQ(diagnostics.pointerOffset("/missing"), -1);
+}
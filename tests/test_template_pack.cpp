@@ -0,0 +1,255 @@
+/**
+ * @file test_template_pack.cpp
+ * @brief Unit tests for compiled template packs (.stpack)
+ */
+
+#include <resourceInventory/templatePack.hpp>
+#include <resourceScanning/resourceScanner.hpp>
+#include <resourceScanning/templateScanner.hpp>
+#include <resourceScanning/templateContentCache.hpp>
+#include <platformInfo/ResourceLocation.hpp>
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include "tempTree.hpp"
+
+using namespace resourceInventory;
+
+namespace {
+
+ResourceTemplate makeTemplate(const QString& prefix, const QString& category, const QString& body)
+{
+    ResourceTemplate tmpl;
+    tmpl.setPrefix(prefix);
+    tmpl.setName(prefix);
+    tmpl.setCategory(category);
+    tmpl.setDescription(QStringLiteral("About ") + prefix);
+    tmpl.setBody(body);
+    tmpl.setScopes({QStringLiteral("source.scad")});
+    return tmpl;
+}
+
+// Content source that counts its loads
+class CountingSource : public TemplateContentSource {
+public:
+    std::shared_ptr<const TemplateContent> load() const override
+    {
+        ++loads;
+        auto content = std::make_shared<TemplateContent>();
+        content->body = QStringLiteral("cube(1);");
+        return content;
+    }
+    
+    bool isAvailable() const override { return available; }
+    
+    mutable int loads = 0;
+    bool available = true;
+};
+
+QList<ResourceTemplate> sampleTemplates()
+{
+    QList<ResourceTemplate> templates;
+    for (int i = 0; i < 50; ++i) {
+        templates.append(makeTemplate(QStringLiteral("t%1").arg(i), QStringLiteral("Shapes"),
+                                      QStringLiteral("cube(%1);\n$0").arg(i)));
+    }
+    templates.append(makeTemplate(QString::fromUtf8("w\xc3\xbcrfel"), QStringLiteral("Other"), QString()));
+    return templates;
+}
+
+} // namespace
+
+TEST(TemplatePackTest, RoundTripsAllFields) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path("set.stpack");
+    const QList<ResourceTemplate> templates = sampleTemplates();
+    ASSERT_TRUE(TemplatePack::write(path, templates));
+
+    TemplatePack pack;
+    ASSERT_TRUE(pack.open(path));
+    ASSERT_EQ(pack.count(), templates.size());
+    for (int i = 0; i < templates.size(); ++i) {
+        EXPECT_EQ(pack.prefix(i), templates[i].prefix());
+        EXPECT_EQ(pack.category(i), templates[i].category());
+        EXPECT_EQ(pack.description(i), templates[i].description());
+        EXPECT_EQ(pack.body(i), templates[i].body());
+        EXPECT_EQ(pack.scopes(i), templates[i].scopes());
+    }
+}
+
+TEST(TemplatePackTest, FindsByPrefix) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path("set.stpack");
+    ASSERT_TRUE(TemplatePack::write(path, sampleTemplates()));
+
+    TemplatePack pack;
+    ASSERT_TRUE(pack.open(path));
+    EXPECT_EQ(pack.find(QStringLiteral("t0")), 0);
+    EXPECT_EQ(pack.find(QStringLiteral("t37")), 37);
+    EXPECT_EQ(pack.find(QString::fromUtf8("w\xc3\xbcrfel")), 50);
+    EXPECT_EQ(pack.find(QStringLiteral("missing")), -1);
+
+    const ResourceTemplate tmpl = pack.templateAt(37);
+    EXPECT_EQ(tmpl.body(), QStringLiteral("cube(37);\n$0"));
+    EXPECT_EQ(tmpl.path(), TemplatePack::entryPath(path, QStringLiteral("t37")));
+}
+
+TEST(TemplatePackTest, EmptyPackIsValid) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path("empty.stpack");
+    ASSERT_TRUE(TemplatePack::write(path, {}));
+
+    TemplatePack pack;
+    ASSERT_TRUE(pack.open(path));
+    EXPECT_EQ(pack.count(), 0);
+    EXPECT_EQ(pack.find(QStringLiteral("t0")), -1);
+}
+
+TEST(TemplatePackTest, RejectsCorruptFiles) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path("set.stpack");
+    ASSERT_TRUE(TemplatePack::write(path, sampleTemplates()));
+
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() - 8);
+    file.close();
+
+    TemplatePack pack;
+    QString error;
+    EXPECT_FALSE(pack.open(path, &error));
+    EXPECT_FALSE(error.isEmpty());
+    EXPECT_FALSE(pack.isOpen());
+}
+
+TEST(TemplatePackTest, RejectsDuplicatePrefixes) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    QList<ResourceTemplate> templates = sampleTemplates();
+    templates.append(makeTemplate(QStringLiteral("t3"), QStringLiteral("Other"), QStringLiteral("sphere();")));
+
+    QString error;
+    EXPECT_FALSE(TemplatePack::write(dir.path("dup.stpack"), templates, &error));
+    EXPECT_TRUE(error.contains(QStringLiteral("t3")));
+    EXPECT_FALSE(QFile::exists(dir.path("dup.stpack")));
+}
+
+TEST(TemplatePackTest, SplitsEntryPaths) {
+    QString packPath;
+    QString prefix;
+    ASSERT_TRUE(TemplatePack::splitEntryPath(QStringLiteral("/a/set.stpack#for#each"), packPath, prefix));
+    EXPECT_EQ(packPath, QStringLiteral("/a/set.stpack"));
+    EXPECT_EQ(prefix, QStringLiteral("for#each"));
+    EXPECT_FALSE(TemplatePack::splitEntryPath(QStringLiteral("/a/b.json"), packPath, prefix));
+}
+
+TEST(TemplatePackTest, ScannerListsPackEntriesAndLoadsBodies) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(dir.mkdir("templates"));
+    ASSERT_TRUE(TemplatePack::write(dir.path("templates/set.stpack"), sampleTemplates()));
+
+    const platformInfo::ResourceLocation location(dir.root(), ResourceTier::User);
+    QList<ResourceTemplate> templates = TemplateScanner::scanLocation(location);
+    ASSERT_EQ(templates.size(), 51);
+    EXPECT_EQ(templates[3].name(), QStringLiteral("t3"));
+    EXPECT_EQ(templates[3].category(), QStringLiteral("Shapes"));
+    EXPECT_TRUE(templates[3].isLazy());
+
+    // Materialized from the pack on access
+    EXPECT_EQ(templates[3].body(), QStringLiteral("cube(3);\n$0"));
+    EXPECT_EQ(templates[3].scopes(), QStringList{QStringLiteral("source.scad")});
+
+    ASSERT_TRUE(TemplateScanner::loadContent(templates[3]));
+    EXPECT_FALSE(templates[3].isLazy());
+    EXPECT_EQ(templates[3].body(), QStringLiteral("cube(3);\n$0"));
+    EXPECT_EQ(templates[3].description(), QStringLiteral("About t3"));
+}
+
+TEST(TemplatePackTest, LazyContentIsCachedAndCopiedOnWrite) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("templates/box.json", R"({"name": "Box", "body": "cube(2);"})").isEmpty());
+
+    const platformInfo::ResourceLocation location(dir.root(), ResourceTier::User);
+    const QList<ResourceTemplate> templates = TemplateScanner::scanLocation(location);
+    ASSERT_EQ(templates.size(), 1);
+    ASSERT_TRUE(templates[0].isLazy());
+
+    TemplateContentCache& cache = TemplateContentCache::instance();
+    EXPECT_EQ(templates[0].body(), QStringLiteral("cube(2);"));
+    const qint64 hits = cache.hits();
+    EXPECT_EQ(templates[0].body(), QStringLiteral("cube(2);"));
+    EXPECT_EQ(cache.hits(), hits + 1);
+
+    ResourceTemplate edited = templates[0];
+    edited.setBody(QStringLiteral("sphere();"));
+    EXPECT_FALSE(edited.isLazy());
+    EXPECT_EQ(edited.body(), QStringLiteral("sphere();"));
+    EXPECT_EQ(templates[0].body(), QStringLiteral("cube(2);"));
+}
+
+TEST(TemplatePackTest, LazyContentFollowsEditsAndRemoval) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("templates/box.json", R"({"name": "Box", "body": "cube(2);"})").isEmpty());
+
+    const platformInfo::ResourceLocation location(dir.root(), ResourceTier::User);
+    const QList<ResourceTemplate> templates = TemplateScanner::scanLocation(location);
+    ASSERT_EQ(templates.size(), 1);
+
+    // Edited after listing: the current body, never an empty one
+    ASSERT_FALSE(dir.write("templates/box.json", R"({"name": "Box", "body": "cube(20);"})").isEmpty());
+    EXPECT_EQ(templates[0].body(), QStringLiteral("cube(20);"));
+    EXPECT_FALSE(templates[0].isStale());
+    EXPECT_TRUE(templates[0].isValid());
+
+    // Removed after listing: stale, and refused when saving
+    ASSERT_TRUE(QFile::remove(dir.path("templates/box.json")));
+    EXPECT_TRUE(templates[0].isStale());
+    EXPECT_FALSE(templates[0].isValid());
+}
+
+TEST(TemplatePackTest, ValidityOfLazyTemplateIsCheckedWithoutLoading) {
+    auto source = std::make_shared<CountingSource>();
+    ResourceTemplate tmpl(QStringLiteral("/t/box.json"));
+    tmpl.setType(ResourceType::Templates);
+    tmpl.setPrefix(QStringLiteral("box"));
+    tmpl.setContentSource(source);
+
+    EXPECT_TRUE(tmpl.isValid());
+    source->available = false;
+    EXPECT_FALSE(tmpl.isValid());
+    EXPECT_EQ(source->loads, 0);
+}
+
+TEST(TemplatePackTest, ResourceScannerListsPackEntries) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_FALSE(dir.write("templates/box.json", R"({"name": "Box", "body": "cube(2);"})").isEmpty());
+    const QString packPath = dir.path("templates/set.stpack");
+    ASSERT_TRUE(TemplatePack::write(packPath, sampleTemplates()));
+
+    ResourceScanner scanner;
+    QList<ResourceItem> items;
+    scanner.scanLocations({platformInfo::ResourceLocation(dir.root(), ResourceTier::User)},
+                          [&items](const ResourceItem& item) { items.append(item); });
+
+    // The plain file first, then every pack entry
+    ASSERT_EQ(items.size(), 1 + sampleTemplates().size());
+    EXPECT_EQ(items[0].name(), QStringLiteral("box"));
+    const ResourceItem& entry = items[1];
+    EXPECT_EQ(entry.path(), TemplatePack::entryPath(packPath, QStringLiteral("t0")));
+    EXPECT_EQ(entry.name(), QStringLiteral("t0"));
+    EXPECT_EQ(entry.category(), QStringLiteral("Shapes"));
+    EXPECT_EQ(entry.description(), QStringLiteral("About t0"));
+    EXPECT_EQ(entry.type(), ResourceType::Templates);
+    EXPECT_EQ(entry.access(), ResourceAccess::ReadOnly);
+    EXPECT_EQ(entry.sourcePath(), QFileInfo(packPath).absoluteFilePath());
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_template_reload.cpp
+ * @brief Unit tests for TemplateManager::reloadFromFile()
+ */
+
+#include <scadtemplates/template_manager.hpp>
+#include <scadtemplates/template_parser.hpp>
+#include <gtest/gtest.h>
+
+#include <QJsonDocument>
+
+#include "tempTree.hpp"
+
+TEST(TemplateReloadTest, DecodesOnlyChangedEntries) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path(QStringLiteral("snippets.json"));
+    const auto writeFile = [&dir](const QByteArray& content) {
+        ASSERT_FALSE(dir.write(QStringLiteral("snippets.json"), content).isEmpty());
+    };
+    writeFile(R"({"_format": "vscode-snippet",
+        "a": {"prefix": "a", "body": "one"},
+        "b": {"prefix": "b", "body": "two"},
+        "c": {"prefix": "c", "body": "three"}})");
+
+    scadtemplates::TemplateManager manager;
+    scadtemplates::ReloadResult result = manager.reloadFromFile(path);
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.added, (QStringList{"a", "b", "c"}));
+    EXPECT_EQ(result.unchanged, 0);
+
+    // Same bytes for "a", although the entry moved within the file
+    writeFile(R"({"_format": "vscode-snippet",
+        "d": {"prefix": "d", "body": "four"},
+        "a": {"prefix": "a", "body": "one"},
+        "b": {"prefix": "b", "body": ["two", "lines"]}})");
+    scadtemplates::TemplateParser parser;
+    QStringList decoded;
+    const scadtemplates::StreamParseResult parsed = parser.parseEntries(path,
+        [](const scadtemplates::TemplateEntry& entry) { return entry.name != QStringLiteral("a"); },
+        [&decoded](const scadtemplates::TemplateEntry& entry, ResourceTemplate* tmpl) {
+            EXPECT_GT(entry.length, 0);
+            if (tmpl) decoded.append(tmpl->prefix());
+            return true;
+        });
+    ASSERT_TRUE(parsed.success);
+    EXPECT_EQ(parsed.count, 3);
+    EXPECT_EQ(decoded, (QStringList{"d", "b"}));
+
+    result = manager.reloadFromFile(path);
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(result.added, QStringList{"d"});
+    EXPECT_EQ(result.changed, QStringList{"b"});
+    EXPECT_EQ(result.removed, QStringList{"c"});
+    EXPECT_EQ(result.unchanged, 1);
+
+    const QList<ResourceTemplate> all = manager.getAllTemplates();
+    ASSERT_EQ(all.size(), 3);
+    EXPECT_EQ(all[0].prefix(), QString("a"));
+    EXPECT_EQ(all[1].body(), QString("two\nlines"));
+    EXPECT_EQ(all[2].prefix(), QString("d"));
+
+    // A template removed by hand comes back even though its entry is unchanged
+    EXPECT_TRUE(manager.removeTemplate(QStringLiteral("a")));
+    result = manager.reloadFromFile(path);
+    EXPECT_EQ(result.added, QStringList{"a"});
+    EXPECT_EQ(result.unchanged, 2);
+}
+
+TEST(TemplateReloadTest, SyntaxErrorChangesNothing) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write(QStringLiteral("snippets.json"), R"({
+        "a": {"prefix": "a", "body": "one"},
+        "b": {"prefix": "b", "body": "two"}})");
+    ASSERT_FALSE(path.isEmpty());
+
+    scadtemplates::TemplateManager manager;
+    ASSERT_TRUE(manager.reloadFromFile(path).success);
+
+    // "a" parsed before the error, but the file is not applied in part
+    ASSERT_FALSE(dir.write(QStringLiteral("snippets.json"), R"({
+        "a": {"prefix": "a", "body": "changed"}, "b": {)").isEmpty());
+    scadtemplates::ReloadResult result = manager.reloadFromFile(path);
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.changed.isEmpty());
+    EXPECT_TRUE(result.removed.isEmpty());
+    EXPECT_EQ(manager.count(), 2u);
+    EXPECT_EQ(manager.findByPrefix(QStringLiteral("a"))->body(), QString("one"));
+
+    // Once the file is whole again, it is compared with the last good load
+    ASSERT_FALSE(dir.write(QStringLiteral("snippets.json"), R"({
+        "a": {"prefix": "a", "body": "changed"}})").isEmpty());
+    result = manager.reloadFromFile(path);
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.changed, QStringList{"a"});
+    EXPECT_EQ(result.removed, QStringList{"b"});
+    EXPECT_EQ(manager.count(), 1u);
+}
+
+TEST(TemplateReloadTest, LoadAddsNothingFromBrokenFile) {
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write(QStringLiteral("snippets.json"), R"({"_format": "vscode-snippet",
+        "a": {"prefix": "a", "body": "one"},
+        "b": {"prefix": "b", "body": )");
+    ASSERT_FALSE(path.isEmpty());
+
+    scadtemplates::TemplateManager manager;
+    EXPECT_FALSE(manager.loadFromFile(path));
+    EXPECT_EQ(manager.count(), 0u);
+}
+
+TEST(TemplateReloadTest, StringBodiesParseOnBothPaths) {
+    const QByteArray content = R"({"_format": "vscode-snippet",
+        "a": {"prefix": "a", "body": "single line"},
+        "b": {"prefix": "b", "body": ["two", "lines"]}})";
+
+    scadtemplates::TemplateParser parser;
+    const scadtemplates::ParseResult dom = parser.parseDocument(QJsonDocument::fromJson(content));
+    ASSERT_TRUE(dom.success);
+    ASSERT_EQ(dom.templates.size(), 2);
+    EXPECT_EQ(dom.templates[0].body(), QString("single line"));
+    EXPECT_EQ(dom.templates[1].body(), QString("two\nlines"));
+
+    testSupport::TempTree dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.write(QStringLiteral("snippets.json"), content);
+    ASSERT_FALSE(path.isEmpty());
+    scadtemplates::TemplateManager manager;
+    ASSERT_TRUE(manager.loadFromFile(path));
+    EXPECT_EQ(manager.findByPrefix(QStringLiteral("a"))->body(), QString("single line"));
+    EXPECT_EQ(manager.findByPrefix(QStringLiteral("b"))->body(), QString("two\nlines"));
+}
@@ -1,8 +1,9 @@
 /**
- * @file test_templatescanner.cpp
+ * @file test_template_scanner.cpp
  * @brief Unit tests for TemplateScanner (Phase 2B.1)
  * 
- * Tests template discovery, JSON validation, and metadata extraction.
+ * Tests template discovery, JSON validation, metadata extraction, and the
+ * multi-location scan pipeline.
  */
 
 #include <gtest/gtest.h>
@@ -12,13 +13,17 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
-#include "resourceDiscovery/templateScanner.hpp"
+#include "resourceScanning/templateScanner.hpp"
+#include "resourceScanning/parsedTemplateCache.hpp"
 #include "platformInfo/ResourceLocation.hpp"
 #include "resourceInventory/resourceItem.hpp"
 
+#include "tempTree.hpp"
+
 using resourceInventory::ResourceTemplate;
 using resourceInventory::ResourceTier;
 using resourceInventory::ResourceAccess;
+using resourceInventory::ParsedTemplateCache;
 
 // Helper: Create a test template JSON file
 void createTemplateFile(const QString& path, const QString& name, 
@@ -251,18 +256,17 @@ TEST_F(TemplateScannerTest, AccessBasedOnLocationWriteability) {
     createTemplateFile(templatesDir + "/test.json", "Test Template");
     
     platformInfo::ResourceLocation readOnlyLoc(tempDir.path(), ResourceTier::Installation);
-    readOnlyLoc.setWritable(false);
     auto roTemplates = TemplateScanner::scanLocation(readOnlyLoc);
     
     ASSERT_EQ(roTemplates.size(), 1);
     EXPECT_EQ(roTemplates[0].access(), ResourceAccess::ReadOnly);
     
+    // Locations carry no writeability; the scanner lists every template read-only
     platformInfo::ResourceLocation writableLoc(tempDir.path(), ResourceTier::User);
-    writableLoc.setWritable(true);
     auto rwTemplates = TemplateScanner::scanLocation(writableLoc);
     
     ASSERT_EQ(rwTemplates.size(), 1);
-    EXPECT_EQ(rwTemplates[0].access(), ResourceAccess::Writable);
+    EXPECT_EQ(rwTemplates[0].access(), ResourceAccess::ReadOnly);
 }
 
 // Integration Tests
@@ -284,11 +288,8 @@ TEST_F(TemplateScannerTest, MultipleLocationsAreCombined) {
     EXPECT_EQ(allTemplates.size(), 2);
 }
 
-TEST_F(TemplateScannerTest, DisabledLocationIsSkipped) {
-    createTemplateFile(templatesDir + "/test.json", "Test Template");
-    
-    platformInfo::ResourceLocation loc(tempDir.path(), ResourceTier::User);
-    loc.setEnabled(false);
+TEST_F(TemplateScannerTest, NonExistentLocationIsSkipped) {
+    platformInfo::ResourceLocation loc("/nonexistent/path", ResourceTier::User);
     
     QList<platformInfo::ResourceLocation> locations = {loc};
     auto templates = TemplateScanner::scanLocations(locations);
@@ -296,14 +297,23 @@ TEST_F(TemplateScannerTest, DisabledLocationIsSkipped) {
     EXPECT_TRUE(templates.isEmpty());
 }
 
-TEST_F(TemplateScannerTest, NonExistentLocationIsSkipped) {
-    platformInfo::ResourceLocation loc("/nonexistent/path", ResourceTier::User);
-    loc.setExists(false);
+// Lazy Content Tests
+
+TEST_F(TemplateScannerTest, BodyIsParsedOnFirstAccess) {
+    createTemplateFile(templatesDir + "/full.json", 
+                      "Full Template",
+                      "Primitives",
+                      "cube([10, 10, 10]);");
     
-    QList<platformInfo::ResourceLocation> locations = {loc};
-    auto templates = TemplateScanner::scanLocations(locations);
+    platformInfo::ResourceLocation loc(tempDir.path(), ResourceTier::User);
+    auto templates = TemplateScanner::scanLocation(loc);
     
-    EXPECT_TRUE(templates.isEmpty());
+    ASSERT_EQ(templates.size(), 1);
+    EXPECT_TRUE(templates[0].isLazy());
+    EXPECT_EQ(templates[0].body(), "cube([10, 10, 10]);");
+    ResourceTemplate opened = templates[0];
+    ASSERT_TRUE(TemplateScanner::loadContent(opened));
+    EXPECT_EQ(opened.body(), "cube([10, 10, 10]);");
 }
 
 // Static Helper Tests
@@ -320,3 +330,92 @@ TEST_F(TemplateScannerTest, TemplateSubfolderReturnsTemplates) {
     
     EXPECT_EQ(subfolder, "templates");
 }
+
+// Scan Pipeline
+
+namespace {
+
+QByteArray templateJson(const QString& name)
+{
+    return QStringLiteral(R"({"name": "%1", "category": "Shapes", "body": "cube(1);"})").arg(name).toUtf8();
+}
+
+// Two locations with 40 templates each, and one broken file
+class TemplateScanTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_first.isValid());
+        ASSERT_TRUE(m_second.isValid());
+        for (int i = 0; i < 40; ++i) {
+            ASSERT_FALSE(m_first.write(QStringLiteral("templates/a%1.json").arg(i),
+                                       templateJson(QStringLiteral("A %1").arg(i))).isEmpty());
+            ASSERT_FALSE(m_second.write(QStringLiteral("templates/b%1.json").arg(i),
+                                        templateJson(QStringLiteral("B %1").arg(i))).isEmpty());
+        }
+        ASSERT_FALSE(m_first.write("templates/broken.json", "{ not json").isEmpty());
+        m_locations = {platformInfo::ResourceLocation(m_first.root(), ResourceTier::Installation),
+                       platformInfo::ResourceLocation(m_second.root(), ResourceTier::User)};
+    }
+
+    // Per-location scans, one after the other
+    QList<ResourceTemplate> serialScan() const
+    {
+        QList<ResourceTemplate> templates;
+        for (const auto& location : m_locations) {
+            templates += TemplateScanner::scanLocation(location);
+        }
+        return templates;
+    }
+
+    static void expectSameTemplates(const QList<ResourceTemplate>& actual,
+                                    const QList<ResourceTemplate>& expected)
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (int i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(actual[i].path(), expected[i].path());
+            EXPECT_EQ(actual[i].name(), expected[i].name());
+            EXPECT_EQ(actual[i].tier(), expected[i].tier());
+        }
+    }
+
+    testSupport::TempTree m_first;
+    testSupport::TempTree m_second;
+    QList<platformInfo::ResourceLocation> m_locations;
+};
+
+} // namespace
+
+TEST_F(TemplateScanTest, PipelineKeepsPerLocationOrder) {
+    ParsedTemplateCache::instance().clear();
+    const QList<ResourceTemplate> templates = TemplateScanner::scanLocations(m_locations, 4, 2);
+    ASSERT_EQ(templates.size(), 80);
+    expectSameTemplates(templates, serialScan());
+}
+
+TEST_F(TemplateScanTest, SingleReaderAndParserStillDrainTheQueue) {
+    ParsedTemplateCache::instance().clear();
+    expectSameTemplates(TemplateScanner::scanLocations(m_locations, 1, 1), serialScan());
+}
+
+TEST_F(TemplateScanTest, CachedListingsAreNotReadAgain) {
+    ParsedTemplateCache& cache = ParsedTemplateCache::instance();
+    cache.clear();
+    const QList<ResourceTemplate> first = TemplateScanner::scanLocations(m_locations);
+    const qint64 misses = cache.misses();
+
+    const QList<ResourceTemplate> second = TemplateScanner::scanLocations(m_locations);
+    EXPECT_EQ(cache.misses(), misses);
+    expectSameTemplates(second, first);
+
+    // An edited file is read again
+    ASSERT_FALSE(m_second.write("templates/b7.json", templateJson("Renamed")).isEmpty());
+    const QList<ResourceTemplate> edited = TemplateScanner::scanLocations(m_locations);
+    EXPECT_EQ(cache.misses(), misses + 1);
+    ASSERT_EQ(edited.size(), first.size());
+    bool renamed = false;
+    for (const ResourceTemplate& tmpl : edited) {
+        renamed = renamed || tmpl.name() == QStringLiteral("Renamed");
+    }
+    EXPECT_TRUE(renamed);
+}